@@ -8,10 +8,26 @@
 
 #import <UIKit/UIKit.h>
 #import "ChatSDKCallbacks.h"
+#import "ChatSDKSession.h"
+#import "ChatSDKRequestScheduler.h"
 
 
 @class ChatSDKCallbacks;
 
+// Returns the data sent back to the chat app for a native action registered by the application
+typedef NSDictionary *(^ChatSDKNativeActionHandler)(id data);
+typedef void (^ChatSDKNativeAsyncActionHandler)(id data, void (^completion)(NSDictionary *result));
+
+// How the location sent to the chat app is tracked
+typedef enum {
+    // Location updates throttled by locationDistanceFilter & locationMinimumInterval
+    ChatSDKLocationTrackingContinuous,
+    // Significant location changes only (cell towers, about 500 meters), no GPS
+    ChatSDKLocationTrackingSignificantChange,
+    // No tracking, one fix is taken when the chat app calls getlocation
+    ChatSDKLocationTrackingOnDemand
+}ChatSDKLocationTrackingMode;
+
 @interface ChatSDK : NSObject
 {
     ChatSDKCallbacks *chatSDKCallbacks;
@@ -26,6 +42,149 @@
  */
 @property (assign) BOOL allowLocationAccess;
 
+/*
+ locationTrackingMode : How the location is tracked while chat is loaded, see ChatSDKLocationTrackingMode.
+ While chat is minimized or the app is in background accuracy is stepped down to about a kilometer.
+ Changes apply to the next chat.
+ Default value : ChatSDKLocationTrackingContinuous
+ */
+@property (nonatomic, assign) ChatSDKLocationTrackingMode locationTrackingMode;
+
+/*
+ locationDesiredAccuracy : Accuracy in meters asked for by continuous & on demand tracking.
+ Default value : 10 (kCLLocationAccuracyNearestTenMeters)
+ */
+@property (nonatomic, assign) double locationDesiredAccuracy;
+
+/*
+ locationDistanceFilter : Meters the device must move before a new location is sent to the chat app.
+ Default value : 5
+ */
+@property (nonatomic, assign) double locationDistanceFilter;
+
+/*
+ locationMinimumInterval : Least seconds between two locations sent to the chat app, the latest location of
+ the interval is sent at its end. 0 sends every update.
+ Default value : 0
+ */
+@property (nonatomic, assign) NSTimeInterval locationMinimumInterval;
+
+/*
+ availabilityCacheTTL : Seconds for which the answer of checkAgentAvailability is reused for the same
+ queueId without a new request. A stale answer is still delivered at once and refreshed in background,
+ onChatAgentAvailability is called again if the refreshed answer differs. 0 disables the cache.
+ Default value : 30
+ */
+@property (nonatomic, assign) NSTimeInterval availabilityCacheTTL;
+
+/*
+ availabilityRequestTimeout : Seconds after which one availability request to one CA server URL is given up.
+ If the queue has an alternate URL (the per-queue URL from the config XML and the one built from
+ chatsdk_agentavailability_url), a failed or timed out request fails over to the other one.
+ Default value : 10
+ */
+@property (nonatomic, assign) NSTimeInterval availabilityRequestTimeout;
+
+/*
+ availabilityHedgingEnabled : When the first CA server URL has not answered within availabilityHedgePercentile
+ of its recent latencies, a second request is sent to the alternate URL. The first answer wins and the
+ other request is cancelled. The URL with the lower median latency is always tried first.
+ Default value : False
+ */
+@property (nonatomic, assign) BOOL availabilityHedgingEnabled;
+
+/*
+ availabilityHedgePercentile : Latency percentile (0.0 - 1.0) of the first URL used as hedge deadline.
+ Default value : 0.95
+ */
+@property (nonatomic, assign) double availabilityHedgePercentile;
+
+/*
+ prewarmOnAvailability : When checkAgentAvailability or an availability subscription reports agents
+ available, the chat of that queue is preloaded (see preloadChat) so startChat shows it at once.
+ Default value : False
+ */
+@property (nonatomic, assign) BOOL prewarmOnAvailability;
+
+/*
+ prewarmTimeout : Seconds a preloaded chat is kept when startChat is not called. 0 keeps it until
+ memory warning or background.
+ Default value : 120
+ */
+@property (nonatomic, assign) NSTimeInterval prewarmTimeout;
+
+/*
+ prewarmMemoryBudget : Resident memory of the app in bytes above which preloadChat does nothing.
+ 0 means no limit.
+ Default value : 0
+ */
+@property (nonatomic, assign) unsigned long long prewarmMemoryBudget;
+
+/*
+ enginePoolSize : Idle chat views kept ready with their web engine started, so that the next chat
+ (e.g. a second session of openSessionForQueue) does not start the engine cold. They are refilled after
+ a chat came into view and released on memory warning or when the app goes to background. 0 keeps none.
+ Default value : 1
+ */
+@property (nonatomic, assign) NSUInteger enginePoolSize;
+
+/*
+ keepsTranscripts : The messages of each queue's chat are kept on the device, so that a chat reopened after
+ endChat, a failed load or a relaunch shows its history at once (the chat app reads it with gettranscript).
+ Turning it off deletes the kept transcripts.
+ Default value : True
+ */
+@property (nonatomic, assign) BOOL keepsTranscripts;
+
+/*
+ transcriptMaximumAge : Seconds a transcript message is kept. 0 keeps it until transcriptMaximumSize is reached.
+ Default value : 86400
+ */
+@property (nonatomic, assign) NSTimeInterval transcriptMaximumAge;
+
+/*
+ transcriptMaximumSize : Bytes of transcript messages kept over all queues, the oldest go first. 0 means no limit.
+ Default value : 262144
+ */
+@property (nonatomic, assign) unsigned long long transcriptMaximumSize;
+
+/*
+ hibernationDelay : Seconds a chat stays minimized before its chat view is released to save memory. The
+ minimize button stays, its badge is kept up to date by handleAgentMessageNotification and maximizing loads
+ the chat again. Minimized chats also hibernate on memory warning. 0 only hibernates on memory warning.
+ The chat app is told with the "hibernate" application status and releases its view by calling the
+ hibernateready bridge action once it saved its state, or after 2 seconds.
+ Default value : 300
+ */
+@property (nonatomic, assign) NSTimeInterval hibernationDelay;
+
+/*
+ delegateQueue : Queue the delegate of chatSDKCallbacks is called on, e.g. a serial queue of the application. Sessions
+ with callbacks of their own set it on them.
+ Default value : main queue
+ */
+@property (nonatomic, strong) dispatch_queue_t delegateQueue;
+
+/*
+ agentMessageCoalescingInterval : Seconds within which a burst of agent messages is delivered by one onAgentMessage:count:
+ with the number of messages & the latest data, the badge of the minimize button is redrawn as often. 0 delivers every
+ message. Set it before startChat, the badge of a running chat keeps its interval.
+ Default value : 0
+ */
+@property (nonatomic, assign) NSTimeInterval agentMessageCoalescingInterval;
+
+/*
+ sessions : ChatSDKSession of every running chat, the one of startChat included.
+ */
+@property (nonatomic, readonly) NSArray *sessions;
+
+/*
+ configurationErrors : NSErrors of ChatSDKConfigurationErrorDomain found in chatsdkdefaults.plist & chatsdkconfig.plist
+ when they were last read, empty when the configuration is valid. ChatSDKConfigurationKeyErrorKey of their userInfo
+ names the offending value.
+ */
+@property (nonatomic, readonly) NSArray *configurationErrors;
+
 
 // Shared instance of ChatSDK class
 +(ChatSDK *)getSDKInstance;
@@ -43,12 +202,23 @@
  */
 -(void)setChatDelegate:(id)listener;
 
+/*
+ * notifyWhenConfigReady        The CheckAvailability config XML is loaded in background during
+                                initializeChat, the last good copy is served from disk meanwhile.
+                                This method calls the handler on the main queue once that config
+                                is available, or right away if it already is.
+ * @param handler(in)           Block to be called when the config is ready
+ */
+-(void)notifyWhenConfigReady:(void (^)(void))handler;
+
 /*
  * checkAgentAvailability       This method registers the object passed as the argument as the
                                 listener of the Chat SDK events created by the [24]7 Native Chat
                                 SDK.The object passed in is an instance of a class,
                                 which conforms to ChatSDKDelegate that contains abstract functions
                                 for the notifications.
+                                Calls made while the same queueId is already being checked join
+                                that request, and answers are cached for availabilityCacheTTL.
  * @param listener(in)          An object that conforms to ChatSDKDelegate
  
  * @param queueId(in)       NSString containing queueId that will be used to check agent availability from multiple agent queue.
@@ -58,6 +228,35 @@
 */
 -(void)checkAgentAvailability :(NSString*)queueId;
 
+/*
+ * checkAgentAvailabilityForQueues  This method checks agent availability of several queues with one
+                                call. The checks run in parallel (answers cached for
+                                availabilityCacheTTL are reused) and the result is delivered once
+                                through onChatAgentAvailabilityForQueues. If some queue could not be
+                                checked, onChatError is called as well and that queue is left out
+                                of the result. Entries that are not a non empty NSString are skipped,
+                                the result only has the queues asked for.
+ * @param queueIds(in)          NSArray of NSString queueIds, e.g. queue1,queue2,queue3
+ */
+-(void)checkAgentAvailabilityForQueues:(NSArray *)queueIds;
+
+/*
+ * subscribeToAvailabilityForQueue  Use this instead of calling checkAgentAvailability on a timer. The
+                                SDK keeps one long-poll request per queue open against the CA server
+                                and calls onChatAgentAvailability (or onChatAgentAvailability:forQueue:
+                                when implemented) with the first answer and then only when the
+                                availability changes. Requests are paused while the application is in
+                                background and resumed when it comes to foreground.
+ * @param queueId(in)           NSString containing queueId to watch
+ */
+-(void)subscribeToAvailabilityForQueue:(NSString *)queueId;
+
+/*
+ * unsubscribeFromAvailabilityForQueue  Stops watching the queue subscribed with subscribeToAvailabilityForQueue.
+ * @param queueId(in)           NSString containing queueId
+ */
+-(void)unsubscribeFromAvailabilityForQueue:(NSString *)queueId;
+
 /*
  * startChat                    This method is used to load the chat view in the application. Any 
                                 pre-chat related context information that is passed as a dictionary
@@ -80,6 +279,143 @@
 */
 -(void)startChat:(NSDictionary*)contextInfo andQueue:(NSString*)queueId;
 
+/*
+ * preloadChat                  Loads the chat view and the chat app hidden, so that a later startChat
+                                with the same queueId only has to show it. The preloaded chat is released
+                                after prewarmTimeout, on memory warning or when the app goes to background,
+                                and is not created while the app is over prewarmMemoryBudget. A startChat
+                                for another queueId releases it and loads the chat as usual.
+ * @param contextInfo(in)       NSDictionary of pre-chat context information, replaced by the one passed
+                                to startChat when that is not nil
+ * @param queueId(in)           NSString containing queueId
+ */
+-(void)preloadChat:(NSDictionary*)contextInfo andQueue:(NSString*)queueId;
+
+/*
+ * prewarmForQueue              preloadChat without context information.
+ * @param queueId(in)           NSString containing queueId
+ */
+-(void)prewarmForQueue:(NSString*)queueId;
+
+/*
+ * openSessionForQueue          Opens a chat of queueId with its own chat view, minimize button and callbacks,
+                                next to the chat of startChat and the other sessions, e.g. a sales and a
+                                support chat. When a chat of queueId is open already, it is brought into view.
+                                A chat view of the engine pool is used when there is one.
+ * @param queueId(in)           NSString containing queueId
+ * @param contextInfo(in)       NSDictionary of pre-chat context information of this chat
+ * @return                      The ChatSDKSession, nil when the configuration Plist is not valid (onChatError
+                                is notified)
+ */
+-(ChatSDKSession *)openSessionForQueue:(NSString *)queueId contextInfo:(NSDictionary *)contextInfo;
+
+/*
+ * registerNativeAction         Lets the application answer a chat_exec action of its own chat app. handler
+                                gets the "data" sent by the chat app and returns the data sent back. Actions
+                                of the SDK (minimizechat, endchat, getcontext ...) can not be replaced.
+ * @param action(in)            NSString containing the action name, case insensitive
+ * @param handler(in)           Block called on the bridge thread
+ * @return                      NO when action is an action of the SDK
+ */
+-(BOOL)registerNativeAction:(NSString *)action handler:(ChatSDKNativeActionHandler)handler;
+
+/*
+ * registerNativeAction         Like registerNativeAction:handler: for an answer that is not known at once,
+                                e.g. after user input. The chat app gets the result when completion is called.
+ * @param action(in)            NSString containing the action name, case insensitive
+ * @param handler(in)           Block called on the bridge thread, completion may be called on any thread
+ * @return                      NO when action is an action of the SDK
+ */
+-(BOOL)registerNativeAction:(NSString *)action asyncHandler:(ChatSDKNativeAsyncActionHandler)handler;
+
+/*
+ * scheduleNetworkRequest       Runs a request of the application, e.g. one sent for a native action of the chat
+                                app, together with the requests of the SDK: it is kept while the network is not
+                                reachable, sent when it comes back and tried again with backoff when done is
+                                called with ChatSDKRequestRetry. See requestMetrics.
+ * @param request(in)           Block called on the main thread for each attempt, it must call done once
+ * @param key(in)               NSString, a request scheduled with the key of a waiting one is dropped. May be nil
+ */
+-(void)scheduleNetworkRequest:(ChatSDKScheduledRequest)request withKey:(NSString *)key;
+
+/*
+ * unregisterNativeAction       Removes an action registered by the application.
+ * @param action(in)            NSString containing the action name
+ */
+-(void)unregisterNativeAction:(NSString *)action;
+
+/*
+ * bridgeMetrics                Calls, errors, payload sizes & p50/p95/p99 latencies (ms) of each chat_exec
+                                action since the last resetBridgeMetrics, e.g. to send to an analytics service.
+                                Native time is spent in the handler (until completion for async actions), bridge
+                                time from the call reaching the SDK until the answer is handed to the chat view,
+                                without the time spent in JS.
+ * @return                      NSDictionary {"since", "actions" : {<action> : {"count", "errors",
+                                "requestBytes", "responseBytes", "nativeTime", "bridgeTime"}}}
+ */
+-(NSDictionary *)bridgeMetrics;
+
+/*
+ * resetBridgeMetrics           Clears the numbers returned by bridgeMetrics.
+ */
+-(void)resetBridgeMetrics;
+
+/*
+ * animationMetrics             Frames & dropped frames of the maximize ("chat.show", "button.hide") and minimize
+                                ("chat.hide", "button.show") animations since the last resetAnimationMetrics.
+ * @return                      NSDictionary {"since", "animations" : {<animation> : {"count", "frames",
+                                "droppedFrames", "longestFrame", "frameTime" : {"p50", "p95", "p99"}}}}, in ms
+ */
+-(NSDictionary *)animationMetrics;
+
+/*
+ * resetAnimationMetrics        Clears the numbers returned by animationMetrics.
+ */
+-(void)resetAnimationMetrics;
+
+/*
+ * requestMetrics               Requests of the SDK (availability checks, config refreshes, chat load retries) & of
+                                scheduleNetworkRequest since the last resetRequestMetrics.
+ * @return                      NSDictionary {"since", "queueDepth" (requests kept while offline or waiting for a
+                                retry), "running", "scheduled", "succeeded", "failed", "retries", "coalesced",
+                                "dropped", "cancelled", "flushes" (times the network came back)}
+ */
+-(NSDictionary *)requestMetrics;
+
+/*
+ * resetRequestMetrics          Clears the counts returned by requestMetrics.
+ */
+-(void)resetRequestMetrics;
+
+/*
+ * clearTranscripts             Deletes the transcripts kept on the device, e.g. when the user logs out.
+ */
+-(void)clearTranscripts;
+
+/*
+ * handleAgentMessageNotification  Passes an agent message received outside the chat view, e.g. by remote
+                                notification, to the chat it belongs to. A hibernated chat counts it on its
+                                badge, keeps it in its transcript & calls onAgentMessage, a loaded chat gets it
+                                from its own connection and ignores it.
+ * @param userInfo(in)          userInfo of the notification, the SDK reads its key 'chatsdk_agentmessage' :
+                                {"queueId", "data"}. Without queueId it goes to the chat of startChat.
+ * @return                      YES when a hibernated chat took the message
+ */
+-(BOOL)handleAgentMessageNotification:(NSDictionary *)userInfo;
+
+/*
+ * reloadConfiguration          Reads chatsdkdefaults.plist & chatsdkconfig.plist of the main bundle again. They are
+                                otherwise parsed once per process. Layout values apply on the next layout, the chat
+                                URL & checkAvailability URLs on the next chat.
+ * @param error(out)            May be NULL. Set to the first error of configurationErrors when the new
+                                configuration is not valid
+ * @return                      NO when the new configuration is not valid, configurationErrors has the reasons
+ */
+-(BOOL)reloadConfiguration:(NSError **)error;
+
+// Same as reloadConfiguration: with a NULL error
+-(BOOL)reloadConfiguration;
+
 /*
  * maximizeChat                 This is an optional method that is used only in the case when the
                                 application has overridden the minimize functionality provided by 
@@ -8,17 +8,24 @@
 
 #import "ChatSDK.h"
 #import "ChatSDKBridgeAction.h"
-#import "ChatSDKJSBridge.h"
+#import "ChatSDKBridgeActionRegistry.h"
+#import "ChatSDKAssetCache.h"
+#import "ChatSDKTranscriptStore.h"
+#import "ChatSDKBridgeMetrics.h"
+#import "ChatSDKAnimationMetrics.h"
+#import "ChatSDKSessionManager.h"
 #import <dispatch/dispatch.h>
 #import "ChatSDKError.h"
 #import "ChatSDKConstants.h"
-#import "ChatSDKResources.h"
-#import "ChatSDKWebView.h"
-#import "ChatSDKMaximizeButton.h"
+#import "ChatSDKConfiguration.h"
 #import "ChatSDKAlertViewBlock.h"
 #import "ChatSDKLocation.h"
-#import "ChatSDKCAServerDetailParsing.h"
+#import "ChatSDKCAServerConfig.h"
+#import "ChatSDKAvailabilityChecker.h"
+#import "ChatSDKAvailabilitySubscriber.h"
+#import "ChatSDKRequestScheduler.h"
 #import "Reachability.h"
+#import <mach/mach.h>
 
 #if __IPHONE_OS_VERSION_MAX_ALLOWED >= 70000     
     // App compiled with iOS7 or later
@@ -31,6 +38,17 @@
 static UIWindow *chatWindow = nil;
 static ChatSDK *sharedInstance = nil;
 
+//Resident memory of the app in bytes, 0 when it can not be read
+unsigned long long ChatSDKResidentMemory(void)
+{
+    struct mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) != KERN_SUCCESS) {
+        return 0;
+    }
+    return info.resident_size;
+}
+
 typedef enum {
     ChatSDKStartError,
     ChatSDKAnimationError,
@@ -41,77 +59,131 @@ typedef enum {
     ChatSDKInvalidParameterError
 }ChatSDKErrorCode;
 
-@interface ChatSDK ()<UIWebViewDelegate,ChatSDKJSBridgeDelegate,ChatSDKLocationDelegate>
+@interface ChatSDK ()<ChatSDKSessionOwner,ChatSDKLocationDelegate>
 {
     // Add new instance variable
     dispatch_queue_t backgroundQueue;
-    ChatSDKWebView *chatWebview;
-    ChatSDKMaximizeButton *chatButton;
-    NSDictionary *contextInfoDict;
     UIActivityIndicatorView *indicatorView;
     ChatSDKError *sdkError;
-    UIDeviceOrientation orientation;
-    // Boolean variable to have check on first load
-    BOOL firstTimeFlag;
-    // Array which holds position
-    ChatSDKResources *chatSDKResources;
     Reachability *internetReachable;
-    ChatSDKJSBridge *cache;
-    NSURLCache *globalCache;
+    // Chat app assets kept on disk, nil without chatsdk_asset_manifest_url
+    ChatSDKAssetCache *assetCache;
+    // What the chat apps showed, read back by gettranscript, nil while keepsTranscripts is off
+    ChatSDKTranscriptStore *transcriptStore;
     
-    NSString *chatSDKqueueId;
     ChatSDKLocation *chatSDKLocation;
-    ChatSDKCAServerDetailParsing *chatSDKCAServerDetailParsing;
+    ChatSDKCAServerConfig *caServerConfig;
+    ChatSDKAvailabilityChecker *availabilityChecker;
+    ChatSDKAvailabilitySubscriber *availabilitySubscriber;
+    // Availability checks, config refreshes & chat load retries, kept while the network is not reachable
+    ChatSDKRequestScheduler *requestScheduler;
+    
+    // Open chats & the pool of warm web views
+    ChatSDKSessionManager *sessionManager;
+    // Session of startChat, preloadChat, maximizeChat, minimizeChat & endChat
+    ChatSDKSession *defaultSession;
+    // Numbers the chatsdk_session of the sessions opened by openSessionForQueue:contextInfo:
+    NSUInteger sessionCount;
+    
+    // Actions of every session, bound ones are registered by ChatSDKSession
+    ChatSDKBridgeActionRegistry *bridgeActions;
+    // Action names the application can not register
+    NSSet *builtInBridgeActions;
+    
+    // location accuracy is reduced while no chat is in view or the app is in background
+    BOOL inBackground;
 }
 
 @property (nonatomic,strong) ChatSDKLocation *chatSDKLocation;
-@property (nonatomic,strong) ChatSDKMaximizeButton *chatButton;
-@property (nonatomic,strong) NSDictionary *contextInfoDict;
 @property (nonatomic,strong) UIActivityIndicatorView *indicatorView;
-@property (nonatomic,assign) BOOL firstTimeFlag;
-
 
-@property (nonatomic,strong) NSString *chatSDKqueueId;
 // Defining Methods
 -(NSInteger)getErrorCode:(NSInteger )errorCode;
 -(NSString *)getErrorMessage:(NSInteger )errorCode;
--(ChatSDKMaximizeButton *)createChatButton;
+-(ChatSDKConfiguration *)configuration;
+-(void)createAssetCache;
 
 @end
 
 @implementation ChatSDK
 
 @synthesize chatSDKCallbacks;
-@synthesize chatButton = _chatButton;
-@synthesize contextInfoDict = _contextInfoDict;
 @synthesize indicatorView = _indicatorView;
-@synthesize firstTimeFlag = _firstTimeFlag;
-@synthesize chatSDKqueueId=_chatSDKqueueId;
 @synthesize allowLocationAccess=_allowLocationAccess;
 @synthesize chatSDKLocation=_chatSDKLocation;
+@synthesize locationTrackingMode=_locationTrackingMode;
+@synthesize locationDesiredAccuracy=_locationDesiredAccuracy;
+@synthesize locationDistanceFilter=_locationDistanceFilter;
+@synthesize locationMinimumInterval=_locationMinimumInterval;
+@synthesize prewarmOnAvailability=_prewarmOnAvailability;
+@synthesize prewarmTimeout=_prewarmTimeout;
+@synthesize prewarmMemoryBudget=_prewarmMemoryBudget;
+@synthesize keepsTranscripts=_keepsTranscripts;
+@synthesize hibernationDelay=_hibernationDelay;
 
 - (id)init
 {
     if (self = [super init])
     {
         chatSDKCallbacks = [[ChatSDKCallbacks alloc] init];
-        chatSDKResources = [[ChatSDKResources alloc] init];
         
         
         //By default allow sdk to access location.
         self.allowLocationAccess=YES;
+        _locationTrackingMode=ChatSDKLocationTrackingContinuous;
+        _locationDesiredAccuracy=kCLLocationAccuracyNearestTenMeters;
+        _locationDistanceFilter=5;
+        
+        //A preloaded chat nobody starts is released after 2 minutes
+        _prewarmTimeout=120;
+        
+        //A chat left minimized for 5 minutes gives its chat view back
+        _hibernationDelay=300;
         
         //register notification for background and foreground
         [self registerNotificationForApplicationState];
         
-        [chatSDKResources initializeValues];
+        //Serve the chat app assets from the last downloaded version while checking for a new one
+        [self createAssetCache];
+        
+        //Chats render their history from disk while they reconnect
+        _keepsTranscripts=YES;
+        transcriptStore = [[ChatSDKTranscriptStore alloc] initWithPath:[ChatSDKTranscriptStore defaultPath]];
         
         sdkError = [[ChatSDKError alloc] init];
         
+        [self registerBridgeActions];
+        
+        sessionManager = [[ChatSDKSessionManager alloc] init];
+        
         backgroundQueue = dispatch_queue_create("com.inc247.dispatchQueue", NULL);
+        
+        requestScheduler = [[ChatSDKRequestScheduler alloc] init];
+        requestScheduler.reachable = [self isReachableToInternet];
+        
+        availabilityChecker = [[ChatSDKAvailabilityChecker alloc] init];
+        __weak ChatSDK *weakSelf = self;
+        availabilityChecker.changeHandler = ^(NSString *queueId, BOOL available) {
+            // A revalidated answer differs from the cached one we delivered earlier, the delegate is told which queue changed
+            [weakSelf.chatSDKCallbacks onChatAgentAvailabilityDelegateHandler:available forQueue:queueId];
+        };
+        
+        availabilitySubscriber = [[ChatSDKAvailabilitySubscriber alloc] initWithURLProvider:^NSArray *(NSString *queueId) {
+            return [weakSelf availabilityURLsForQueue:queueId];
+        }];
+        availabilitySubscriber.updateHandler = ^(NSString *queueId, BOOL available) {
+            ChatSDK *strongSelf = weakSelf;
+            if (strongSelf == nil) {
+                return;
+            }
+            // Subscription answers keep checkAgentAvailability's cache warm too
+            [strongSelf->availabilityChecker storeAvailability:available forQueue:queueId];
+            [strongSelf.chatSDKCallbacks onChatAgentAvailabilityDelegateHandler:available forQueue:queueId];
+            [strongSelf prewarmIfAvailable:available forQueue:queueId];
+        };
 
         //live
-        //parse checkAvailabilitty from server.
+        //load checkAvailabilitty from the cached snapshot and revalidate it in background.
         [self getMultipleCAServerURL];
 
         [self startNetworkCheck];
@@ -140,7 +212,8 @@ typedef enum {
         
         [internetReachable startNotifier];
         
-        if (![self isReachableToInternet])
+        requestScheduler.reachable = [self isReachableToInternet];
+        if (!requestScheduler.reachable)
         {
             UIAlertView *alert = [[UIAlertView alloc] initWithTitle:@"" message:@"Check internet connection , Internet is not available" delegate:nil cancelButtonTitle:@"Ok" otherButtonTitles:nil, nil];
             
@@ -182,10 +255,20 @@ typedef enum {
     
     
     NetworkStatus1 internetStatus = [internetReachable currentReachabilityStatus];
+    
+    //Requests kept while offline are sent when the network comes back
+    requestScheduler.reachable = internetStatus != NotReachable1;
+    if(requestScheduler.reachable && !inBackground)
+    {
+        [availabilitySubscriber resume];
+    }
+    
     switch (internetStatus)
     {
         case NotReachable1:
         {
+            //long-polls would only fail until the network is back
+            [availabilitySubscriber pause];
             
             UIAlertView *alert = [[UIAlertView alloc] initWithTitle:@"" message:@"Check internet connection , Internet is not available" delegate:nil cancelButtonTitle:@"Ok" otherButtonTitles:nil, nil];
             
@@ -206,14 +289,61 @@ typedef enum {
     }
 }
 
+/********************************************************************************
+ ** Function Name       : getMultipleCAServerURL
+ ** Description         : Loads the queueId -> checkAvailability URL map. The last good
+                          map is served from disk at once and the config XML is
+                          revalidated in background, so init never waits on the network.
+ ** Input Parameters    : nil
+ ** Output Parameters   : None
+ ** Return Values       : void
+ *******************************************************************************/
 -(void)getMultipleCAServerURL
 {
-    NSString *url=chatSDKResources.chatsdkConfigUrl;
-    
     //local url
     //url=@"http://localhost/livechatsdk/check_availability.xml"
-    chatSDKCAServerDetailParsing=[[ChatSDKCAServerDetailParsing alloc] initWithContentsOfURL:[NSURL URLWithString:url]];
-    NSLog(@"chatSDKCAServerDetailParsing >> %@",chatSDKCAServerDetailParsing.caXmlResponse);
+    caServerConfig=[[ChatSDKCAServerConfig alloc] initWithURL:[self configuration].configURL];
+    __weak ChatSDK *weakSelf=self;
+    [caServerConfig loadWithCompletion:^(BOOL reachedServer) {
+        if(!reachedServer)
+        {
+            [weakSelf scheduleConfigRefresh];
+        }
+    }];
+}
+
+//Revalidates the config XML once the network is back, the snapshot or the plist URLs serve meanwhile
+-(void)scheduleConfigRefresh
+{
+    __weak ChatSDKCAServerConfig *config=caServerConfig;
+    [requestScheduler scheduleRequest:^(NSUInteger attempt, BOOL lastAttempt, ChatSDKRequestDone done) {
+        if(config==nil)
+        {
+            done(ChatSDKRequestFailed);
+            return;
+        }
+        [config revalidateWithCompletion:^(BOOL reachedServer) {
+            done(reachedServer ? ChatSDKRequestSucceeded : ChatSDKRequestRetry);
+        }];
+    } withKey:@"config"];
+}
+
+/********************************************************************************
+ ** Function Name       : notifyWhenConfigReady
+ ** Description         : Calls handler on main queue once the CheckAvailability config
+                          has been restored from disk or fetched from server
+ ** Input Parameters    : handler
+ ** Output Parameters   : None
+ ** Return Values       : void
+ *******************************************************************************/
+-(void)notifyWhenConfigReady:(void (^)(void))handler
+{
+    if (handler == nil) {
+        return;
+    }
+    [caServerConfig whenReady:^(NSDictionary *queueURLs) {
+        handler();
+    }];
 }
 +(ChatSDK *)getSDKInstance
 {
@@ -267,520 +397,595 @@ typedef enum {
  *******************************************************************************/
 -(void)checkAgentAvailability :(NSString*) queueId;
 {
-    if(_indicatorView!=nil)
-    {
-        UIAlertView *alert = [[UIAlertView alloc] initWithTitle:@"247ChatSDK" message:@"Process allready Running" delegate:self cancelButtonTitle:@"Cancel" otherButtonTitles: nil];
-        [alert show];
-    }
-    else
+    //https://api-pe-assist.px.247-inc.com/en/ca/rest/checkAvailability?queueId=lnd-queue-customer-support&accountId=lnd-account-1
+    BOOL cached=[availabilityChecker cachedAvailabilityForQueue:queueId available:NULL];
+    
+    // Starting the indicator view only when the answer is not cached already & the request is not kept for the network
+    UIActivityIndicatorView *availabilityIndicator=nil;
+    if(!cached && requestScheduler.reachable && _indicatorView==nil)
     {
-        // Starting the indicator view initially
         _indicatorView = [[UIActivityIndicatorView alloc] initWithActivityIndicatorStyle:UIActivityIndicatorViewStyleGray];
         _indicatorView.center = chatWindow.center;
         [chatWindow addSubview:_indicatorView];
         [_indicatorView startAnimating];
-        
-        //https://api-pe-assist.px.247-inc.com/en/ca/rest/checkAvailability?queueId=lnd-queue-customer-support&accountId=lnd-account-1
-        
-        NSDictionary *caAgentUrl=[NSDictionary dictionaryWithDictionary:chatSDKCAServerDetailParsing.caXmlResponse];
-        
-        NSString *agentAvailabilityURL=[caAgentUrl objectForKey:queueId];
-        
-        //If we don't have any agentQueueURL of the given queueId the we have to use chatSDKResources value (url,queueId,accountId) to create url of checkAgentAvailability.
-        if (!agentAvailabilityURL) {
-            agentAvailabilityURL = [NSString stringWithFormat:@"%@?queueId=%@&accountId=%@",chatSDKResources.chatAgentavailabilityURL,chatSDKResources.chatsdkQueueId,chatSDKResources.chatsdkAccountId];
-        }
-        
-        //NSString *agentAvailabilityURL = [NSString stringWithFormat:@"%@?queueId=%@&accountId=%@",chatSDKResources.chatAgentavailabilityURL,chatSDKResources.chatsdkQueueId,chatSDKResources.chatsdkAccountId];
-        
-        dispatch_async(backgroundQueue, ^(void) {
-            NSError* error = nil;
-            NSData* data;
-            
-            
-            /* fetching list of SBC from webserver */
-            data = [NSData dataWithContentsOfURL:[NSURL URLWithString:agentAvailabilityURL] options:0 error:&error];
-            /* If list fetched then parse the JSON data for list of SBC */
-            if (!error) {
-                NSDictionary* json = [NSJSONSerialization JSONObjectWithData:data
-                                                                     options:kNilOptions
-                                                                       error:&error];
-                
-                NSDictionary* dataDictionary = [json objectForKey:@"data"];
-                NSString *agentStatus = [dataDictionary objectForKey:@"caStatus"];
-                dispatch_async(dispatch_get_main_queue(), ^(void) {
-                    // CALLING DELEGATE FUNCTION WHICH WILL NOTIFY APPLICATION ABOUT AGENT AVAILABILITY
-                    [chatSDKCallbacks onChatAgentAvailabilityDelegateHandler:[agentStatus boolValue]];
-                    if(_indicatorView!=nil)
-                    {
-                        [_indicatorView stopAnimating];
-                        [_indicatorView removeFromSuperview];
-                        _indicatorView = nil;
-                    }
-                });
-                
-            }
-            else
+        availabilityIndicator=_indicatorView;
+    }
+    
+    ChatSDKScheduledRequest request=^(NSUInteger attempt, BOOL lastAttempt, ChatSDKRequestDone done) {
+        // Callers of a queue that is being checked already join the running request
+        [availabilityChecker checkAvailabilityForQueue:queueId URLs:[self availabilityURLsForQueue:queueId] completion:^(BOOL available, NSError *error) {
+            if(error && !lastAttempt && [ChatSDKRequestScheduler isConnectivityError:error])
             {
-                dispatch_async(dispatch_get_main_queue(), ^(void) {
-                    // Fetching Error Code
-                    ChatSDKErrorCode  errorCode = ChatSDKNetworkError;
-                    sdkError.code = [self getErrorCode:errorCode];
-                    sdkError.message = [self getErrorMessage:errorCode];
-                    if(_indicatorView!=nil)
-                    {
-                        [_indicatorView stopAnimating];
-                        [_indicatorView removeFromSuperview];
-                        _indicatorView=nil;
-                    }
-                    // CALLING DELEGATE FUNCTION WHICH WILL NOTIFY APPLICATION ABOUT ONCHATERROR
-                    [chatSDKCallbacks onChatErrorDelegateHandler:sdkError];
-                    
-                });
-                
+                done(ChatSDKRequestRetry);
+                return;
             }
-            
-        });
+            done(error ? ChatSDKRequestFailed : ChatSDKRequestSucceeded);
+            [self didCheckAgentAvailability:available error:error forQueue:queueId indicator:availabilityIndicator];
+        }];
+    };
+    
+    // A cached answer does not need the network
+    if(cached)
+    {
+        request(1, YES, ^(ChatSDKRequestResult result) {});
+    }
+    else
+    {
+        [requestScheduler scheduleRequest:request withKey:[NSString stringWithFormat:@"availability|%@", queueId]];
     }
 }
 
-
-/********************************************************************************
- ** Function Name       : startChat
- ** Description         : This method is used to load the chat view in the 
-                          application
- ** Input Parameters    : contextInfo -- Dictionary containing any application
-                                         specific pre-chat related context information
-                          queueId -- String contain queueId passed by appdeveloper
-                                     Will be send to agent consol while then envoke getQueueId function.
- ** Output Parameters   : None
- ** Return Values       : void
- *******************************************************************************/
--(void)startChat:(NSDictionary*)contextInfo andQueue:(NSString*) queueId;
+-(void)didCheckAgentAvailability:(BOOL)available error:(NSError *)error forQueue:(NSString *)queueId indicator:(UIActivityIndicatorView *)availabilityIndicator
 {
-    if (![self isReachableToInternet])
+    if(availabilityIndicator!=nil && _indicatorView==availabilityIndicator)
     {
-        UIAlertView *alert = [[UIAlertView alloc] initWithTitle:@"" message:@"Check internet connection , Internet is not available" delegate:nil cancelButtonTitle:@"Ok" otherButtonTitles:nil, nil];
-        
-        [alert show];
+        [_indicatorView stopAnimating];
+        [_indicatorView removeFromSuperview];
+        _indicatorView = nil;
     }
-
-    if([chatSDKResources isXMLValid])
+    
+    if (!error) {
+        // CALLING DELEGATE FUNCTION WHICH WILL NOTIFY APPLICATION ABOUT AGENT AVAILABILITY
+        [chatSDKCallbacks onChatAgentAvailabilityDelegateHandler:available];
+        [self prewarmIfAvailable:available forQueue:queueId];
+    }
+    else
     {
-        if(!chatWebview)
-        {
-            //Saving default cache to globalCache for restoring it at chat minimized & end chat
-            globalCache = [NSURLCache sharedURLCache];
-            
-            //Create an instance of our custom NSURLCache object to use to check any outgoing requests in our app
-            cache = [[ChatSDKJSBridge alloc] init];
-            
-            //Setting cache to JSBridge cache
-            [NSURLCache setSharedURLCache:nil];
-            [NSURLCache setSharedURLCache:cache];
-            
-            //Saving the contextInfo globally
-            _contextInfoDict = contextInfo;
-            
-            //saving queue id globally
-            _chatSDKqueueId=queueId;
-            
-            
-            // Check the device
-            chatWebview = [[ChatSDKWebView alloc] init];
-            
-            //[[chatWebview scrollView] setBounces: NO];
-           // chatWebview.scalesPageToFit = YES;
-           // chatWebview.contentMode = UIViewContentModeScaleAspectFit;
-            //chatWebview.autoresizingMask = (UIViewAutoresizingFlexibleHeight | UIViewAutoresizingFlexibleWidth);
-            if (UI_USER_INTERFACE_IDIOM() == UIUserInterfaceIdiomPad)
-            {
-                if([[[UIDevice currentDevice] systemVersion] floatValue] >=7.0f && COMPILED_WITH_VER>=7)
-                {
-                    //Default resizing
-                    [chatWebview resetWebViewForIpadWithFrame];
-                }else{
-                    [chatWebview resetWebViewForIpad];
-                }
-            }
-            else
-            {
-                if([[[UIDevice currentDevice] systemVersion] floatValue] >=7.0f && COMPILED_WITH_VER>=7)
-                {
-                    [chatWebview resetWebViewWithFrame];
-                }else{
-                    [chatWebview resetWebView];
-                }
-            }
-            
-            //Making maximize button
-            if(!_chatButton)
-            {
-                _chatButton = [self createChatButton];
-            }
-            [_chatButton rotateButton];
-            [chatWindow addSubview:_chatButton];
-            _chatButton.hidden=YES;
-            
-            // Setting ChatSDKJSBridgeDelegate to self
-            [NSURLCache setChatSDKJSBridgeDelegate:self];
-            [chatWebview setDelegate:self];
-            
-            NSURL *websiteUrl = [NSURL URLWithString:chatSDKResources.chatsdkURL];
-            NSURLRequest *urlRequest = [NSURLRequest requestWithURL:websiteUrl];
-            [chatWebview loadRequest:urlRequest];
-            //[chatWindow addSubview:chatWebview];
-            
-            // Starting the indicator view initially
-            _indicatorView = [[UIActivityIndicatorView alloc] initWithActivityIndicatorStyle:UIActivityIndicatorViewStyleGray];
-            _indicatorView.center = chatWindow.center;
-            [chatWindow addSubview:_indicatorView];
-            [_indicatorView startAnimating];
-        }
-        else
-        {
-            // Calling maximizeChat()
-            [self maximizeChat];
-        }        
-    }else{
-        
         // Fetching Error Code
-        ChatSDKErrorCode  errorCode = ChatSDKInvalidParameterError;
+        ChatSDKErrorCode  errorCode = ChatSDKNetworkError;
         sdkError.code = [self getErrorCode:errorCode];
         sdkError.message = [self getErrorMessage:errorCode];
         // CALLING DELEGATE FUNCTION WHICH WILL NOTIFY APPLICATION ABOUT ONCHATERROR
-        dispatch_async(dispatch_get_main_queue(), ^(void) {
-            [chatSDKCallbacks onChatErrorDelegateHandler:sdkError];
-        });
+        [chatSDKCallbacks onChatErrorDelegateHandler:sdkError];
     }
 }
 
 /********************************************************************************
- ** Function Name       : maximizeChat
- ** Description         : This method is optional, used to bring back the chat into view
-                          if chat has been minimized by user action or by the application
- ** Input Parameters    : None
+ ** Function Name       : checkAgentAvailabilityForQueues
+ ** Description         : Check agent availability of several queues at once, the
+                          requests run in parallel over one keep-alive session
+ ** Input Parameters    : queueIds -- Array of queueId strings, other entries are skipped
  ** Output Parameters   : None
  ** Return Values       : void
  *******************************************************************************/
--(void)maximizeChat
+-(void)checkAgentAvailabilityForQueues:(NSArray *)queueIds
 {
-    //Setting cache to JSBridge cache
-    [NSURLCache setSharedURLCache:nil];
-    [NSURLCache setSharedURLCache:cache];
-    
-    [_chatButton hideWithAnimation];
-    chatWebview.hidden = NO;    
-    [chatWindow bringSubviewToFront:chatWebview];
-    
-    //TODO
-    if (UI_USER_INTERFACE_IDIOM() == UIUserInterfaceIdiomPad)
+    //Only non empty queueId strings are checked, each one against URLs of its own, so the result has no other queue
+    NSMutableDictionary *queueURLs=[[NSMutableDictionary alloc] init];
+    for (id queueId in queueIds)
     {
-        // And adding the animation on webview as per the animation style from plist.
-        // Calling a local function which will remove the chatwebview with animation.
-        //[self addChatWebviewWithAnimation:chatSDKResources.animationStyle and:TRUE];
-        if([[[UIDevice currentDevice] systemVersion] floatValue] >=7.0f && COMPILED_WITH_VER>=7)
+        if (![queueId isKindOfClass:[NSString class]] || [queueId length]==0)
         {
-            //Default resizing
-            [chatWebview resetWebViewForIpadWithFrame];
-        }else{
-            [chatWebview resetWebViewForIpad];
+            continue;
         }
+        [queueURLs setObject:[self availabilityURLsForQueue:queueId] forKey:queueId];
     }
-    else
-    {
-        //Added// ResetWebView
-        if([[[UIDevice currentDevice] systemVersion] floatValue] >=7.0f && COMPILED_WITH_VER>=7)
+    
+    NSArray *checkedQueueIds=[[queueURLs allKeys] sortedArrayUsingSelector:@selector(compare:)];
+    [requestScheduler scheduleRequest:^(NSUInteger attempt, BOOL lastAttempt, ChatSDKRequestDone done) {
+        [self checkAvailabilityForQueues:queueURLs lastAttempt:lastAttempt done:done];
+    } withKey:[NSString stringWithFormat:@"availabilities|%@", [checkedQueueIds componentsJoinedByString:@","]]];
+}
+
+-(void)checkAvailabilityForQueues:(NSDictionary *)queueURLs lastAttempt:(BOOL)lastAttempt done:(ChatSDKRequestDone)done
+{
+    [availabilityChecker checkAvailabilityForQueues:queueURLs completion:^(NSDictionary *availability, NSError *error) {
+        // The queues that answered are cached, the next attempt only asks the others
+        if(error && !lastAttempt && [ChatSDKRequestScheduler isConnectivityError:error])
         {
-            [chatWebview resetWebViewWithFrame];
-        }else{
-            [chatWebview resetWebView];
+            done(ChatSDKRequestRetry);
+            return;
         }
-    }
-    [chatWebview showWithAnimation];
-    dispatch_async(dispatch_get_main_queue(), ^(void) {        
-        //Resetting badge count
-        [_chatButton resetBadge];
-        
-        // Creating a blank NSDictionary.
-        NSDictionary *tempDict = [[NSDictionary alloc] init];
-        // CALLING DELEGATE FUNCTION WHICH WILL NOTIFY APPLICATION ABOUT MAXIMIZECHAT
-        [chatSDKCallbacks onChatMaximizedDelegateHandler:tempDict];
-    });
-
-    //send minimize notification to JS Bridge
-    [self updateApplicationStatus:@"maximize"];
+        done(error ? ChatSDKRequestFailed : ChatSDKRequestSucceeded);
+        if (error)
+        {
+            // Fetching Error Code
+            ChatSDKErrorCode  errorCode = ChatSDKNetworkError;
+            sdkError.code = [self getErrorCode:errorCode];
+            sdkError.message = [self getErrorMessage:errorCode];
+            // CALLING DELEGATE FUNCTION WHICH WILL NOTIFY APPLICATION ABOUT ONCHATERROR
+            [chatSDKCallbacks onChatErrorDelegateHandler:sdkError];
+        }
+        // CALLING DELEGATE FUNCTION WHICH WILL NOTIFY APPLICATION ABOUT AGENT AVAILABILITY OF ALL QUEUES
+        [chatSDKCallbacks onChatAgentAvailabilityForQueuesDelegateHandler:availability];
+    }];
 }
 
 /********************************************************************************
- ** Function Name       : minimizeChat
- ** Description         : This is an optional method that could be used by the 
-                          application to minimize the chat view.
- ** Input Parameters    : None
+ ** Function Name       : subscribeToAvailabilityForQueue
+ ** Description         : Keeps a long-poll request open for queueId and notifies the
+                          delegate only when agent availability changes
+ ** Input Parameters    : queueId
  ** Output Parameters   : None
  ** Return Values       : void
  *******************************************************************************/
--(void)minimizeChat
+-(void)subscribeToAvailabilityForQueue:(NSString *)queueId
 {
-    //send minimize notification to JS Bridge
-    [self updateApplicationStatus:@"minimize"];
-    
-    //Add chatbutton on screen and hide chatsdkwebview
-    [chatWebview hideWithAnimation];
-    _chatButton.hidden=NO;
-    [_chatButton showWithAnimation];
-    [_chatButton checkRotation];
-    [chatWindow bringSubviewToFront:_chatButton];
-    
-    dispatch_async(dispatch_get_main_queue(), ^(void) {
-        // Creating a blank NSDictionary.
-        NSDictionary *tempDict = [[NSDictionary alloc] init];
-        // CALLING DELEGATE FUNCTION WHICH WILL NOTIFY APPLICATION ABOUT MINIMIZECHAT
-        [chatSDKCallbacks onChatMinimizedDelegateHandler:tempDict];
-    });
-       
-    //Setting default cache
-    [NSURLCache setSharedURLCache:nil];
-    [NSURLCache setSharedURLCache:globalCache];
-    
+    [availabilitySubscriber subscribeToQueue:queueId];
 }
 
 /********************************************************************************
- ** Function Name       : endChat
- ** Description         : This is an optional method that could be called to 
-                          programmatically end chat session and close the chat view.
- ** Input Parameters    : None
+ ** Function Name       : unsubscribeFromAvailabilityForQueue
+ ** Description         : Stops the availability subscription of queueId
+ ** Input Parameters    : queueId
  ** Output Parameters   : None
  ** Return Values       : void
  *******************************************************************************/
--(void)endChat
+-(void)unsubscribeFromAvailabilityForQueue:(NSString *)queueId
 {
-    // Assigning flag to FALSE.
-    _firstTimeFlag = FALSE;
-    
-    if (UI_USER_INTERFACE_IDIOM() == UIUserInterfaceIdiomPad)
-    {
-        // And adding the animation on webview as per the animation style from plist.
-        // Calling a local function which will remove the chatwebview with animation.
-        //[self removeChatWebviewWithAnimation:chatSDKResources.animationStyle and:FALSE];
-    }
-    else
-    {
+    [availabilitySubscriber unsubscribeFromQueue:queueId];
+}
 
-    }
-    
-    // Check whether the chatWebview is present or not
-    if(chatWebview!=nil)
-    {
-        [chatWebview removeFromSuperview];
-        chatWebview = nil;
-    }
-    // Remove maximizeButton from superView
-    if(_chatButton!=nil)
-    {
-        [_chatButton removeFromSuperview];
-        _chatButton = nil;
-    }
-    
-    
-    //stop location tracking on chat close.
-    [_chatSDKLocation stopTracking];
-    _chatSDKLocation=nil;
+//checkAvailability URLs of queueId, the one from config XML first and the one made from chatsdkconfig.plist as alternate.
+//Every URL answers for queueId, so that failover & hedging never report another queue's availability
+-(NSArray *)availabilityURLsForQueue:(NSString *)queueId
+{
+    NSDictionary *caAgentUrl=caServerConfig.queueURLs;
     
+    NSString *queueAvailabilityURL=queueId ? [caAgentUrl objectForKey:queueId] : nil;
     
-    dispatch_async(dispatch_get_main_queue(), ^(void) {
-        // Creating a blank NSDictionary.
-        NSDictionary *tempDict = [[NSDictionary alloc] init];
-        // CALLING DELEGATE FUNCTION WHICH WILL NOTIFY APPLICATION ABOUT ENDCHAT
-        [chatSDKCallbacks onChatEndedDelegateHandler:tempDict];
-    });
+    //If we don't have any agentQueueURL of the given queueId the we have to use chatsdkconfig.plist values (url,accountId) to create url of checkAgentAvailability,
+    //with the queueId of chatsdkconfig.plist only when no queueId is given
+    NSString *fallbackQueueId = queueId ? queueId : [self configuration].queueId;
+    NSString *fallbackAvailabilityURL = [NSString stringWithFormat:@"%@?queueId=%@&accountId=%@",[self configuration].agentAvailabilityURL,[fallbackQueueId stringByAddingPercentEscapesUsingEncoding:NSUTF8StringEncoding],[self configuration].accountId];
     
-    //Setting default cache
-    [NSURLCache setSharedURLCache:nil];
-    [NSURLCache setSharedURLCache:globalCache];
+    if ([queueAvailabilityURL length]==0 || [queueAvailabilityURL isEqualToString:fallbackAvailabilityURL]) {
+        return [NSArray arrayWithObject:fallbackAvailabilityURL];
+    }
+    return [NSArray arrayWithObjects:queueAvailabilityURL,fallbackAvailabilityURL, nil];
+}
+
+-(void)setAvailabilityCacheTTL:(NSTimeInterval)availabilityCacheTTL
+{
+    availabilityChecker.cacheTTL=availabilityCacheTTL;
+}
+
+-(NSTimeInterval)availabilityCacheTTL
+{
+    return availabilityChecker.cacheTTL;
+}
+
+-(void)setAvailabilityRequestTimeout:(NSTimeInterval)availabilityRequestTimeout
+{
+    availabilityChecker.requestTimeout=availabilityRequestTimeout;
+}
+
+-(NSTimeInterval)availabilityRequestTimeout
+{
+    return availabilityChecker.requestTimeout;
+}
+
+-(void)setAvailabilityHedgingEnabled:(BOOL)availabilityHedgingEnabled
+{
+    availabilityChecker.hedgingEnabled=availabilityHedgingEnabled;
+}
+
+-(BOOL)availabilityHedgingEnabled
+{
+    return availabilityChecker.hedgingEnabled;
 }
 
-//Method for chatButtonClicked()
--(void)chatButtonClicked
+-(void)setAvailabilityHedgePercentile:(double)availabilityHedgePercentile
 {
-    [self maximizeChat];
+    availabilityChecker.hedgePercentile=availabilityHedgePercentile;
+}
+
+-(double)availabilityHedgePercentile
+{
+    return availabilityChecker.hedgePercentile;
 }
 
 
 /********************************************************************************
- ** Function Name       : updateApplicationStatus
- ** Description         : This method will update ApplicationStatus to JS bridge.
- ** Input Parameters    : status
+ ** Function Name       : startChat
+ ** Description         : This method is used to load the chat view in the 
+                          application
+ ** Input Parameters    : contextInfo -- Dictionary containing any application
+                                         specific pre-chat related context information
+                          queueId -- String contain queueId passed by appdeveloper
+                                     Will be send to agent consol while then envoke getQueueId function.
  ** Output Parameters   : None
  ** Return Values       : void
  *******************************************************************************/
--(void)updateApplicationStatus :(NSString*)status
+-(void)startChat:(NSDictionary*)contextInfo andQueue:(NSString*) queueId;
 {
-    NSDictionary *Dic=[NSDictionary dictionaryWithObjectsAndKeys:status,@"applicationStatus", nil];
-    NSDictionary *sendingDic=[NSDictionary dictionaryWithObjectsAndKeys:Dic,@"result", nil];
-    NSError *jsonError;
-    
-    NSData *jsonData = [NSJSONSerialization dataWithJSONObject:sendingDic options:0 error:&jsonError];
-    
-    if (jsonError != nil)
+    //Offline the chat still starts, its load is retried by requestScheduler when the network is back
+    if([self configuration].isValid)
     {
-        //call error callback function here
-        NSLog(@"Error creating JSON from the response  : %@",[jsonError localizedDescription]);
+        //A chat preloaded for another queue is of no use
+        if([defaultSession isPrewarmed] && ![self isQueue:queueId sameAs:defaultSession.queueId])
+        {
+            [defaultSession releaseIfPrewarmed];
+        }
+        
+        if(!defaultSession)
+        {
+            defaultSession = [self newSessionForQueue:queueId contextInfo:contextInfo tag:nil];
+        }
+        else if(contextInfo!=nil && [defaultSession isPrewarmed])
+        {
+            //contextInfo given to startChat wins over the one given to preloadChat
+            defaultSession.contextInfo = contextInfo;
+        }
         
+        // Loads the chat, attaches the preloaded one or brings the running one into view
+        [defaultSession start];
+    }else{
+        [self notifyInvalidConfiguration];
     }
-    
-    NSString *jsonStr = [[NSString alloc] initWithData:jsonData encoding:NSUTF8StringEncoding];
-    
-    [chatWebview stringByEvaluatingJavaScriptFromString:[NSString stringWithFormat:@"%@(%@);",@"ApplicationStatus",jsonStr]];
 }
 
-
 /********************************************************************************
- ** Function Name       : updateLoaction
- ** Description         : This method will update location to JS bridge.
- ** Input Parameters    : location
+ ** Function Name       : openSessionForQueue
+ ** Description         : Opens a chat of queueId next to the chat of startChat & the
+                          other sessions, or brings the open chat of queueId into view
+ ** Input Parameters    : queueId -- String contain queueId passed by appdeveloper
+                          contextInfo -- Dictionary of pre-chat context information
  ** Output Parameters   : None
- ** Return Values       : void
+ ** Return Values       : ChatSDKSession, nil when the configuration is not valid
  *******************************************************************************/
--(void)updateLoaction :(CLLocation*)newLocation
+-(ChatSDKSession *)openSessionForQueue:(NSString *)queueId contextInfo:(NSDictionary *)contextInfo
 {
+    if(![self configuration].isValid)
+    {
+        [self notifyInvalidConfiguration];
+        return nil;
+    }
     
-    NSString*location=[self getStringOfLocation:newLocation];
-    
-    NSLog(@"location > %@",location);
-    
-    [chatWebview stringByEvaluatingJavaScriptFromString:[NSString stringWithFormat:@"%@(%@);",@"ReceivedLocation",location]];
+    ChatSDKSession *session = [sessionManager sessionForQueue:queueId];
+    if(session==nil)
+    {
+        // Its pages carry chatsdk_session so that ChatSDKURLProtocol gives them this session's bridge
+        sessionCount++;
+        session = [self newSessionForQueue:queueId contextInfo:contextInfo tag:[NSString stringWithFormat:@"%lu",(unsigned long)sessionCount]];
+    }
+    else if(contextInfo!=nil && [session isPrewarmed])
+    {
+        session.contextInfo = contextInfo;
+    }
+    [session start];
+    return session;
 }
 
-
-//get location string from CLLocation object
--(NSString*)getStringOfLocation:(CLLocation*)location
+-(NSArray *)sessions
 {
-    NSString *latitudeString = [NSString stringWithFormat:@"%f",location.coordinate.latitude];
-    NSString *longitudeString = [NSString stringWithFormat:@"%f",location.coordinate.longitude];
-    
-    NSDictionary *Dic=[NSDictionary dictionaryWithObjectsAndKeys:latitudeString,@"latitude",longitudeString,@"longitude", nil];
-    NSDictionary *sendingDic=[NSDictionary dictionaryWithObjectsAndKeys:Dic,@"result", nil];
-    NSError *jsonError;
-    
-    NSData *jsonData = [NSJSONSerialization dataWithJSONObject:sendingDic options:0 error:&jsonError];
-    
-    if (jsonError != nil)
-    {
-        //call error callback function here
-        NSLog(@"Error creating JSON from the response  : %@",[jsonError localizedDescription]);
-        
-    }
-    
-    NSString *jsonStr = [[NSString alloc] initWithData:jsonData encoding:NSUTF8StringEncoding];
-    
-    //NSLog(@"jsonStr = %@", jsonStr);
-    
-    if (jsonStr == nil)
+    NSMutableArray *activeSessions = [[NSMutableArray alloc] init];
+    for (ChatSDKSession *session in sessionManager.sessions)
     {
-        NSLog(@"location is null = %@", location);
+        if(session.isActive)
+        {
+            [activeSessions addObject:session];
+        }
     }
-    
-    
-    return jsonStr;
+    return activeSessions;
 }
 
+-(void)setEnginePoolSize:(NSUInteger)enginePoolSize
+{
+    sessionManager.poolSize = enginePoolSize;
+}
 
+-(NSUInteger)enginePoolSize
+{
+    return sessionManager.poolSize;
+}
 
+-(ChatSDKSession *)newSessionForQueue:(NSString *)queueId contextInfo:(NSDictionary *)contextInfo tag:(NSString *)tag
+{
+    return [[ChatSDKSession alloc] initWithQueue:queueId contextInfo:contextInfo tag:tag owner:self manager:sessionManager];
+}
 
+-(void)notifyInvalidConfiguration
+{
+    // Fetching Error Code
+    ChatSDKErrorCode  errorCode = ChatSDKInvalidParameterError;
+    sdkError.code = [self getErrorCode:errorCode];
+    sdkError.message = [self getErrorMessage:errorCode];
+    // CALLING DELEGATE FUNCTION WHICH WILL NOTIFY APPLICATION ABOUT ONCHATERROR
+    dispatch_async(dispatch_get_main_queue(), ^(void) {
+        [chatSDKCallbacks onChatErrorDelegateHandler:sdkError];
+    });
+}
+
+-(BOOL)isQueue:(NSString *)queueId sameAs:(NSString *)otherQueueId
+{
+    return queueId==otherQueueId || [queueId isEqualToString:otherQueueId];
+}
 
+/********************************************************************************
+ ** Function Name       : preloadChat
+ ** Description         : Loads the chat app into a hidden chatWebview ahead of
+                          startChat, which then only has to attach and animate it in.
+                          The warm view is released after prewarmTimeout, on memory
+                          warning, or is not created when the app is over
+                          prewarmMemoryBudget.
+ ** Input Parameters    : contextInfo -- Dictionary of pre-chat context information
+                          queueId -- String contain queueId passed by appdeveloper
+ ** Output Parameters   : None
+ ** Return Values       : void
+ *******************************************************************************/
+-(void)preloadChat:(NSDictionary*)contextInfo andQueue:(NSString*)queueId
+{
+    // Already warm or chat is running
+    if(defaultSession || ![self configuration].isValid || ![self isReachableToInternet])
+    {
+        return;
+    }
+    
+    if(_prewarmMemoryBudget>0 && ChatSDKResidentMemory()>_prewarmMemoryBudget)
+    {
+        NSLog(@"Not preloading chat, resident memory is over prewarmMemoryBudget");
+        return;
+    }
+    
+    defaultSession = [self newSessionForQueue:queueId contextInfo:contextInfo tag:nil];
+    [defaultSession preloadWithTimeout:_prewarmTimeout];
+}
 
-#pragma mark ChatSDKJSBridge Delegate
+-(void)prewarmForQueue:(NSString*)queueId
+{
+    [self preloadChat:nil andQueue:queueId];
+}
 
-- (NSDictionary *)executeNative:(ChatSDKBridgeAction *)nativeAction error:(NSError **)error {
-   
-    //-----------MINIMIZE CHAT------------//
-    if ([nativeAction.action isEqualToString:@"minimizechat"])
-    {       
-        dispatch_async(dispatch_get_main_queue(), ^{
-            // Calling minimizeChat()
-            [self minimizeChat];
-        });
-        
-        // Sending callback to Bridge.js
-        NSDictionary *resultDict = [[NSDictionary alloc] init];
-        NSDictionary *tempDict = [NSDictionary dictionaryWithObjectsAndKeys:[NSNumber numberWithBool:true],@"result",[NSNumber numberWithBool:true],@"action",[nativeAction.params objectForKey:@"id"],@"id",resultDict,@"data", nil];
-        return tempDict;
-        
-        
-    }//-----------END CHAT------------//
-    else if ([nativeAction.action isEqualToString:@"endchat"])
+-(void)prewarmIfAvailable:(BOOL)available forQueue:(NSString*)queueId
+{
+    if(available && _prewarmOnAvailability)
     {
-        dispatch_async(dispatch_get_main_queue(), ^{
-            // Caling endChat()
-            [self endChat];
-        });
-        return nil;
-        
-    }//-----------ONAGENTMESSAGE------------//
-    else if ([nativeAction.action isEqualToString:@"onagentmessage"])
+        [self prewarmForQueue:queueId];
+    }
+}
+
+//Drops the preloaded chats nobody started
+-(void)releasePrewarmedChat
+{
+    for (ChatSDKSession *session in sessionManager.sessions)
     {
-        dispatch_async(dispatch_get_main_queue(), ^{
-            // Do Desired UI update
-            NSDictionary *tempDict = [[NSDictionary alloc] initWithDictionary:nativeAction.params];
-            // CALLING DELEGATE FUNCTION WHICH WILL NOTIFY APPLICATION ABOUT ONAGENTMESSAGE
-            [chatSDKCallbacks onAgentMessageDelegateHandler:[tempDict objectForKey:@"data"]];
+        [session releaseIfPrewarmed];
+    }
+}
 
-        });
-       
-        // Sending callback to Bridge.js
-        NSDictionary *resultDict = [[NSDictionary alloc] init];
-        NSDictionary *tempDict = [NSDictionary dictionaryWithObjectsAndKeys:[NSNumber numberWithBool:true],@"result",[NSNumber numberWithBool:true],@"action",[nativeAction.params objectForKey:@"id"],@"id",resultDict,@"data", nil];
-        return tempDict;
-        
-        
-    }//-----------GETCONTEXT------------//
-    else if ([nativeAction.action isEqualToString:@"getcontext"])
+//Background, the preloaded chats & the idle engines are not worth their memory
+-(void)releaseIdleResources
+{
+    [self releasePrewarmedChat];
+    [sessionManager drainPool];
+}
+
+//Memory warning, the minimized chats give their chat view back too
+-(void)didReceiveMemoryWarning
+{
+    for (ChatSDKSession *session in sessionManager.sessions)
     {
-        // Sending callback to Bridge.js with contextInfoDictionary
-        NSDictionary *tempDict = [NSDictionary dictionaryWithObjectsAndKeys:[NSNumber numberWithBool:true],@"result",[NSNumber numberWithBool:true],@"action",[nativeAction.params objectForKey:@"id"],@"id",_contextInfoDict,@"data", nil];
-        return tempDict;
-        
-        
+        [session hibernateImmediately];
     }
-    //-----------getqueue------------//
-    else if ([nativeAction.action isEqualToString:@"getqueueid"])
+    //The hibernated chat views are released already, the pool goes too
+    [self releaseIdleResources];
+}
+
+/********************************************************************************
+ ** Function Name       : maximizeChat
+ ** Description         : This method is optional, used to bring back the chat into view
+                          if chat has been minimized by user action or by the application
+ ** Input Parameters    : None
+ ** Output Parameters   : None
+ ** Return Values       : void
+ *******************************************************************************/
+-(void)maximizeChat
+{
+    [defaultSession maximize];
+}
+
+/********************************************************************************
+ ** Function Name       : minimizeChat
+ ** Description         : This is an optional method that could be used by the 
+                          application to minimize the chat view.
+ ** Input Parameters    : None
+ ** Output Parameters   : None
+ ** Return Values       : void
+ *******************************************************************************/
+-(void)minimizeChat
+{
+    [defaultSession minimize];
+}
+
+/********************************************************************************
+ ** Function Name       : endChat
+ ** Description         : This is an optional method that could be called to 
+                          programmatically end chat session and close the chat view.
+ ** Input Parameters    : None
+ ** Output Parameters   : None
+ ** Return Values       : void
+ *******************************************************************************/
+-(void)endChat
+{
+    if(defaultSession!=nil)
     {
-        NSDictionary *queueIdDic=[[NSDictionary alloc] initWithObjectsAndKeys:_chatSDKqueueId,@"QueueId", nil];
-        // Sending callback to Bridge.js with contextInfoDictionary
-        NSDictionary *tempDict = [NSDictionary dictionaryWithObjectsAndKeys:[NSNumber numberWithBool:true],@"result",[NSNumber numberWithBool:true],@"action",[nativeAction.params objectForKey:@"id"],@"id",queueIdDic,@"data", nil];
-        return tempDict;
-        
-        
+        [defaultSession end];
+        return;
     }
     
-    //-----------CHATSTARTED------------//
-    else if ([nativeAction.action isEqualToString:@"chatstarted"])
+    dispatch_async(dispatch_get_main_queue(), ^(void) {
+        // Creating a blank NSDictionary.
+        NSDictionary *tempDict = [[NSDictionary alloc] init];
+        // CALLING DELEGATE FUNCTION WHICH WILL NOTIFY APPLICATION ABOUT ENDCHAT
+        [chatSDKCallbacks onChatEndedDelegateHandler:tempDict];
+    });
+}
+
+
+/********************************************************************************
+ ** Function Name       : updateApplicationStatus
+ ** Description         : This method will update ApplicationStatus to JS bridge
+                          of every chat.
+ ** Input Parameters    : status
+ ** Output Parameters   : None
+ ** Return Values       : void
+ *******************************************************************************/
+-(void)updateApplicationStatus :(NSString*)status
+{
+    for (ChatSDKSession *session in sessionManager.sessions)
     {
-        dispatch_async(dispatch_get_main_queue(), ^{
-            // CALLING DELEGATE FUNCTION WHICH WILL NOTIFY APPLICATION ABOUT ONCHATSTARTED
-            [chatSDKCallbacks onChatStartedDelegateHandler:[nativeAction.params objectForKey:@"data"]];
-            
-        });
-        
-        // Sending callback to Bridge.js
-        NSDictionary *resultDict = [[NSDictionary alloc] init];
-        NSDictionary *tempDict = [NSDictionary dictionaryWithObjectsAndKeys:[NSNumber numberWithBool:true],@"result",[NSNumber numberWithBool:true],@"action",[nativeAction.params objectForKey:@"id"],@"id",resultDict,@"data", nil];
-        return tempDict;
-        
-    }//-----------LOG VALUE------------//
-    else if ([nativeAction.action isEqualToString:@"logvalue"])
-    {        
-        NSLog(@"JS CONSOLE: %@",[nativeAction.params objectForKey:@"data"]);
-        
-        // Sending callback to Bridge.js
-        NSDictionary *resultDict = [[NSDictionary alloc] init];
-        NSDictionary *tempDict = [NSDictionary dictionaryWithObjectsAndKeys:[NSNumber numberWithBool:true],@"result",[NSNumber numberWithBool:true],@"action",[nativeAction.params objectForKey:@"id"],@"id",resultDict,@"data", nil];
-        return tempDict;
-    }//-----------SHOW DIALOG------------//
-    else if ([nativeAction.action isEqualToString:@"showdialog"])
+        [session sendApplicationStatus:status];
+    }
+}
+
+
+/********************************************************************************
+ ** Function Name       : updateLoaction
+ ** Description         : This method will update location to JS bridge of every chat.
+ ** Input Parameters    : location
+ ** Output Parameters   : None
+ ** Return Values       : void
+ *******************************************************************************/
+-(void)updateLoaction :(CLLocation*)newLocation
+{
+    for (ChatSDKSession *session in sessionManager.sessions)
+    {
+        [session sendLocation:newLocation];
+    }
+}
+
+#pragma mark ChatSDKSession Owner
+
+-(UIWindow *)windowForSession:(ChatSDKSession *)session
+{
+    return chatWindow;
+}
+
+-(ChatSDKCallbacks *)callbacksForSession:(ChatSDKSession *)session
+{
+    return chatSDKCallbacks;
+}
+
+-(ChatSDKAssetCache *)assetCacheForSession:(ChatSDKSession *)session
+{
+    return assetCache;
+}
+
+-(ChatSDKBridgeActionRegistry *)bridgeActionsForSession:(ChatSDKSession *)session
+{
+    return bridgeActions;
+}
+
+-(ChatSDKTranscriptStore *)transcriptStoreForSession:(ChatSDKSession *)session
+{
+    return _keepsTranscripts ? transcriptStore : nil;
+}
+
+-(NSTimeInterval)hibernationDelayForSession:(ChatSDKSession *)session
+{
+    return _hibernationDelay;
+}
+
+-(ChatSDKRequestScheduler *)requestSchedulerForSession:(ChatSDKSession *)session
+{
+    return requestScheduler;
+}
+
+-(void)sessionDidPresent:(ChatSDKSession *)session
+{
+    /*
+     location is sent to JS Bridge via webView,
+     so tracking starts once the first chat loaded completely.
+     */
+    if (self.allowLocationAccess && _chatSDKLocation==nil) {
+        _chatSDKLocation  = [[ChatSDKLocation alloc] init];
+        _chatSDKLocation.delegate=self;
+        _chatSDKLocation.trackingMode=_locationTrackingMode;
+        _chatSDKLocation.desiredAccuracy=_locationDesiredAccuracy;
+        _chatSDKLocation.distanceFilter=_locationDistanceFilter;
+        _chatSDKLocation.minimumInterval=_locationMinimumInterval;
+        [_chatSDKLocation setReducedAccuracy:[self prefersReducedLocationAccuracy]];
+        [_chatSDKLocation startTracking];
+    }
+    else
+    {
+        [_chatSDKLocation setReducedAccuracy:[self prefersReducedLocationAccuracy]];
+    }
+}
+
+-(void)sessionDidChangeMinimized:(ChatSDKSession *)session
+{
+    [_chatSDKLocation setReducedAccuracy:[self prefersReducedLocationAccuracy]];
+}
+
+-(void)sessionDidEnd:(ChatSDKSession *)session
+{
+    [sessionManager removeSession:session];
+    if(session==defaultSession)
+    {
+        defaultSession=nil;
+    }
+    
+    //stop location tracking when the last chat closed.
+    if([[self sessions] count]==0)
+    {
+        [_chatSDKLocation stopTracking];
+        _chatSDKLocation=nil;
+    }
+    else
     {
-        NSDictionary* dialogParams= [nativeAction.params objectForKey:@"data"];
+        [_chatSDKLocation setReducedAccuracy:[self prefersReducedLocationAccuracy]];
+    }
+}
+
+//nobody looks at a chat, a rough location will do
+-(BOOL)prefersReducedLocationAccuracy
+{
+    if(inBackground)
+    {
+        return YES;
+    }
+    for (ChatSDKSession *session in sessionManager.sessions)
+    {
+        if(session.isActive && !session.isMinimized)
+        {
+            return NO;
+        }
+    }
+    return YES;
+}
+
+
+#pragma mark Bridge Actions
+
+//Native actions of Bridge.js shared by every chat, the data they return is sent back in the {result, action, id, data} envelope.
+//Each ChatSDKSession answers minimizechat, endchat, onagentmessage, getcontext, getqueueid & chatstarted itself
+//and completes the async actions of this registry in its own chat.
+-(void)registerBridgeActions
+{
+    bridgeActions = [[ChatSDKBridgeActionRegistry alloc] init];
+    __weak ChatSDK *weakSelf = self;
+    
+    //-----------LOG VALUE------------//
+    [bridgeActions registerAction:@"logvalue" handler:^NSDictionary *(ChatSDKBridgeAction *action, NSError **error) {
+        NSLog(@"JS CONSOLE: %@",[action.params objectForKey:@"data"]);
+        return [[NSDictionary alloc] init];
+    }];
+    
+    //-----------SHOW DIALOG------------//
+    [bridgeActions registerAction:@"showdialog" asyncHandler:^(ChatSDKBridgeAction *action, ChatSDKBridgeActionCompletion completion) {
+        NSDictionary* dialogParams= [action.params objectForKey:@"data"];
         
         UIAlertView* dialog = nil;
         if([[dialogParams objectForKey:@"type"] isEqualToString:@"confirm"])
@@ -807,214 +1012,235 @@ typedef enum {
                     buttonClicked=1;
                 }
                 
-                NSString* stringWithId=[[NSString alloc] initWithFormat:@"{ \"id\": \"%@\",\"result\": \"true\",\"action\": \"true\",\"data\": {\"result\": \"%i\"}}",[nativeAction.params objectForKey:@"id"],buttonClicked];
-                
-                [chatWebview stringByEvaluatingJavaScriptFromString:[NSString stringWithFormat:@"window.NativeBridge._complete('%@')",stringWithId]];
+                completion([NSDictionary dictionaryWithObject:[NSString stringWithFormat:@"%i",buttonClicked] forKey:@"result"], nil);
             }];
         });
-        
-        NSDictionary *resultDict = [[NSDictionary alloc] initWithObjects:[NSArray arrayWithObject:[NSNumber numberWithBool:true]] forKeys:[NSArray arrayWithObject:@"ignore"]];
-        NSDictionary *tempDict = [NSDictionary dictionaryWithObjectsAndKeys:[NSNumber numberWithBool:true],@"result",[NSNumber numberWithBool:true],@"action",nil,@"id",resultDict,@"data", nil];
-        
-        NSLog(@"## Response: %@",resultDict);
-        return tempDict;
-        
-    }
-    else if ([nativeAction.action isEqualToString:@"getlocation"])
-    {
-        
-        // Sending callback to Bridge.js
+    }];
+    
+    //-----------GET LOCATION------------//
+    [bridgeActions registerAction:@"getlocation" handler:^NSDictionary *(ChatSDKBridgeAction *action, NSError **error) {
+        ChatSDK *strongSelf = weakSelf;
         NSMutableDictionary *resultDict = [[NSMutableDictionary alloc] init];
-        NSNumber *status;
-        if (_allowLocationAccess) {
-            
-            [resultDict setObject:[NSString stringWithFormat:@"%f",_chatSDKLocation.locationManager.location.coordinate.latitude] forKey:@"latitude"];
-            [resultDict setObject:[NSString stringWithFormat:@"%f",_chatSDKLocation.locationManager.location.coordinate.longitude] forKey:@"longitude"];
-            status=[NSNumber numberWithBool:true];
+        if (strongSelf.allowLocationAccess) {
+            // On demand tracking answers with the last known location & sends a fresh one as ReceivedLocation
+            dispatch_async(dispatch_get_main_queue(), ^{
+                [weakSelf.chatSDKLocation requestLocation];
+            });
+            CLLocationCoordinate2D coordinate = strongSelf.chatSDKLocation.locationManager.location.coordinate;
+            [resultDict setObject:[NSString stringWithFormat:@"%f",coordinate.latitude] forKey:@"latitude"];
+            [resultDict setObject:[NSString stringWithFormat:@"%f",coordinate.longitude] forKey:@"longitude"];
         }
         else{
             [resultDict setObject:@"Location access is disabled from application side." forKey:@"error"];
-            status=[NSNumber numberWithBool:false];
         }
-        
-        status=[NSNumber numberWithBool:true];
-        NSDictionary *tempDict = [NSDictionary dictionaryWithObjectsAndKeys:status,@"result",[NSNumber numberWithBool:true],@"action",[nativeAction.params objectForKey:@"id"],@"id",resultDict,@"data", nil];
-        return tempDict;
-        
-    }
-    return nil;
+        return resultDict;
+    }];
+    
+    builtInBridgeActions = [[NSSet alloc] initWithObjects:@"minimizechat",@"endchat",@"onagentmessage",@"getcontext",@"getqueueid",@"chatstarted",@"gettranscript",@"addtranscriptentry",@"cleartranscript",@"hibernateready",@"logvalue",@"showdialog",@"getlocation", nil];
 }
 
-#pragma mark WebView Delegate
--(void)webViewDidStartLoad:(UIWebView *)webView
+/********************************************************************************
+ ** Function Name       : registerNativeAction
+ ** Description         : Lets the application answer its own chat_exec actions of
+                          the chat app. Actions of the SDK can not be replaced.
+ ** Input Parameters    : action -- action name, case insensitive
+                          handler -- returns the data sent back to the chat app
+ ** Output Parameters   : None
+ ** Return Values       : NO if action is an action of the SDK
+ *******************************************************************************/
+-(BOOL)registerNativeAction:(NSString *)action handler:(ChatSDKNativeActionHandler)handler
 {
-    NSLog(@"webViewDidStartLoad");
-   [_indicatorView startAnimating];
+    if(action==nil || handler==nil || [builtInBridgeActions containsObject:[action lowercaseString]])
+    {
+        return NO;
+    }
+    ChatSDKNativeActionHandler hostHandler = [handler copy];
+    [bridgeActions registerAction:action handler:^NSDictionary *(ChatSDKBridgeAction *bridgeAction, NSError **error) {
+        NSDictionary *data = hostHandler([bridgeAction.params objectForKey:@"data"]);
+        return data ? data : [[NSDictionary alloc] init];
+    }];
+    return YES;
 }
--(void)webViewDidFinishLoad:(UIWebView *)webView
+
+-(BOOL)registerNativeAction:(NSString *)action asyncHandler:(ChatSDKNativeAsyncActionHandler)handler
 {
-    /*
-     start location tracing after loading webView Completely.
-     because we are sending it to JS Bridge via webView,
-     so we have to send it after loading webView completely.
-     */
-    if (self.allowLocationAccess) {
-        _chatSDKLocation  = [[ChatSDKLocation alloc] init];
-        _chatSDKLocation.delegate=self;
-        [_chatSDKLocation startTracking];
-    }
-    
-    
-    //Keyboard Up Event Fix on iOS7, compiled with iOS7
-    if([[[UIDevice currentDevice] systemVersion] floatValue] >=7.0f && COMPILED_WITH_VER>=7)
+    if(action==nil || handler==nil || [builtInBridgeActions containsObject:[action lowercaseString]])
     {
-        
-        if(UI_USER_INTERFACE_IDIOM() == UIUserInterfaceIdiomPad){
-            
-            [chatWebview stringByEvaluatingJavaScriptFromString:@"document.addEventListener('touchstart',function(e){var tag = e.target.tagName; if(tag && ((tag.toLowerCase() === 'input' && e.target.type === 'text') || (tag.toLowerCase() === 'textarea'))){setTimeout(function(){e.target.focus();},0);}}); window.onorientationchange = function(){if((window.orientation == 90 || window.orientation == -90 || window.orientation == 0 || window.orientation == 180) && (document.activeElement && (document.activeElement.tagName.toLowerCase() === 'input' || document.activeElement.tagName.toLowerCase() === 'textarea'))){ var elem = document.activeElement;elem.blur();elem.focus();}}; var metaTag = document.getElementsByTagName(\"meta\"); metaTag[0].parentNode.removeChild(metaTag[0]);"];
-        }
-        else{
-            
-            [chatWebview stringByEvaluatingJavaScriptFromString:@"document.addEventListener('touchstart',function(e){var tag = e.target.tagName; if(tag && ((tag.toLowerCase() === 'input' && e.target.type === 'text') || (tag.toLowerCase() === 'textarea'))){setTimeout(function(){e.target.focus();},0);}}); window.onorientationchange = function(){if((window.orientation == 90 || window.orientation == -90) && (document.activeElement && (document.activeElement.tagName.toLowerCase() === 'input' || document.activeElement.tagName.toLowerCase() === 'textarea'))){ var elem = document.activeElement;elem.blur();elem.focus();}}; var metaTag = document.getElementsByTagName(\"meta\"); metaTag[0].parentNode.removeChild(metaTag[0]);"];
-        }
+        return NO;
     }
-    
-    //Viewport fix
-    NSString* js =
-    @"var meta = document.createElement('meta'); "
-    @"meta.setAttribute( 'name', 'viewport' ); "
-    @"meta.setAttribute( 'content', 'width = 320px, initial-scale = 1.0, user-scalable = yes' ); "
-    @"document.getElementsByTagName('head')[0].appendChild(meta)";
-    [chatWebview stringByEvaluatingJavaScriptFromString: js];
-    
-    if(_indicatorView!=nil)
+    ChatSDKNativeAsyncActionHandler hostHandler = [handler copy];
+    [bridgeActions registerAction:action asyncHandler:^(ChatSDKBridgeAction *bridgeAction, ChatSDKBridgeActionCompletion completion) {
+        hostHandler([bridgeAction.params objectForKey:@"data"], ^(NSDictionary *data) {
+            completion(data ? data : [[NSDictionary alloc] init], nil);
+        });
+    }];
+    return YES;
+}
+
+-(void)unregisterNativeAction:(NSString *)action
+{
+    if(action==nil || [builtInBridgeActions containsObject:[action lowercaseString]])
     {
-        [_indicatorView stopAnimating];
-        [_indicatorView removeFromSuperview];
-        _indicatorView = nil;
+        return;
     }
-    
-    // This is done as per requirement when the spinner finished loading then we have to load the chatwebview
-    if (UI_USER_INTERFACE_IDIOM() == UIUserInterfaceIdiomPad)
+    [bridgeActions removeAction:action];
+}
+
+-(NSDictionary *)bridgeMetrics
+{
+    return [[ChatSDKBridgeMetrics sharedMetrics] snapshot];
+}
+
+-(void)resetBridgeMetrics
+{
+    [[ChatSDKBridgeMetrics sharedMetrics] reset];
+}
+
+-(void)scheduleNetworkRequest:(ChatSDKScheduledRequest)request withKey:(NSString *)key
+{
+    dispatch_async(dispatch_get_main_queue(), ^(void) {
+        [requestScheduler scheduleRequest:request withKey:key];
+    });
+}
+
+-(NSDictionary *)requestMetrics
+{
+    return [requestScheduler metrics];
+}
+
+-(void)resetRequestMetrics
+{
+    [requestScheduler resetMetrics];
+}
+
+-(NSDictionary *)animationMetrics
+{
+    return [[ChatSDKAnimationMetrics sharedMetrics] snapshot];
+}
+
+-(void)resetAnimationMetrics
+{
+    [[ChatSDKAnimationMetrics sharedMetrics] reset];
+}
+
+-(BOOL)reloadConfiguration
+{
+    return [self reloadConfiguration:NULL];
+}
+
+-(BOOL)reloadConfiguration:(NSError **)error
+{
+    NSURL *previousManifestURL = [self configuration].assetManifestURL;
+    ChatSDKConfiguration *configuration = [ChatSDKConfiguration reloadSharedConfiguration];
+    if(!(previousManifestURL == configuration.assetManifestURL || [previousManifestURL isEqual:configuration.assetManifestURL]))
     {
-        // And adding the animation on webview as per the animation style from plist.
-        // CAlling a local function which will add the chatwebview with animation.
-        //[self addChatWebviewWithAnimation:chatSDKResources.animationStyle and:FALSE];
+        [self createAssetCache];
     }
-    else
+    if(!configuration.isValid && error!=NULL)
     {
-//        [chatWindow addSubview:chatWebview];
+        *error = [configuration.validationErrors firstObject];
     }
-    [chatWebview showWithAnimation];
-    [chatWindow addSubview:chatWebview];
+    return configuration.isValid;
+}
+
+-(NSArray *)configurationErrors
+{
+    return [self configuration].validationErrors;
 }
 
--(void)webView:(UIWebView *)webView didFailLoadWithError:(NSError *)error
+-(void)setKeepsTranscripts:(BOOL)keepsTranscripts
 {
-    if(_indicatorView!=nil)
+    _keepsTranscripts=keepsTranscripts;
+    if(!keepsTranscripts)
     {
-        [_indicatorView stopAnimating];
-        [_indicatorView removeFromSuperview];
-        _indicatorView = nil;
+        [transcriptStore removeAllTranscripts];
     }
-    NSLog(@"indidfailloadwitherror");
-    _firstTimeFlag = FALSE;
-    orientation = [[UIDevice currentDevice] orientation];
-    
-    //TODO 
-    //[chatWebview resetWebView];
+}
 
-    [chatWebview loadHTMLString:ERROR_PAGE_STRING baseURL:nil];
-    [chatWindow addSubview:chatWebview];
+-(void)setTranscriptMaximumAge:(NSTimeInterval)transcriptMaximumAge
+{
+    transcriptStore.maximumAge=transcriptMaximumAge;
 }
 
-- (BOOL)webView:(UIWebView *)webView shouldStartLoadWithRequest:(NSURLRequest *)request navigationType:(UIWebViewNavigationType)navigationType
+-(NSTimeInterval)transcriptMaximumAge
 {
-    if([[[request URL] absoluteString] rangeOfString:@"chatsdk_closedialog"].location != NSNotFound)
-    {
-        // Calling Function to destroy ChatWebview.
-        [self endChat];
-        _firstTimeFlag = FALSE;
-        // Creating a blank NSDictionary.
-        dispatch_async(dispatch_get_main_queue(), ^(void) {
-            NSDictionary *tempDict = [[NSDictionary alloc] init];
-            // CALLING DELEGATE FUNCTION WHICH WILL NOTIFY APPLICATION ABOUT ENDCHAT
-            [chatSDKCallbacks onChatEndedDelegateHandler:tempDict];
-        });
-        return NO;
-    }
-    else if([[[request URL] absoluteString] hasPrefix:[NSString stringWithFormat:@"http://%@",chatSDKResources.customUrlScheme]])
+    return transcriptStore.maximumAge;
+}
+
+-(void)setTranscriptMaximumSize:(unsigned long long)transcriptMaximumSize
+{
+    transcriptStore.maximumSize=transcriptMaximumSize;
+}
+
+-(unsigned long long)transcriptMaximumSize
+{
+    return transcriptStore.maximumSize;
+}
+
+-(void)setDelegateQueue:(dispatch_queue_t)delegateQueue
+{
+    chatSDKCallbacks.delegateQueue=delegateQueue;
+}
+
+-(dispatch_queue_t)delegateQueue
+{
+    return chatSDKCallbacks.delegateQueue;
+}
+
+-(void)setAgentMessageCoalescingInterval:(NSTimeInterval)agentMessageCoalescingInterval
+{
+    chatSDKCallbacks.agentMessageCoalescingInterval=agentMessageCoalescingInterval;
+}
+
+-(NSTimeInterval)agentMessageCoalescingInterval
+{
+    return chatSDKCallbacks.agentMessageCoalescingInterval;
+}
+
+-(void)clearTranscripts
+{
+    [transcriptStore removeAllTranscripts];
+}
+
+/********************************************************************************
+ ** Function Name       : handleAgentMessageNotification
+ ** Description         : Hands an agent message that arrived by notification to
+                          the chat of its queue. Only a hibernated chat, which has
+                          no connection of its own, takes it.
+ ** Input Parameters    : userInfo -- userInfo of the notification
+ ** Output Parameters   : None
+ ** Return Values       : YES when a hibernated chat took the message
+ *******************************************************************************/
+-(BOOL)handleAgentMessageNotification:(NSDictionary *)userInfo
+{
+    NSDictionary *message=[userInfo objectForKey:@"chatsdk_agentmessage"];
+    if(![message isKindOfClass:[NSDictionary class]])
     {
-        // Creating a blank NSDictionary.
-        dispatch_async(dispatch_get_main_queue(), ^(void) {
-            // CALLING DELEGATE FUNCTION WITH URL WHICH WILL NOTIFY APPLICATION ABOUT CUSTOM URL
-            NSDictionary *tempDict = [[NSDictionary alloc] initWithObjects:[NSArray arrayWithObject:[[request URL] absoluteString]] forKeys:[NSArray arrayWithObject:@"url"]];
-            [chatSDKCallbacks onNavigationRequestHandler:tempDict];
-        });
         return NO;
     }
-    else if([[[request URL] absoluteString] hasPrefix:[NSString stringWithFormat:@"http://chat_exec_agentmessage"]])
+    NSString *queueId=[message objectForKey:@"queueId"];
+    ChatSDKSession *session=nil;
+    if([queueId isKindOfClass:[NSString class]])
     {
-        NSDictionary *params=nil;
-        NSString *escapedQuery = [[[request URL] query] stringByReplacingPercentEscapesUsingEncoding:NSASCIIStringEncoding];
-        params = [NSJSONSerialization JSONObjectWithData:[escapedQuery dataUsingEncoding:NSUTF8StringEncoding] options:kNilOptions error:NULL];
-        
-        dispatch_async(dispatch_get_main_queue(), ^{
-            
-            //Increment badge count if chat is minimized
-            if(chatWebview.hidden)
-            {
-                [_chatButton incrementBadgeCount];
-            }
-            // Creating dictionary
-            NSDictionary *tempDict = [[NSDictionary alloc] initWithDictionary:params];
-            // CALLING DELEGATE FUNCTION WHICH WILL NOTIFY APPLICATION ABOUT ONAGENTMESSAGE
-            [chatSDKCallbacks onAgentMessageDelegateHandler:[tempDict objectForKey:@"data"]];
-            
-        });
-        
-        return NO;
+        session=[sessionManager sessionForQueue:queueId];
     }
     else
     {
-        if(_firstTimeFlag == TRUE)
-        {
-            [[UIApplication sharedApplication] openURL:[NSURL URLWithString:[[request URL] absoluteString] ]];
-            return NO;
-        }
-        else
-        {
-            // Assigning flag to TRUE.
-            _firstTimeFlag = TRUE;
-            return YES;
-        }
+        session=defaultSession;
     }
-    return YES;
+    return [session receiveAgentMessage:[message objectForKey:@"data"]];
 }
 
-// UICOLOR FROM HEXADECIMAL VALUE
--(UIColor *)colorFromHexString:(NSString *)hexString {
-    unsigned rgbValue = 0;
-    NSScanner *scanner = [NSScanner scannerWithString:hexString];
-    [scanner setScanLocation:1]; // bypass '#' character
-    [scanner scanHexInt:&rgbValue];
-    return [UIColor colorWithRed:((rgbValue & 0xFF0000) >> 16)/255.0 green:((rgbValue & 0xFF00) >> 8)/255.0 blue:(rgbValue & 0xFF)/255.0 alpha:1.0];
+-(ChatSDKConfiguration *)configuration
+{
+    return [ChatSDKConfiguration sharedConfiguration];
 }
 
--(ChatSDKMaximizeButton *)createChatButton
+-(void)createAssetCache
 {
-    //Creating ChatSDKMaximizeButton
-    ChatSDKMaximizeButton *chatBtn = [[ChatSDKMaximizeButton alloc] init];
-
-    NSString *buttonBgColor = chatSDKResources.minimizedButtonBackgroundColor;
-    NSString *buttonTextColor = chatSDKResources.minimizedButtonTextColor;
-    UIColor *backgroundColor = [self colorFromHexString:buttonBgColor];
-    [chatBtn setBackgroundColor:backgroundColor];
-    UIColor *textColor = [self colorFromHexString:buttonTextColor];
-    [chatBtn setTitleColor:textColor forState:UIControlStateNormal];
-    [chatBtn addTarget:self action:@selector(chatButtonClicked) forControlEvents:UIControlEventTouchUpInside];
-    
-    return chatBtn;
+    NSURL *manifestURL = [self configuration].assetManifestURL;
+    assetCache = manifestURL ? [[ChatSDKAssetCache alloc] initWithManifestURL:manifestURL] : nil;
+    [assetCache load];
 }
 
 -(NSInteger)getErrorCode:(NSInteger )errorCode
@@ -1065,11 +1291,21 @@ typedef enum {
 {
     [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(backgroundApp) name:UIApplicationDidEnterBackgroundNotification object:nil];
     [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(foregroundApp) name:UIApplicationWillEnterForegroundNotification object:nil];
+    [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(didReceiveMemoryWarning) name:UIApplicationDidReceiveMemoryWarningNotification object:nil];
 }
 
 -(void)backgroundApp
 {
     [self updateApplicationStatus:@"background"];
+    
+    inBackground=YES;
+    [_chatSDKLocation setReducedAccuracy:YES];
+    
+    //no availability long-polls while in background
+    [availabilitySubscriber pause];
+    
+    //preloaded chats & idle engines are not worth their memory while in background
+    [self releaseIdleResources];
 }
 
 -(void)foregroundApp
@@ -1077,10 +1313,14 @@ typedef enum {
     [self updateApplicationStatus:@"foreground"];
     NSLog(@"foregroundApp");
     
-    //start tracking again if app from background to foreground.
-    if (self.allowLocationAccess) {
-        //[_chatSDKLocation startTracking];
+    if(requestScheduler.reachable)
+    {
+        [availabilitySubscriber resume];
     }
+    
+    //full accuracy again unless every chat is minimized
+    inBackground=NO;
+    [_chatSDKLocation setReducedAccuracy:[self prefersReducedLocationAccuracy]];
 }
 
 
@@ -1089,7 +1329,7 @@ typedef enum {
 }
 
 - (void)dealloc {
-    // This instance is going away, so unbind it from our custom NSURLCache
-    [NSURLCache setChatSDKJSBridgeDelegate:nil];
+    // The sessions stop answering their chat app's requests as they go away
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
 }
 @end
@@ -0,0 +1,30 @@
+//
+//  ChatSDKAnimationMetrics.h
+//  247ChatSDK
+//
+//  Copyright (c) 2014 . All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/*
+ * ChatSDKAnimationMetrics  Frame times of the chat & button animations, sampled with a display link that only
+                            runs while one of them is in progress. A frame that took more than one and a half
+                            refresh intervals counts the refreshes it missed as dropped. Main thread only.
+ */
+@interface ChatSDKAnimationMetrics : NSObject
+
++(ChatSDKAnimationMetrics *)sharedMetrics;
+
+-(void)beginAnimation:(NSString *)name;
+-(void)endAnimation:(NSString *)name;
+
+/*
+ {"since" : <seconds since 1970>, "animations" : {<name> : {"count", "frames", "droppedFrames", "longestFrame",
+ "frameTime" : {"p50", "p95", "p99"}}}}, times in milliseconds, percentiles over the last frames
+ */
+-(NSDictionary *)snapshot;
+
+-(void)reset;
+
+@end
@@ -0,0 +1,164 @@
+//
+//  ChatSDKAnimationMetrics.m
+//  247ChatSDK
+//
+//  Copyright (c) 2014 . All rights reserved.
+//
+
+#import "ChatSDKAnimationMetrics.h"
+#import "ChatSDKLatencyStats.h"
+#import <QuartzCore/QuartzCore.h>
+
+// Frame times kept per animation for the percentiles
+#define kFrameTimeWindow 256
+
+// Numbers of one animation name
+@interface ChatSDKAnimationCounters : NSObject
+{
+@public
+    NSUInteger count;
+    NSUInteger frames;
+    NSUInteger droppedFrames;
+    NSTimeInterval longestFrame;
+    // Animations of this name in progress
+    NSUInteger running;
+}
+@property (nonatomic, strong) ChatSDKLatencyStats *frameTimes;
+@end
+
+@implementation ChatSDKAnimationCounters
+@synthesize frameTimes = _frameTimes;
+@end
+
+@interface ChatSDKAnimationMetrics ()
+{
+    NSMutableDictionary *counters;
+    NSDate *since;
+    CADisplayLink *displayLink;
+    CFTimeInterval lastFrameTimestamp;
+    NSUInteger runningAnimations;
+}
+@end
+
+@implementation ChatSDKAnimationMetrics
+
++(ChatSDKAnimationMetrics *)sharedMetrics
+{
+    static ChatSDKAnimationMetrics *sharedMetrics = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedMetrics = [[ChatSDKAnimationMetrics alloc] init];
+    });
+    return sharedMetrics;
+}
+
+-(id)init
+{
+    if (self = [super init]) {
+        counters = [[NSMutableDictionary alloc] init];
+        since = [NSDate date];
+    }
+    return self;
+}
+
+-(void)beginAnimation:(NSString *)name
+{
+    ChatSDKAnimationCounters *animation = [counters objectForKey:name];
+    if (animation == nil) {
+        animation = [[ChatSDKAnimationCounters alloc] init];
+        animation.frameTimes = [[ChatSDKLatencyStats alloc] initWithWindowSize:kFrameTimeWindow];
+        [counters setObject:animation forKey:name];
+    }
+    animation->count++;
+    animation->running++;
+    runningAnimations++;
+
+    if (displayLink == nil) {
+        // The display link retains its target until invalidated in endAnimation:
+        displayLink = [CADisplayLink displayLinkWithTarget:self selector:@selector(displayLinkFired:)];
+        [displayLink addToRunLoop:[NSRunLoop mainRunLoop] forMode:NSRunLoopCommonModes];
+        lastFrameTimestamp = 0;
+    }
+}
+
+-(void)endAnimation:(NSString *)name
+{
+    ChatSDKAnimationCounters *animation = [counters objectForKey:name];
+    if (animation == nil || animation->running == 0) {
+        return;
+    }
+    animation->running--;
+    runningAnimations--;
+
+    if (runningAnimations == 0) {
+        [displayLink invalidate];
+        displayLink = nil;
+    }
+}
+
+-(void)displayLinkFired:(CADisplayLink *)link
+{
+    CFTimeInterval timestamp = link.timestamp;
+    if (lastFrameTimestamp == 0) {
+        lastFrameTimestamp = timestamp;
+        return;
+    }
+    CFTimeInterval frameTime = timestamp - lastFrameTimestamp;
+    lastFrameTimestamp = timestamp;
+
+    NSUInteger dropped = 0;
+    CFTimeInterval refreshInterval = link.duration;
+    if (refreshInterval > 0 && frameTime > 1.5 * refreshInterval) {
+        dropped = (NSUInteger)(frameTime / refreshInterval + 0.5) - 1;
+    }
+
+    for (ChatSDKAnimationCounters *animation in [counters objectEnumerator]) {
+        if (animation->running == 0) {
+            continue;
+        }
+        animation->frames++;
+        animation->droppedFrames += dropped;
+        if (frameTime > animation->longestFrame) {
+            animation->longestFrame = frameTime;
+        }
+        [animation.frameTimes addSample:frameTime];
+    }
+}
+
+-(NSDictionary *)snapshot
+{
+    NSMutableDictionary *animations = [[NSMutableDictionary alloc] initWithCapacity:[counters count]];
+    for (NSString *name in counters) {
+        ChatSDKAnimationCounters *animation = [counters objectForKey:name];
+        NSDictionary *frameTime = @{ @"p50" : [NSNumber numberWithDouble:[animation.frameTimes latencyAtPercentile:0.50] * 1000.0],
+                                     @"p95" : [NSNumber numberWithDouble:[animation.frameTimes latencyAtPercentile:0.95] * 1000.0],
+                                     @"p99" : [NSNumber numberWithDouble:[animation.frameTimes latencyAtPercentile:0.99] * 1000.0] };
+        [animations setObject:@{ @"count" : [NSNumber numberWithUnsignedInteger:animation->count],
+                                 @"frames" : [NSNumber numberWithUnsignedInteger:animation->frames],
+                                 @"droppedFrames" : [NSNumber numberWithUnsignedInteger:animation->droppedFrames],
+                                 @"longestFrame" : [NSNumber numberWithDouble:animation->longestFrame * 1000.0],
+                                 @"frameTime" : frameTime }
+                       forKey:name];
+    }
+    return @{ @"since" : [NSNumber numberWithDouble:[since timeIntervalSince1970]],
+              @"animations" : animations };
+}
+
+-(void)reset
+{
+    // Animations in progress keep being sampled, into fresh counters
+    NSMutableDictionary *fresh = [[NSMutableDictionary alloc] init];
+    for (NSString *name in counters) {
+        ChatSDKAnimationCounters *animation = [counters objectForKey:name];
+        if (animation->running > 0) {
+            ChatSDKAnimationCounters *running = [[ChatSDKAnimationCounters alloc] init];
+            running.frameTimes = [[ChatSDKLatencyStats alloc] initWithWindowSize:kFrameTimeWindow];
+            running->running = animation->running;
+            [fresh setObject:running forKey:name];
+        }
+    }
+    counters = fresh;
+    since = [NSDate date];
+}
+
+@end
@@ -0,0 +1,39 @@
+//
+//  ChatSDKAssetCache.h
+//  247ChatSDK
+//
+//  Copyright (c) 2014 . All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/*
+ * ChatSDKAssetCache  On-disk copy of the chat app's static assets (JS/CSS/images) listed in a manifest:
+
+                      {"version" : "1.4.2", "assets" : ["js/chat.js", {"url" : "css/chat.css", "type" : "text/css", "hash" : "9f2c..."}]}
+
+                      Asset URLs are relative to the manifest URL. The last complete version is served
+                      from disk, a different manifest version is downloaded in background and replaces it
+                      only once every asset arrived. Assets whose hash did not change are not downloaded again.
+                      cachedResponseForRequest: may be called on any thread.
+ */
+@interface ChatSDKAssetCache : NSObject
+
+// Version being served, nil until one was downloaded
+@property (atomic, readonly, strong) NSString *version;
+
+-(id)initWithManifestURL:(NSURL *)url;
+
+// Restores the version on disk and starts a background refresh
+-(void)load;
+
+// Fetches the manifest with a conditional request, at most every few minutes
+-(void)refresh;
+
+// YES when cachedResponseForRequest: has an answer, without reading the file
+-(BOOL)hasAssetForRequest:(NSURLRequest *)request;
+
+// Response of a GET for a cached asset, nil for anything else
+-(NSCachedURLResponse *)cachedResponseForRequest:(NSURLRequest *)request;
+
+@end
@@ -0,0 +1,305 @@
+//
+//  ChatSDKAssetCache.m
+//  247ChatSDK
+//
+//  Copyright (c) 2014 . All rights reserved.
+//
+
+#import "ChatSDKAssetCache.h"
+
+static NSString *const kIndexManifestURLKey = @"manifestURL";
+static NSString *const kIndexVersionKey = @"version";
+static NSString *const kIndexETagKey = @"etag";
+static NSString *const kIndexDirectoryKey = @"directory";
+static NSString *const kIndexAssetsKey = @"assets";
+
+static NSString *const kAssetFileKey = @"file";
+static NSString *const kAssetTypeKey = @"type";
+static NSString *const kAssetEncodingKey = @"encoding";
+static NSString *const kAssetHashKey = @"hash";
+
+// Least time between two manifest requests
+static const NSTimeInterval kMinimumRefreshInterval = 300;
+
+@interface ChatSDKAssetCache ()
+{
+    NSURL *manifestURL;
+    NSURLSession *session;
+    // Everything below is only touched on cacheQueue
+    dispatch_queue_t cacheQueue;
+    NSDictionary *index;
+    BOOL refreshing;
+    NSDate *lastRefresh;
+}
+@property (atomic, readwrite, strong) NSString *version;
+// absolute URL -> {file : absolute path, type, encoding}, replaced as a whole
+@property (atomic, copy) NSDictionary *entries;
+@end
+
+@implementation ChatSDKAssetCache
+
+@synthesize version = _version;
+@synthesize entries = _entries;
+
+-(id)initWithManifestURL:(NSURL *)url
+{
+    self = [super init];
+    if (self) {
+        manifestURL = url;
+        _entries = [[NSDictionary alloc] init];
+        cacheQueue = dispatch_queue_create("com.inc247.assetCacheQueue", NULL);
+
+        NSURLSessionConfiguration *configuration = [NSURLSessionConfiguration defaultSessionConfiguration];
+        configuration.requestCachePolicy = NSURLRequestReloadIgnoringLocalCacheData;
+        configuration.URLCache = nil;
+        configuration.HTTPMaximumConnectionsPerHost = 4;
+        session = [NSURLSession sessionWithConfiguration:configuration];
+    }
+    return self;
+}
+
+-(void)dealloc
+{
+    [session invalidateAndCancel];
+}
+
+-(void)load
+{
+    dispatch_async(cacheQueue, ^(void) {
+        [self restoreIndex];
+    });
+    [self refresh];
+}
+
+-(void)refresh
+{
+    dispatch_async(cacheQueue, ^(void) {
+        if (manifestURL == nil || refreshing || (lastRefresh && -[lastRefresh timeIntervalSinceNow] < kMinimumRefreshInterval)) {
+            return;
+        }
+        refreshing = YES;
+        lastRefresh = [NSDate date];
+
+        NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:manifestURL cachePolicy:NSURLRequestReloadIgnoringLocalCacheData timeoutInterval:30];
+        NSString *etag = [index objectForKey:kIndexETagKey];
+        if (etag) {
+            [request setValue:etag forHTTPHeaderField:@"If-None-Match"];
+        }
+        [[session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+            dispatch_async(cacheQueue, ^(void) {
+                NSInteger statusCode = [response isKindOfClass:[NSHTTPURLResponse class]] ? [(NSHTTPURLResponse *)response statusCode] : 0;
+                NSDictionary *manifest = nil;
+                if (!error && statusCode == 200 && [data length] > 0) {
+                    manifest = [NSJSONSerialization JSONObjectWithData:data options:kNilOptions error:&error];
+                }
+                if (![manifest isKindOfClass:[NSDictionary class]]) {
+                    // 304 or a failure, the version on disk stays
+                    if (error) {
+                        NSLog(@"Chat asset manifest refresh failed > %@",[error localizedDescription]);
+                    }
+                    refreshing = NO;
+                    return;
+                }
+                [self updateToManifest:manifest etag:[[(NSHTTPURLResponse *)response allHeaderFields] objectForKey:@"ETag"]];
+            });
+        }] resume];
+    });
+}
+
+-(BOOL)hasAssetForRequest:(NSURLRequest *)request
+{
+    NSString *method = [request HTTPMethod];
+    if (method && ![method isEqualToString:@"GET"]) {
+        return NO;
+    }
+    return [self.entries objectForKey:[self keyForURL:[request URL]]] != nil;
+}
+
+-(NSCachedURLResponse *)cachedResponseForRequest:(NSURLRequest *)request
+{
+    NSString *method = [request HTTPMethod];
+    if (method && ![method isEqualToString:@"GET"]) {
+        return nil;
+    }
+    NSDictionary *entry = [self.entries objectForKey:[self keyForURL:[request URL]]];
+    if (entry == nil) {
+        return nil;
+    }
+    NSData *data = [NSData dataWithContentsOfFile:[entry objectForKey:kAssetFileKey] options:NSDataReadingMappedIfSafe error:NULL];
+    if (data == nil) {
+        return nil;
+    }
+
+    NSString *contentType = [entry objectForKey:kAssetTypeKey];
+    if ([entry objectForKey:kAssetEncodingKey]) {
+        contentType = [NSString stringWithFormat:@"%@; charset=%@",contentType,[entry objectForKey:kAssetEncodingKey]];
+    }
+    NSDictionary *headers = @{@"Content-Type" : contentType,
+                              @"Content-Length" : [NSString stringWithFormat:@"%lu",(unsigned long)[data length]],
+                              @"Access-Control-Allow-Origin" : @"*"};
+    NSHTTPURLResponse *response = [[NSHTTPURLResponse alloc] initWithURL:[request URL] statusCode:200 HTTPVersion:@"1.1" headerFields:headers];
+    return [[NSCachedURLResponse alloc] initWithResponse:response data:data userInfo:nil storagePolicy:NSURLCacheStorageNotAllowed];
+}
+
+#pragma mark - Update
+
+// Absolute URL without fragment
+-(NSString *)keyForURL:(NSURL *)url
+{
+    NSString *absoluteString = [url absoluteString];
+    NSRange fragment = [absoluteString rangeOfString:@"#"];
+    return fragment.location == NSNotFound ? absoluteString : [absoluteString substringToIndex:fragment.location];
+}
+
+-(void)updateToManifest:(NSDictionary *)manifest etag:(NSString *)etag
+{
+    NSString *newVersion = [[manifest objectForKey:@"version"] description];
+    NSArray *assets = [manifest objectForKey:@"assets"];
+    if (newVersion == nil || ![assets isKindOfClass:[NSArray class]]) {
+        refreshing = NO;
+        return;
+    }
+    if ([newVersion isEqualToString:[index objectForKey:kIndexVersionKey]]) {
+        NSMutableDictionary *newIndex = [index mutableCopy];
+        if (etag) {
+            [newIndex setObject:etag forKey:kIndexETagKey];
+        }
+        [self saveIndex:newIndex];
+        refreshing = NO;
+        return;
+    }
+
+    NSString *directory = [[NSProcessInfo processInfo] globallyUniqueString];
+    NSString *directoryPath = [[self rootPath] stringByAppendingPathComponent:directory];
+    [[NSFileManager defaultManager] createDirectoryAtPath:directoryPath withIntermediateDirectories:YES attributes:nil error:NULL];
+
+    NSDictionary *oldAssets = [index objectForKey:kIndexAssetsKey];
+    NSString *oldDirectoryPath = [index objectForKey:kIndexDirectoryKey] ? [[self rootPath] stringByAppendingPathComponent:[index objectForKey:kIndexDirectoryKey]] : nil;
+    NSMutableDictionary *newAssets = [NSMutableDictionary dictionaryWithCapacity:[assets count]];
+    __block BOOL failed = NO;
+    dispatch_group_t downloads = dispatch_group_create();
+
+    NSUInteger fileNumber = 0;
+    for (id asset in assets) {
+        NSString *path = [asset isKindOfClass:[NSDictionary class]] ? [asset objectForKey:@"url"] : asset;
+        if (![path isKindOfClass:[NSString class]]) {
+            continue;
+        }
+        NSURL *assetURL = [[NSURL URLWithString:path relativeToURL:manifestURL] absoluteURL];
+        if (assetURL == nil) {
+            continue;
+        }
+        NSString *key = [self keyForURL:assetURL];
+        NSString *file = [NSString stringWithFormat:@"%lu",(unsigned long)fileNumber++];
+        NSString *filePath = [directoryPath stringByAppendingPathComponent:file];
+        NSString *type = [asset isKindOfClass:[NSDictionary class]] ? [asset objectForKey:@"type"] : nil;
+        NSString *hash = [asset isKindOfClass:[NSDictionary class]] ? [asset objectForKey:@"hash"] : nil;
+
+        // An asset of the same hash is taken over from the old version
+        NSDictionary *oldAsset = [oldAssets objectForKey:key];
+        if (hash && oldDirectoryPath && [hash isEqual:[oldAsset objectForKey:kAssetHashKey]]) {
+            NSString *oldFilePath = [oldDirectoryPath stringByAppendingPathComponent:[oldAsset objectForKey:kAssetFileKey]];
+            if ([[NSFileManager defaultManager] copyItemAtPath:oldFilePath toPath:filePath error:NULL]) {
+                NSMutableDictionary *newAsset = [oldAsset mutableCopy];
+                [newAsset setObject:file forKey:kAssetFileKey];
+                [newAssets setObject:newAsset forKey:key];
+                continue;
+            }
+        }
+
+        dispatch_group_enter(downloads);
+        [[session dataTaskWithURL:assetURL completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+            NSInteger statusCode = [response isKindOfClass:[NSHTTPURLResponse class]] ? [(NSHTTPURLResponse *)response statusCode] : 0;
+            BOOL written = !error && statusCode == 200 && data && [data writeToFile:filePath atomically:NO];
+            dispatch_async(cacheQueue, ^(void) {
+                if (!written) {
+                    NSLog(@"Chat asset download failed > %@",assetURL);
+                    failed = YES;
+                } else {
+                    NSMutableDictionary *newAsset = [NSMutableDictionary dictionary];
+                    [newAsset setObject:file forKey:kAssetFileKey];
+                    [newAsset setObject:(type ? type : ([response MIMEType] ? [response MIMEType] : @"application/octet-stream")) forKey:kAssetTypeKey];
+                    if ([response textEncodingName]) {
+                        [newAsset setObject:[response textEncodingName] forKey:kAssetEncodingKey];
+                    }
+                    if (hash) {
+                        [newAsset setObject:hash forKey:kAssetHashKey];
+                    }
+                    [newAssets setObject:newAsset forKey:key];
+                }
+                dispatch_group_leave(downloads);
+            });
+        }] resume];
+    }
+
+    dispatch_group_notify(downloads, cacheQueue, ^(void) {
+        refreshing = NO;
+        if (failed) {
+            // A half downloaded version is never served, the next refresh tries again
+            [[NSFileManager defaultManager] removeItemAtPath:directoryPath error:NULL];
+            lastRefresh = nil;
+            return;
+        }
+        NSMutableDictionary *newIndex = [NSMutableDictionary dictionary];
+        [newIndex setObject:[manifestURL absoluteString] forKey:kIndexManifestURLKey];
+        [newIndex setObject:newVersion forKey:kIndexVersionKey];
+        [newIndex setObject:directory forKey:kIndexDirectoryKey];
+        [newIndex setObject:newAssets forKey:kIndexAssetsKey];
+        if (etag) {
+            [newIndex setObject:etag forKey:kIndexETagKey];
+        }
+        [self saveIndex:newIndex];
+        [self serveIndex:newIndex];
+        if (oldDirectoryPath) {
+            [[NSFileManager defaultManager] removeItemAtPath:oldDirectoryPath error:NULL];
+        }
+    });
+}
+
+#pragma mark - Index
+
+-(NSString *)rootPath
+{
+    NSString *cachesDirectory = [NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES) lastObject];
+    return [cachesDirectory stringByAppendingPathComponent:@"ChatSDKAssets"];
+}
+
+-(NSString *)indexPath
+{
+    return [[self rootPath] stringByAppendingPathComponent:@"index.plist"];
+}
+
+-(void)restoreIndex
+{
+    NSDictionary *savedIndex = [NSDictionary dictionaryWithContentsOfFile:[self indexPath]];
+    // Assets of a different manifest are of no use
+    if (savedIndex == nil || ![[savedIndex objectForKey:kIndexManifestURLKey] isEqualToString:[manifestURL absoluteString]]) {
+        return;
+    }
+    [self serveIndex:savedIndex];
+}
+
+// The caches directory moves with app updates, so files are kept relative to it on disk
+-(void)serveIndex:(NSDictionary *)newIndex
+{
+    index = newIndex;
+    NSString *directoryPath = [[self rootPath] stringByAppendingPathComponent:[newIndex objectForKey:kIndexDirectoryKey]];
+    NSDictionary *assets = [newIndex objectForKey:kIndexAssetsKey];
+    NSMutableDictionary *entries = [NSMutableDictionary dictionaryWithCapacity:[assets count]];
+    for (NSString *key in assets) {
+        NSMutableDictionary *entry = [[assets objectForKey:key] mutableCopy];
+        [entry setObject:[directoryPath stringByAppendingPathComponent:[entry objectForKey:kAssetFileKey]] forKey:kAssetFileKey];
+        [entries setObject:entry forKey:key];
+    }
+    self.entries = entries;
+    self.version = [newIndex objectForKey:kIndexVersionKey];
+}
+
+-(void)saveIndex:(NSDictionary *)newIndex
+{
+    index = newIndex;
+    [[NSFileManager defaultManager] createDirectoryAtPath:[self rootPath] withIntermediateDirectories:YES attributes:nil error:NULL];
+    [newIndex writeToFile:[self indexPath] atomically:YES];
+}
+
+@end
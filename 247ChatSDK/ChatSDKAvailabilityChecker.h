@@ -0,0 +1,68 @@
+//
+//  ChatSDKAvailabilityChecker.h
+//  247ChatSDK
+//
+//  Copyright (c) 2014 . All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+typedef void (^ChatSDKAvailabilityCompletion)(BOOL available, NSError *error);
+typedef void (^ChatSDKAvailabilityChangeHandler)(NSString *queueId, BOOL available);
+typedef void (^ChatSDKBatchAvailabilityCompletion)(NSDictionary *availability, NSError *error);
+
+/*
+ * ChatSDKAvailabilityChecker   Per-queueId cache of agent availability. Callers asking for a
+                                queue that is already being fetched join that request instead of
+                                starting a new one. A stale answer is delivered at once and
+                                revalidated in background; changeHandler reports a changed value.
+                                Requests share one keep-alive NSURLSession and at most
+                                maxConcurrentRequests of them run at the same time.
+                                Each queue has a list of candidate URLs. A failed request fails
+                                over to the next URL; with hedgingEnabled the next URL is also
+                                tried when the first has not answered within its hedgePercentile
+                                latency. The first answer wins and the other request is
+                                cancelled. The endpoint with the lower median latency goes first.
+                                All methods must be called on the main queue and completions are
+                                called on the main queue.
+ */
+@interface ChatSDKAvailabilityChecker : NSObject
+
+// Answers younger than this are served without any request. 0 disables caching. Default 30 sec.
+@property (nonatomic, assign) NSTimeInterval cacheTTL;
+
+// Answers older than cacheTTL but younger than this are served while being revalidated. Default 5 min.
+@property (nonatomic, assign) NSTimeInterval maxStaleAge;
+
+// Requests running in parallel, the rest wait for a free slot. Default 4.
+@property (nonatomic, assign) NSUInteger maxConcurrentRequests;
+
+// Timeout of a single request to one endpoint. Default 10 sec.
+@property (nonatomic, assign) NSTimeInterval requestTimeout;
+
+// Send a second request to the alternate URL when the first is slow. Default NO.
+@property (nonatomic, assign) BOOL hedgingEnabled;
+
+// Latency percentile of the first endpoint after which the hedge is sent, 0...1. Default 0.95.
+@property (nonatomic, assign) double hedgePercentile;
+
+// Called when a background revalidation changed a cached value
+@property (nonatomic, copy) ChatSDKAvailabilityChangeHandler changeHandler;
+
+// Calls completion exactly once, from cache when possible. urls are the candidate endpoints in
+// preferred order.
+-(void)checkAvailabilityForQueue:(NSString *)queueId URLs:(NSArray *)urls completion:(ChatSDKAvailabilityCompletion)completion;
+
+// Checks all queues concurrently, queueURLs maps queueId -> NSArray of URLs. availability maps queueId -> NSNumber(BOOL) for the queues that
+// answered, error is the last failure if any queue could not be checked.
+-(void)checkAvailabilityForQueues:(NSDictionary *)queueURLs completion:(ChatSDKBatchAvailabilityCompletion)completion;
+
+// YES if a cached answer younger than maxStaleAge exists for queueId
+-(BOOL)cachedAvailabilityForQueue:(NSString *)queueId available:(BOOL *)available;
+
+// Stores an answer learned elsewhere, e.g. from an availability subscription
+-(void)storeAvailability:(BOOL)available forQueue:(NSString *)queueId;
+
+-(void)invalidateCache;
+
+@end
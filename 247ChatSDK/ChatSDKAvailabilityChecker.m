@@ -0,0 +1,367 @@
+//
+//  ChatSDKAvailabilityChecker.m
+//  247ChatSDK
+//
+//  Copyright (c) 2014 . All rights reserved.
+//
+
+#import "ChatSDKAvailabilityChecker.h"
+#import "ChatSDKLatencyStats.h"
+
+static NSString *const kCachedAvailableKey = @"available";
+static NSString *const kCachedDateKey = @"date";
+
+// Samples needed before an endpoint's latency is trusted for ordering and hedging
+static const NSUInteger kMinLatencySamples = 5;
+// Hedge delay used until the primary endpoint has enough samples
+static const NSTimeInterval kDefaultHedgeDelay = 1.0;
+static const NSTimeInterval kMinHedgeDelay = 0.05;
+
+// One availability fetch of a queue, possibly spread over several endpoints
+@interface ChatSDKAvailabilityFetch : NSObject
+@property (nonatomic, strong) NSString *key;
+@property (nonatomic, strong) NSArray *URLs;
+@property (nonatomic, assign) NSUInteger nextIndex;
+@property (nonatomic, assign) NSUInteger running;
+@property (nonatomic, assign) BOOL finished;
+@property (nonatomic, strong) NSMutableArray *tasks;
+@end
+
+@implementation ChatSDKAvailabilityFetch
+@end
+
+@interface ChatSDKAvailabilityChecker ()
+{
+    NSURLSession *session;
+    // Fetches waiting for a free slot, see maxConcurrentRequests
+    NSMutableArray *pendingFetches;
+    NSUInteger activeFetches;
+    // queueId -> { available, date }
+    NSMutableDictionary *cache;
+    // queueId -> NSMutableArray of ChatSDKAvailabilityCompletion waiting for the same request
+    NSMutableDictionary *inFlight;
+    // endpoint (lowercase host & port of a checkAvailability URL) -> ChatSDKLatencyStats. The URLs carry the
+    // queueId, keyed by URL the stats would grow with every queue checked
+    NSMutableDictionary *endpointStats;
+}
+@end
+
+@implementation ChatSDKAvailabilityChecker
+
+@synthesize cacheTTL = _cacheTTL;
+@synthesize maxStaleAge = _maxStaleAge;
+@synthesize changeHandler = _changeHandler;
+@synthesize maxConcurrentRequests = _maxConcurrentRequests;
+@synthesize requestTimeout = _requestTimeout;
+@synthesize hedgingEnabled = _hedgingEnabled;
+@synthesize hedgePercentile = _hedgePercentile;
+
+-(id)init
+{
+    self = [super init];
+    if (self) {
+        cache = [[NSMutableDictionary alloc] init];
+        inFlight = [[NSMutableDictionary alloc] init];
+        pendingFetches = [[NSMutableArray alloc] init];
+        endpointStats = [[NSMutableDictionary alloc] init];
+        _cacheTTL = 30;
+        _maxStaleAge = 300;
+        _maxConcurrentRequests = 4;
+        _requestTimeout = 10;
+        _hedgePercentile = 0.95;
+
+        // One session keeps connections to the CA servers alive between checks.
+        // We cache answers ourselves, so the URL cache (the chat bridge while chat is open) is bypassed.
+        NSURLSessionConfiguration *configuration = [NSURLSessionConfiguration defaultSessionConfiguration];
+        configuration.HTTPMaximumConnectionsPerHost = _maxConcurrentRequests;
+        configuration.requestCachePolicy = NSURLRequestReloadIgnoringLocalCacheData;
+        configuration.URLCache = nil;
+        session = [NSURLSession sessionWithConfiguration:configuration];
+    }
+    return self;
+}
+
+-(void)dealloc
+{
+    [session invalidateAndCancel];
+}
+
+-(NSString *)keyForQueue:(NSString *)queueId
+{
+    return queueId ? queueId : @"";
+}
+
+-(BOOL)cachedAvailabilityForQueue:(NSString *)queueId available:(BOOL *)available
+{
+    NSDictionary *entry = [cache objectForKey:[self keyForQueue:queueId]];
+    if (entry == nil || _cacheTTL <= 0) {
+        return NO;
+    }
+    NSTimeInterval age = -[[entry objectForKey:kCachedDateKey] timeIntervalSinceNow];
+    if (age > MAX(_maxStaleAge, _cacheTTL)) {
+        return NO;
+    }
+    if (available) {
+        *available = [[entry objectForKey:kCachedAvailableKey] boolValue];
+    }
+    return YES;
+}
+
+-(void)checkAvailabilityForQueue:(NSString *)queueId URLs:(NSArray *)urls completion:(ChatSDKAvailabilityCompletion)completion
+{
+    NSString *key = [self keyForQueue:queueId];
+    NSDictionary *entry = [cache objectForKey:key];
+    BOOL cachedValue = NO;
+
+    if ([self cachedAvailabilityForQueue:queueId available:&cachedValue]) {
+        NSTimeInterval age = -[[entry objectForKey:kCachedDateKey] timeIntervalSinceNow];
+        if (completion) {
+            dispatch_async(dispatch_get_main_queue(), ^(void) {
+                completion(cachedValue, nil);
+            });
+        }
+        if (age > _cacheTTL) {
+            // stale-while-revalidate, changeHandler reports a different answer
+            [self fetchQueue:key URLs:urls completion:nil];
+        }
+        return;
+    }
+
+    [self fetchQueue:key URLs:urls completion:completion];
+}
+
+-(void)checkAvailabilityForQueues:(NSDictionary *)queueURLs completion:(ChatSDKBatchAvailabilityCompletion)completion
+{
+    NSMutableDictionary *availability = [[NSMutableDictionary alloc] init];
+    __block NSError *lastError = nil;
+    __block NSUInteger remaining = [queueURLs count];
+
+    if (remaining == 0) {
+        if (completion) {
+            dispatch_async(dispatch_get_main_queue(), ^(void) {
+                completion(availability, nil);
+            });
+        }
+        return;
+    }
+
+    // Every queue goes through the cache and the in-flight table, the fetches run in parallel
+    for (NSString *queueId in queueURLs) {
+        [self checkAvailabilityForQueue:queueId URLs:[queueURLs objectForKey:queueId] completion:^(BOOL available, NSError *error) {
+            if (error) {
+                lastError = error;
+            } else {
+                [availability setObject:[NSNumber numberWithBool:available] forKey:queueId];
+            }
+            if (--remaining == 0 && completion) {
+                completion(availability, lastError);
+            }
+        }];
+    }
+}
+
+-(void)storeAvailability:(BOOL)available forQueue:(NSString *)queueId
+{
+    [cache setObject:@{ kCachedAvailableKey : [NSNumber numberWithBool:available], kCachedDateKey : [NSDate date] } forKey:[self keyForQueue:queueId]];
+}
+
+-(void)invalidateCache
+{
+    [cache removeAllObjects];
+}
+
+-(void)fetchQueue:(NSString *)key URLs:(NSArray *)urls completion:(ChatSDKAvailabilityCompletion)completion
+{
+    NSMutableArray *waiting = [inFlight objectForKey:key];
+    if (waiting) {
+        // Join the request already running for this queue
+        if (completion) {
+            [waiting addObject:[completion copy]];
+        }
+        return;
+    }
+    waiting = [[NSMutableArray alloc] init];
+    if (completion) {
+        [waiting addObject:[completion copy]];
+    }
+    [inFlight setObject:waiting forKey:key];
+
+    ChatSDKAvailabilityFetch *fetch = [[ChatSDKAvailabilityFetch alloc] init];
+    fetch.key = key;
+    fetch.URLs = [self orderedEndpoints:urls];
+    fetch.tasks = [[NSMutableArray alloc] init];
+    [pendingFetches addObject:fetch];
+    [self startPendingFetches];
+}
+
+-(void)startPendingFetches
+{
+    while (activeFetches < MAX(_maxConcurrentRequests, 1) && [pendingFetches count] > 0) {
+        ChatSDKAvailabilityFetch *fetch = [pendingFetches objectAtIndex:0];
+        [pendingFetches removeObjectAtIndex:0];
+        activeFetches++;
+        [self launchNextAttempt:fetch];
+    }
+}
+
+#pragma mark - Endpoints
+
+// Host of url with its port if any, url itself when it has none
++(NSString *)endpointOfURL:(NSString *)url
+{
+    NSURL *parsed = [NSURL URLWithString:url];
+    NSString *host = [[parsed host] lowercaseString];
+    if (host == nil) {
+        return url;
+    }
+    return [parsed port] ? [NSString stringWithFormat:@"%@:%@", host, [parsed port]] : host;
+}
+
+-(ChatSDKLatencyStats *)statsForURL:(NSString *)url
+{
+    NSString *endpoint = [ChatSDKAvailabilityChecker endpointOfURL:url];
+    ChatSDKLatencyStats *stats = [endpointStats objectForKey:endpoint];
+    if (stats == nil) {
+        stats = [[ChatSDKLatencyStats alloc] initWithWindowSize:64];
+        [endpointStats setObject:stats forKey:endpoint];
+    }
+    return stats;
+}
+
+// Faster endpoint (by median) first once both have enough samples, otherwise the given order
+-(NSArray *)orderedEndpoints:(NSArray *)urls
+{
+    return [urls sortedArrayWithOptions:NSSortStable usingComparator:^NSComparisonResult(NSString *first, NSString *second) {
+        ChatSDKLatencyStats *firstStats = [self statsForURL:first];
+        ChatSDKLatencyStats *secondStats = [self statsForURL:second];
+        if (firstStats.count < kMinLatencySamples || secondStats.count < kMinLatencySamples) {
+            return NSOrderedSame;
+        }
+        NSTimeInterval firstMedian = [firstStats latencyAtPercentile:0.5];
+        NSTimeInterval secondMedian = [secondStats latencyAtPercentile:0.5];
+        if (firstMedian < secondMedian) {
+            return NSOrderedAscending;
+        }
+        return firstMedian > secondMedian ? NSOrderedDescending : NSOrderedSame;
+    }];
+}
+
+-(NSTimeInterval)hedgeDelayForURL:(NSString *)url
+{
+    ChatSDKLatencyStats *stats = [self statsForURL:url];
+    NSTimeInterval delay = kDefaultHedgeDelay;
+    if (stats.count >= kMinLatencySamples) {
+        delay = [stats latencyAtPercentile:_hedgePercentile];
+    }
+    return MIN(MAX(delay, kMinHedgeDelay), _requestTimeout);
+}
+
+#pragma mark - Attempts
+
+// Sends the fetch to its next endpoint. With hedging on, the endpoint after it is tried as
+// well if no answer came within the primary's percentile latency. A failure moves on at once.
+-(void)launchNextAttempt:(ChatSDKAvailabilityFetch *)fetch
+{
+    if (fetch.finished) {
+        return;
+    }
+    if (fetch.nextIndex >= [fetch.URLs count]) {
+        if (fetch.running == 0) {
+            NSError *error = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorBadURL userInfo:nil];
+            [self completeFetch:fetch available:NO error:error];
+        }
+        return;
+    }
+
+    NSString *url = [fetch.URLs objectAtIndex:fetch.nextIndex];
+    fetch.nextIndex++;
+
+    NSURL *requestURL = [NSURL URLWithString:url];
+    if (requestURL == nil) {
+        [self launchNextAttempt:fetch];
+        return;
+    }
+
+    NSURLRequest *request = [NSURLRequest requestWithURL:requestURL cachePolicy:NSURLRequestReloadIgnoringLocalCacheData timeoutInterval:_requestTimeout];
+    NSDate *startDate = [NSDate date];
+    ChatSDKLatencyStats *stats = [self statsForURL:url];
+
+    NSURLSessionDataTask *task = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+        BOOL available = NO;
+        if (!error) {
+            NSDictionary *json = [NSJSONSerialization JSONObjectWithData:data options:kNilOptions error:&error];
+            NSDictionary *dataDictionary = [json objectForKey:@"data"];
+            available = [[dataDictionary objectForKey:@"caStatus"] boolValue];
+        }
+        NSTimeInterval latency = -[startDate timeIntervalSinceNow];
+        dispatch_async(dispatch_get_main_queue(), ^(void) {
+            fetch.running--;
+            // The loser of a hedge is cancelled, that says nothing about its endpoint
+            if ([error code] != NSURLErrorCancelled) {
+                [stats addSample:latency];
+            }
+            if (fetch.finished) {
+                return;
+            }
+            if (!error) {
+                [self completeFetch:fetch available:available error:nil];
+            } else if (fetch.nextIndex < [fetch.URLs count]) {
+                // Failover to the next endpoint
+                [self launchNextAttempt:fetch];
+            } else if (fetch.running == 0) {
+                [self completeFetch:fetch available:NO error:error];
+            }
+        });
+    }];
+    fetch.running++;
+    [fetch.tasks addObject:task];
+    [task resume];
+
+    if (_hedgingEnabled && fetch.nextIndex < [fetch.URLs count]) {
+        NSUInteger hedgeIndex = fetch.nextIndex;
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)([self hedgeDelayForURL:url] * NSEC_PER_SEC)), dispatch_get_main_queue(), ^(void) {
+            // Still waiting and no failover happened meanwhile
+            if (!fetch.finished && fetch.nextIndex == hedgeIndex) {
+                [self launchNextAttempt:fetch];
+            }
+        });
+    }
+}
+
+-(void)completeFetch:(ChatSDKAvailabilityFetch *)fetch available:(BOOL)available error:(NSError *)error
+{
+    fetch.finished = YES;
+    // First answer wins, the other endpoint's request is cancelled
+    for (NSURLSessionDataTask *task in fetch.tasks) {
+        if ([task state] == NSURLSessionTaskStateRunning) {
+            [task cancel];
+        }
+    }
+    [fetch.tasks removeAllObjects];
+
+    activeFetches--;
+    [self finishQueue:fetch.key available:available error:error];
+    [self startPendingFetches];
+}
+
+-(void)finishQueue:(NSString *)key available:(BOOL)available error:(NSError *)error
+{
+    NSArray *waiting = [inFlight objectForKey:key];
+    [inFlight removeObjectForKey:key];
+
+    if (!error) {
+        NSDictionary *previous = [cache objectForKey:key];
+        [cache setObject:@{ kCachedAvailableKey : [NSNumber numberWithBool:available], kCachedDateKey : [NSDate date] } forKey:key];
+
+        // Only revalidations without a waiting caller report through changeHandler
+        if (previous && [waiting count] == 0 && [[previous objectForKey:kCachedAvailableKey] boolValue] != available && _changeHandler) {
+            _changeHandler(key, available);
+        }
+    }
+
+    for (ChatSDKAvailabilityCompletion completion in waiting) {
+        completion(available, error);
+    }
+}
+
+@end
@@ -0,0 +1,49 @@
+//
+//  ChatSDKAvailabilitySubscriber.h
+//  247ChatSDK
+//
+//  Copyright (c) 2014 . All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+typedef NSArray *(^ChatSDKAvailabilityURLProvider)(NSString *queueId);
+typedef void (^ChatSDKAvailabilityUpdateHandler)(NSString *queueId, BOOL available);
+
+/*
+ * ChatSDKAvailabilitySubscriber  Keeps one long-poll request per subscribed queue open against the
+                                  checkAvailability URL and reports only changed answers. The request
+                                  carries longPoll=<seconds>&caStatus=<last answer> so the CA server
+                                  can hold it until the status differs. A server that answers at
+                                  once is polled at most every minimumInterval seconds instead.
+                                  All methods must be called on the main queue and updateHandler is
+                                  called on the main queue.
+ */
+@interface ChatSDKAvailabilitySubscriber : NSObject
+
+// Seconds the server may hold a request. Default 60.
+@property (nonatomic, assign) NSTimeInterval longPollTimeout;
+
+// Least time between two requests of a queue when the server does not hold them. Default 15.
+@property (nonatomic, assign) NSTimeInterval minimumInterval;
+
+// Retry delay after the first failed request, doubled for each further one up to 300 seconds. Default 1.
+@property (nonatomic, assign) NSTimeInterval initialRetryDelay;
+
+// Called with the first answer and then each time the answer changes
+@property (nonatomic, copy) ChatSDKAvailabilityUpdateHandler updateHandler;
+
+// urlProvider returns the candidate checkAvailability URLs of a queue, the first one is used
+-(id)initWithURLProvider:(ChatSDKAvailabilityURLProvider)urlProvider;
+// configuration of the NSURLSession of the requests, e.g. with protocolClasses of a stand-in server
+-(id)initWithURLProvider:(ChatSDKAvailabilityURLProvider)urlProvider sessionConfiguration:(NSURLSessionConfiguration *)configuration;
+
+-(void)subscribeToQueue:(NSString *)queueId;
+-(void)unsubscribeFromQueue:(NSString *)queueId;
+-(void)unsubscribeAll;
+
+// Cancels the open requests but keeps the subscriptions, e.g. while the app is in background
+-(void)pause;
+-(void)resume;
+
+@end
@@ -0,0 +1,196 @@
+//
+//  ChatSDKAvailabilitySubscriber.m
+//  247ChatSDK
+//
+//  Copyright (c) 2014 . All rights reserved.
+//
+
+#import "ChatSDKAvailabilitySubscriber.h"
+
+// Retry delay after a failed request doubles up to this
+static const NSTimeInterval kMaxRetryDelay = 300;
+
+@interface ChatSDKAvailabilitySubscription : NSObject
+@property (nonatomic, strong) NSString *queueId;
+@property (nonatomic, strong) NSNumber *lastAvailable;
+@property (nonatomic, strong) NSURLSessionDataTask *task;
+@property (nonatomic, assign) NSTimeInterval retryDelay;
+// Bumped on pause/unsubscribe so late callbacks of an old request are dropped
+@property (nonatomic, assign) NSUInteger generation;
+@end
+
+@implementation ChatSDKAvailabilitySubscription
+@end
+
+@interface ChatSDKAvailabilitySubscriber ()
+{
+    NSURLSession *session;
+    ChatSDKAvailabilityURLProvider provider;
+    // queueId -> ChatSDKAvailabilitySubscription
+    NSMutableDictionary *subscriptions;
+    BOOL paused;
+}
+@end
+
+@implementation ChatSDKAvailabilitySubscriber
+
+@synthesize longPollTimeout = _longPollTimeout;
+@synthesize minimumInterval = _minimumInterval;
+@synthesize initialRetryDelay = _initialRetryDelay;
+@synthesize updateHandler = _updateHandler;
+
+-(id)initWithURLProvider:(ChatSDKAvailabilityURLProvider)urlProvider
+{
+    return [self initWithURLProvider:urlProvider sessionConfiguration:[NSURLSessionConfiguration defaultSessionConfiguration]];
+}
+
+-(id)initWithURLProvider:(ChatSDKAvailabilityURLProvider)urlProvider sessionConfiguration:(NSURLSessionConfiguration *)configuration
+{
+    self = [super init];
+    if (self) {
+        provider = [urlProvider copy];
+        subscriptions = [[NSMutableDictionary alloc] init];
+        _longPollTimeout = 60;
+        _minimumInterval = 15;
+        _initialRetryDelay = 1;
+
+        configuration.requestCachePolicy = NSURLRequestReloadIgnoringLocalCacheData;
+        configuration.URLCache = nil;
+        session = [NSURLSession sessionWithConfiguration:configuration];
+    }
+    return self;
+}
+
+-(void)dealloc
+{
+    [session invalidateAndCancel];
+}
+
+-(void)subscribeToQueue:(NSString *)queueId
+{
+    NSString *key = queueId ? queueId : @"";
+    if ([subscriptions objectForKey:key]) {
+        return;
+    }
+    ChatSDKAvailabilitySubscription *subscription = [[ChatSDKAvailabilitySubscription alloc] init];
+    subscription.queueId = queueId;
+    [subscriptions setObject:subscription forKey:key];
+    if (!paused) {
+        [self poll:subscription];
+    }
+}
+
+-(void)unsubscribeFromQueue:(NSString *)queueId
+{
+    NSString *key = queueId ? queueId : @"";
+    ChatSDKAvailabilitySubscription *subscription = [subscriptions objectForKey:key];
+    [self stop:subscription];
+    [subscriptions removeObjectForKey:key];
+}
+
+-(void)unsubscribeAll
+{
+    for (ChatSDKAvailabilitySubscription *subscription in [subscriptions allValues]) {
+        [self stop:subscription];
+    }
+    [subscriptions removeAllObjects];
+}
+
+-(void)pause
+{
+    paused = YES;
+    for (ChatSDKAvailabilitySubscription *subscription in [subscriptions allValues]) {
+        [self stop:subscription];
+    }
+}
+
+-(void)resume
+{
+    if (!paused) {
+        return;
+    }
+    paused = NO;
+    for (ChatSDKAvailabilitySubscription *subscription in [subscriptions allValues]) {
+        subscription.retryDelay = 0;
+        [self poll:subscription];
+    }
+}
+
+-(void)stop:(ChatSDKAvailabilitySubscription *)subscription
+{
+    subscription.generation++;
+    [subscription.task cancel];
+    subscription.task = nil;
+}
+
+-(NSURL *)longPollURLFor:(ChatSDKAvailabilitySubscription *)subscription
+{
+    NSString *url = [provider(subscription.queueId) firstObject];
+    if (url == nil) {
+        return nil;
+    }
+    NSString *separator = [url rangeOfString:@"?"].location == NSNotFound ? @"?" : @"&";
+    NSMutableString *longPollURL = [NSMutableString stringWithFormat:@"%@%@longPoll=%d",url,separator,(int)_longPollTimeout];
+    if (subscription.lastAvailable) {
+        [longPollURL appendFormat:@"&caStatus=%@",[subscription.lastAvailable boolValue] ? @"true" : @"false"];
+    }
+    return [NSURL URLWithString:longPollURL];
+}
+
+-(void)poll:(ChatSDKAvailabilitySubscription *)subscription
+{
+    NSURL *url = [self longPollURLFor:subscription];
+    if (url == nil) {
+        return;
+    }
+    NSUInteger generation = subscription.generation;
+    NSDate *startDate = [NSDate date];
+    NSURLRequest *request = [NSURLRequest requestWithURL:url cachePolicy:NSURLRequestReloadIgnoringLocalCacheData timeoutInterval:_longPollTimeout + 10];
+
+    subscription.task = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+        NSNumber *available = nil;
+        if (!error) {
+            NSDictionary *json = [NSJSONSerialization JSONObjectWithData:data options:kNilOptions error:&error];
+            id caStatus = [[json objectForKey:@"data"] objectForKey:@"caStatus"];
+            if (caStatus) {
+                available = [NSNumber numberWithBool:[caStatus boolValue]];
+            }
+        }
+        dispatch_async(dispatch_get_main_queue(), ^(void) {
+            if (subscription.generation != generation) {
+                return;
+            }
+            subscription.task = nil;
+            [self subscription:subscription received:available after:-[startDate timeIntervalSinceNow]];
+        });
+    }];
+    [subscription.task resume];
+}
+
+-(void)subscription:(ChatSDKAvailabilitySubscription *)subscription received:(NSNumber *)available after:(NSTimeInterval)elapsed
+{
+    NSTimeInterval delay = 0;
+    if (available == nil) {
+        subscription.retryDelay = subscription.retryDelay > 0 ? MIN(subscription.retryDelay * 2, kMaxRetryDelay) : _initialRetryDelay;
+        delay = subscription.retryDelay;
+    } else {
+        subscription.retryDelay = 0;
+        if (subscription.lastAvailable == nil || ![subscription.lastAvailable isEqualToNumber:available]) {
+            subscription.lastAvailable = available;
+            if (_updateHandler) {
+                _updateHandler(subscription.queueId, [available boolValue]);
+            }
+        }
+        // A server without long-poll support answers at once, do not hammer it
+        delay = MAX(_minimumInterval - elapsed, 0);
+    }
+
+    NSUInteger generation = subscription.generation;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), dispatch_get_main_queue(), ^(void) {
+        if (subscription.generation == generation && !paused) {
+            [self poll:subscription];
+        }
+    });
+}
+
+@end
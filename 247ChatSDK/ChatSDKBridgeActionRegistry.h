@@ -0,0 +1,52 @@
+//
+//  ChatSDKBridgeActionRegistry.h
+//  247ChatSDK
+//
+//  Copyright (c) 2014 . All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+@class ChatSDKBridgeAction;
+
+// Returns the "data" of the response, nil when the call gets no response
+typedef NSDictionary *(^ChatSDKBridgeActionHandler)(ChatSDKBridgeAction *action, NSError **error);
+
+typedef void (^ChatSDKBridgeActionCompletion)(NSDictionary *data, NSError *error);
+// Calls completion once, on any queue, when the result is known
+typedef void (^ChatSDKBridgeAsyncActionHandler)(ChatSDKBridgeAction *action, ChatSDKBridgeActionCompletion completion);
+
+/*
+ * ChatSDKBridgeActionRegistry  Maps chat_exec action names to handler blocks and wraps their data
+                                in the {result, action, id, data} envelope Bridge.js expects.
+                                Lookups may run on any thread, registration is copy-on-write.
+ */
+@interface ChatSDKBridgeActionRegistry : NSObject
+
+// Delivers the envelope of an async action on main queue, e.g. to window.NativeBridge._complete
+@property (nonatomic, copy) void (^asyncCompletionHandler)(NSDictionary *envelope);
+
+// Asked for the actions this registry does not know, async results still go to this registry's asyncCompletionHandler
+@property (atomic, strong) ChatSDKBridgeActionRegistry *fallbackRegistry;
+
+// Replaces any handler of the same name, names are case insensitive like ChatSDKBridgeAction
+-(void)registerAction:(NSString *)name handler:(ChatSDKBridgeActionHandler)handler;
+
+// The call is answered at once with the "ignore" envelope and completed through asyncCompletionHandler
+-(void)registerAction:(NSString *)name asyncHandler:(ChatSDKBridgeAsyncActionHandler)handler;
+
+-(void)removeAction:(NSString *)name;
+-(BOOL)hasAction:(NSString *)name;
+
+// Envelope to return for action, nil for an unknown action or no response
+-(NSDictionary *)executeAction:(ChatSDKBridgeAction *)action error:(NSError **)error;
+
+// Like executeAction:error: but completes async actions through completionRegistry's asyncCompletionHandler
+-(NSDictionary *)executeAction:(ChatSDKBridgeAction *)action completingThrough:(ChatSDKBridgeActionRegistry *)completionRegistry error:(NSError **)error;
+
++(NSDictionary *)envelopeForCallId:(id)callId data:(NSDictionary *)data;
+
+// The answer of an async action, its result comes later through asyncCompletionHandler
++(BOOL)isIgnoreEnvelope:(NSDictionary *)envelope;
+
+@end
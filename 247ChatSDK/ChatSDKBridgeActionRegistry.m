@@ -0,0 +1,152 @@
+//
+//  ChatSDKBridgeActionRegistry.m
+//  247ChatSDK
+//
+//  Copyright (c) 2014 . All rights reserved.
+//
+
+#import "ChatSDKBridgeActionRegistry.h"
+#import "ChatSDKBridgeAction.h"
+#import "ChatSDKBridgeMetrics.h"
+
+@interface ChatSDKBridgeActionRegistry ()
+// action name -> handler block, replaced as a whole on registration
+@property (atomic, copy) NSDictionary *syncHandlers;
+@property (atomic, copy) NSDictionary *asyncHandlers;
+@end
+
+@implementation ChatSDKBridgeActionRegistry
+
+@synthesize asyncCompletionHandler = _asyncCompletionHandler;
+@synthesize syncHandlers = _syncHandlers;
+@synthesize asyncHandlers = _asyncHandlers;
+@synthesize fallbackRegistry = _fallbackRegistry;
+
+-(id)init
+{
+    self = [super init];
+    if (self) {
+        _syncHandlers = [[NSDictionary alloc] init];
+        _asyncHandlers = [[NSDictionary alloc] init];
+    }
+    return self;
+}
+
+-(void)registerAction:(NSString *)name handler:(ChatSDKBridgeActionHandler)handler
+{
+    @synchronized(self) {
+        NSString *key = [name lowercaseString];
+        [self removeAction:key];
+        NSMutableDictionary *handlers = [self.syncHandlers mutableCopy];
+        [handlers setObject:[handler copy] forKey:key];
+        self.syncHandlers = handlers;
+    }
+}
+
+-(void)registerAction:(NSString *)name asyncHandler:(ChatSDKBridgeAsyncActionHandler)handler
+{
+    @synchronized(self) {
+        NSString *key = [name lowercaseString];
+        [self removeAction:key];
+        NSMutableDictionary *handlers = [self.asyncHandlers mutableCopy];
+        [handlers setObject:[handler copy] forKey:key];
+        self.asyncHandlers = handlers;
+    }
+}
+
+-(void)removeAction:(NSString *)name
+{
+    @synchronized(self) {
+        NSString *key = [name lowercaseString];
+        if ([self.syncHandlers objectForKey:key]) {
+            NSMutableDictionary *handlers = [self.syncHandlers mutableCopy];
+            [handlers removeObjectForKey:key];
+            self.syncHandlers = handlers;
+        }
+        if ([self.asyncHandlers objectForKey:key]) {
+            NSMutableDictionary *handlers = [self.asyncHandlers mutableCopy];
+            [handlers removeObjectForKey:key];
+            self.asyncHandlers = handlers;
+        }
+    }
+}
+
+-(BOOL)hasAction:(NSString *)name
+{
+    NSString *key = [name lowercaseString];
+    return [self.syncHandlers objectForKey:key] != nil || [self.asyncHandlers objectForKey:key] != nil;
+}
+
+-(NSDictionary *)executeAction:(ChatSDKBridgeAction *)action error:(NSError **)error
+{
+    return [self executeAction:action completingThrough:self error:error];
+}
+
+-(NSDictionary *)executeAction:(ChatSDKBridgeAction *)action completingThrough:(ChatSDKBridgeActionRegistry *)completionRegistry error:(NSError **)error
+{
+    if (action.action == nil) {
+        return nil;
+    }
+    id callId = [action.params objectForKey:@"id"];
+
+    ChatSDKBridgeActionHandler handler = [self.syncHandlers objectForKey:action.action];
+    if (handler) {
+        NSDictionary *data = handler(action, error);
+        return data ? [ChatSDKBridgeActionRegistry envelopeForCallId:callId data:data] : nil;
+    }
+
+    ChatSDKBridgeAsyncActionHandler asyncHandler = [self.asyncHandlers objectForKey:action.action];
+    if (asyncHandler) {
+        __weak ChatSDKBridgeActionRegistry *weakSelf = completionRegistry;
+        NSString *actionName = action.action;
+        NSTimeInterval startTime = [NSDate timeIntervalSinceReferenceDate];
+        asyncHandler(action, ^(NSDictionary *data, NSError *asyncError) {
+            // The only record of an async call, its "ignore" answer is not recorded. Until the result is on its way to window.NativeBridge._complete
+            NSTimeInterval time = [NSDate timeIntervalSinceReferenceDate] - startTime;
+            [[ChatSDKBridgeMetrics sharedMetrics] recordAction:actionName nativeTime:time failed:(asyncError != nil)];
+            [[ChatSDKBridgeMetrics sharedMetrics] recordAction:actionName bridgeTime:time requestBytes:0 responseBytes:0];
+            NSMutableDictionary *envelope = [[ChatSDKBridgeActionRegistry envelopeForCallId:callId data:data] mutableCopy];
+            if (asyncError) {
+                [envelope setObject:@{ @"code" : [NSNumber numberWithInteger:asyncError.code], @"message" : [asyncError localizedDescription] } forKey:@"error"];
+            }
+            dispatch_async(dispatch_get_main_queue(), ^{
+                void (^completionHandler)(NSDictionary *) = weakSelf.asyncCompletionHandler;
+                if (completionHandler) {
+                    completionHandler(envelope);
+                }
+            });
+        });
+        // Bridge.js waits for window.NativeBridge._complete of this id
+        return [ChatSDKBridgeActionRegistry envelopeForCallId:nil data:@{ @"ignore" : [NSNumber numberWithBool:true] }];
+    }
+
+    ChatSDKBridgeActionRegistry *fallback = self.fallbackRegistry;
+    if (fallback) {
+        return [fallback executeAction:action completingThrough:completionRegistry error:error];
+    }
+
+    NSLog(@"No native handler for action %@",action.action);
+    return nil;
+}
+
++(BOOL)isIgnoreEnvelope:(NSDictionary *)envelope
+{
+    id data = [envelope objectForKey:@"data"];
+    return [data isKindOfClass:[NSDictionary class]] && [data objectForKey:@"ignore"]!=nil;
+}
+
++(NSDictionary *)envelopeForCallId:(id)callId data:(NSDictionary *)data
+{
+    NSMutableDictionary *envelope = [NSMutableDictionary dictionaryWithCapacity:4];
+    [envelope setObject:[NSNumber numberWithBool:true] forKey:@"result"];
+    [envelope setObject:[NSNumber numberWithBool:true] forKey:@"action"];
+    if (callId) {
+        [envelope setObject:callId forKey:@"id"];
+    }
+    if (data) {
+        [envelope setObject:data forKey:@"data"];
+    }
+    return envelope;
+}
+
+@end
@@ -0,0 +1,30 @@
+//
+//  ChatSDKBridgeCodec.h
+//  247ChatSDK
+//
+//  Copyright (c) 2014 . All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+// Kind of a chat_exec URL
+typedef enum {
+    ChatSDKBridgeURLNone,
+    // /!chat_exec/<action>?<params>
+    ChatSDKBridgeURLCall,
+    // /!chat_exec_batch/?<[{action, id, params}]>
+    ChatSDKBridgeURLBatch
+}ChatSDKBridgeURLKind;
+
+// Decoding of bridge requests & encoding of their responses, Foundation only
+@interface ChatSDKBridgeCodec : NSObject
+
++(ChatSDKBridgeURLKind)kindOfURL:(NSURL *)url;
+
+// Percent-decodes the query bytes in one pass into one buffer and parses the JSON in it. nil on bad input.
++(id)JSONObjectWithPercentEncodedQuery:(NSString *)query;
+
+// Compact JSON, nil if object is not serializable
++(NSData *)dataWithJSONObject:(id)object;
+
+@end
@@ -0,0 +1,84 @@
+//
+//  ChatSDKBridgeCodec.m
+//  247ChatSDK
+//
+//  Copyright (c) 2014 . All rights reserved.
+//
+
+#import "ChatSDKBridgeCodec.h"
+
+static inline int hexValue(unsigned char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+@implementation ChatSDKBridgeCodec
+
++(ChatSDKBridgeURLKind)kindOfURL:(NSURL *)url
+{
+    // One search covers both paths, "/!chat_exec" is followed by "/" or "_batch/"
+    NSString *absoluteString = [url absoluteString];
+    NSRange range = [absoluteString rangeOfString:@"/!chat_exec"];
+    if (range.location == NSNotFound) {
+        return ChatSDKBridgeURLNone;
+    }
+    NSUInteger next = NSMaxRange(range);
+    if (next < [absoluteString length] && [absoluteString characterAtIndex:next] == '/') {
+        return ChatSDKBridgeURLCall;
+    }
+    if ([absoluteString rangeOfString:@"_batch/" options:NSAnchoredSearch range:NSMakeRange(next, [absoluteString length] - next)].location != NSNotFound) {
+        return ChatSDKBridgeURLBatch;
+    }
+    return ChatSDKBridgeURLNone;
+}
+
++(id)JSONObjectWithPercentEncodedQuery:(NSString *)query
+{
+    NSUInteger length = [query length];
+    if (length == 0) {
+        return nil;
+    }
+    // A percent-encoded query is ASCII, room for 3 UTF-8 bytes per character covers anything else
+    NSUInteger capacity = length * 3;
+    unsigned char *bytes = malloc(capacity);
+    if (bytes == NULL) {
+        return nil;
+    }
+    NSUInteger usedLength = 0;
+    if (![query getBytes:bytes maxLength:capacity usedLength:&usedLength encoding:NSUTF8StringEncoding options:0 range:NSMakeRange(0, length) remainingRange:NULL]) {
+        free(bytes);
+        return nil;
+    }
+
+    // Decoding in place, out never passes in
+    NSUInteger out = 0;
+    for (NSUInteger in = 0; in < usedLength; in++) {
+        unsigned char c = bytes[in];
+        if (c == '%' && in + 2 < usedLength) {
+            int high = hexValue(bytes[in + 1]);
+            int low = hexValue(bytes[in + 2]);
+            if (high >= 0 && low >= 0) {
+                bytes[out++] = (unsigned char)((high << 4) | low);
+                in += 2;
+                continue;
+            }
+        }
+        bytes[out++] = c;
+    }
+
+    NSData *data = [[NSData alloc] initWithBytesNoCopy:bytes length:out freeWhenDone:YES];
+    return [NSJSONSerialization JSONObjectWithData:data options:kNilOptions error:NULL];
+}
+
++(NSData *)dataWithJSONObject:(id)object
+{
+    if (object == nil || ![NSJSONSerialization isValidJSONObject:object]) {
+        return nil;
+    }
+    return [NSJSONSerialization dataWithJSONObject:object options:0 error:NULL];
+}
+
+@end
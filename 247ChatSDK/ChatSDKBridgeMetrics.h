@@ -0,0 +1,35 @@
+//
+//  ChatSDKBridgeMetrics.h
+//  247ChatSDK
+//
+//  Copyright (c) 2014 . All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/*
+ * ChatSDKBridgeMetrics  Per-action counters & latency histograms of the JS bridge. Recording is a few
+                         atomic increments and can happen on any thread, only the first call of an
+                         action takes a lock. Percentiles are read from log-scale buckets (4 per power
+                         of two), so they are accurate to about 19%.
+ */
+@interface ChatSDKBridgeMetrics : NSObject
+
++(ChatSDKBridgeMetrics *)sharedMetrics;
+
+// Time spent in the native handler of action
+-(void)recordAction:(NSString *)action nativeTime:(NSTimeInterval)time failed:(BOOL)failed;
+
+// Time from the request reaching the native bridge to its result being handed to the web view. The JS side
+// of the call (Bridge.js until window.NativeBridge._complete) is not in it
+-(void)recordAction:(NSString *)action bridgeTime:(NSTimeInterval)time requestBytes:(NSUInteger)requestBytes responseBytes:(NSUInteger)responseBytes;
+
+/*
+ {"since" : <seconds since 1970>, "actions" : {<action> : {"count", "errors", "requestBytes", "responseBytes",
+ "nativeTime" : {"count", "p50", "p95", "p99"}, "bridgeTime" : {...}}}}, times in milliseconds
+ */
+-(NSDictionary *)snapshot;
+
+-(void)reset;
+
+@end
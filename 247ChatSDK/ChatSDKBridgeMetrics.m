@@ -0,0 +1,199 @@
+//
+//  ChatSDKBridgeMetrics.m
+//  247ChatSDK
+//
+//  Copyright (c) 2014 . All rights reserved.
+//
+
+#import "ChatSDKBridgeMetrics.h"
+#import <stdatomic.h>
+#import <math.h>
+
+// Bucket i holds latencies up to 2^(i/4) microseconds, the last one everything above
+#define kChatSDKHistogramBuckets 128
+
+typedef struct {
+    _Atomic(uint64_t) count;
+    _Atomic(uint64_t) buckets[kChatSDKHistogramBuckets];
+} ChatSDKLatencyHistogram;
+
+static void histogramRecord(ChatSDKLatencyHistogram *histogram, NSTimeInterval time)
+{
+    double microseconds = time * 1000000.0;
+    int bucket = 0;
+    if (microseconds > 1.0) {
+        bucket = (int)ceil(4.0 * log2(microseconds));
+        if (bucket >= kChatSDKHistogramBuckets) {
+            bucket = kChatSDKHistogramBuckets - 1;
+        }
+    }
+    atomic_fetch_add_explicit(&histogram->buckets[bucket], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&histogram->count, 1, memory_order_relaxed);
+}
+
+// Upper bound of the bucket holding percentile, in milliseconds
+static double histogramPercentile(ChatSDKLatencyHistogram *histogram, uint64_t total, double percentile)
+{
+    if (total == 0) {
+        return 0;
+    }
+    uint64_t rank = (uint64_t)ceil(percentile * total);
+    uint64_t seen = 0;
+    for (int i = 0; i < kChatSDKHistogramBuckets; i++) {
+        seen += atomic_load_explicit(&histogram->buckets[i], memory_order_relaxed);
+        if (seen >= rank) {
+            return pow(2.0, i / 4.0) / 1000.0;
+        }
+    }
+    return pow(2.0, (kChatSDKHistogramBuckets - 1) / 4.0) / 1000.0;
+}
+
+static NSDictionary *histogramSnapshot(ChatSDKLatencyHistogram *histogram)
+{
+    uint64_t total = 0;
+    for (int i = 0; i < kChatSDKHistogramBuckets; i++) {
+        total += atomic_load_explicit(&histogram->buckets[i], memory_order_relaxed);
+    }
+    return @{ @"count" : [NSNumber numberWithUnsignedLongLong:total],
+              @"p50" : [NSNumber numberWithDouble:histogramPercentile(histogram, total, 0.50)],
+              @"p95" : [NSNumber numberWithDouble:histogramPercentile(histogram, total, 0.95)],
+              @"p99" : [NSNumber numberWithDouble:histogramPercentile(histogram, total, 0.99)] };
+}
+
+typedef struct {
+    _Atomic(uint64_t) count;
+    _Atomic(uint64_t) errors;
+    _Atomic(uint64_t) requestBytes;
+    _Atomic(uint64_t) responseBytes;
+    ChatSDKLatencyHistogram nativeTime;
+    ChatSDKLatencyHistogram bridgeTime;
+} ChatSDKActionCounters;
+
+// Owns the counters of one action, they live in a C struct so that they can be atomic
+@interface ChatSDKBridgeActionMetrics : NSObject
+{
+@public
+    ChatSDKActionCounters *counters;
+}
+@end
+
+@implementation ChatSDKBridgeActionMetrics
+
+-(id)init
+{
+    self = [super init];
+    if (self) {
+        counters = calloc(1, sizeof(ChatSDKActionCounters));
+    }
+    return self;
+}
+
+-(void)dealloc
+{
+    free(counters);
+}
+
+-(NSDictionary *)snapshot
+{
+    return @{ @"count" : [NSNumber numberWithUnsignedLongLong:atomic_load(&counters->count)],
+              @"errors" : [NSNumber numberWithUnsignedLongLong:atomic_load(&counters->errors)],
+              @"requestBytes" : [NSNumber numberWithUnsignedLongLong:atomic_load(&counters->requestBytes)],
+              @"responseBytes" : [NSNumber numberWithUnsignedLongLong:atomic_load(&counters->responseBytes)],
+              @"nativeTime" : histogramSnapshot(&counters->nativeTime),
+              @"bridgeTime" : histogramSnapshot(&counters->bridgeTime) };
+}
+
+@end
+
+@interface ChatSDKBridgeMetrics ()
+// action -> ChatSDKBridgeActionMetrics, replaced as a whole when an action is added
+@property (atomic, copy) NSDictionary *actions;
+@property (atomic, strong) NSDate *since;
+@end
+
+@implementation ChatSDKBridgeMetrics
+
+@synthesize actions = _actions;
+@synthesize since = _since;
+
++(ChatSDKBridgeMetrics *)sharedMetrics
+{
+    static ChatSDKBridgeMetrics *sharedMetrics = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedMetrics = [[ChatSDKBridgeMetrics alloc] init];
+    });
+    return sharedMetrics;
+}
+
+-(id)init
+{
+    self = [super init];
+    if (self) {
+        _actions = [[NSDictionary alloc] init];
+        _since = [NSDate date];
+    }
+    return self;
+}
+
+-(ChatSDKBridgeActionMetrics *)metricsForAction:(NSString *)action
+{
+    NSString *key = action ? action : @"";
+    ChatSDKBridgeActionMetrics *metrics = [self.actions objectForKey:key];
+    if (metrics) {
+        return metrics;
+    }
+    @synchronized(self) {
+        metrics = [self.actions objectForKey:key];
+        if (metrics == nil) {
+            metrics = [[ChatSDKBridgeActionMetrics alloc] init];
+            NSMutableDictionary *actions = [self.actions mutableCopy];
+            [actions setObject:metrics forKey:key];
+            self.actions = actions;
+        }
+    }
+    return metrics;
+}
+
+-(void)recordAction:(NSString *)action nativeTime:(NSTimeInterval)time failed:(BOOL)failed
+{
+    // Kept alive while its counters are written, reset may drop it meanwhile
+    ChatSDKBridgeActionMetrics *metrics __attribute__((objc_precise_lifetime)) = [self metricsForAction:action];
+    ChatSDKActionCounters *counters = metrics->counters;
+    atomic_fetch_add_explicit(&counters->count, 1, memory_order_relaxed);
+    if (failed) {
+        atomic_fetch_add_explicit(&counters->errors, 1, memory_order_relaxed);
+    }
+    histogramRecord(&counters->nativeTime, time);
+}
+
+-(void)recordAction:(NSString *)action bridgeTime:(NSTimeInterval)time requestBytes:(NSUInteger)requestBytes responseBytes:(NSUInteger)responseBytes
+{
+    ChatSDKBridgeActionMetrics *metrics __attribute__((objc_precise_lifetime)) = [self metricsForAction:action];
+    ChatSDKActionCounters *counters = metrics->counters;
+    atomic_fetch_add_explicit(&counters->requestBytes, requestBytes, memory_order_relaxed);
+    atomic_fetch_add_explicit(&counters->responseBytes, responseBytes, memory_order_relaxed);
+    histogramRecord(&counters->bridgeTime, time);
+}
+
+-(NSDictionary *)snapshot
+{
+    NSDictionary *actions = self.actions;
+    NSMutableDictionary *actionSnapshots = [NSMutableDictionary dictionaryWithCapacity:[actions count]];
+    for (NSString *action in actions) {
+        [actionSnapshots setObject:[[actions objectForKey:action] snapshot] forKey:action];
+    }
+    return @{ @"since" : [NSNumber numberWithDouble:[self.since timeIntervalSince1970]],
+              @"actions" : actionSnapshots };
+}
+
+-(void)reset
+{
+    @synchronized(self) {
+        // Recorders holding an old ChatSDKBridgeActionMetrics write into it harmlessly
+        self.actions = [[NSDictionary alloc] init];
+        self.since = [NSDate date];
+    }
+}
+
+@end
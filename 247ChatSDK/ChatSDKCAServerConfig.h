@@ -0,0 +1,43 @@
+//
+//  ChatSDKCAServerConfig.h
+//  247ChatSDK
+//
+//  Copyright (c) 2014 . All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+typedef void (^ChatSDKCAServerConfigReadyBlock)(NSDictionary *queueURLs);
+// reachedServer is NO when no HTTP answer came back, e.g. offline
+typedef void (^ChatSDKCAServerConfigRevalidationBlock)(BOOL reachedServer);
+
+/*
+ * ChatSDKCAServerConfig        Loads the CheckAvailability section of the config XML without
+                                blocking the caller. The last good queueId -> URL map is served
+                                from an on-disk snapshot straight away and revalidated in the
+                                background with a conditional request (ETag/If-Modified-Since).
+ */
+@interface ChatSDKCAServerConfig : NSObject
+
+// queueId -> checkAvailability URL. Only changed on the main queue.
+@property (nonatomic, readonly, strong) NSDictionary *queueURLs;
+
+// YES once a snapshot was restored or the first revalidation finished (even if it failed)
+@property (nonatomic, readonly, assign) BOOL isReady;
+
+-(id)initWithURL:(NSURL *)url;
+
+// Restores the on-disk snapshot and starts a background revalidation
+-(void)load;
+-(void)loadWithCompletion:(ChatSDKCAServerConfigRevalidationBlock)completion;
+
+// Sends a conditional request for the config XML on the config queue
+-(void)revalidate;
+
+// completion is called on the main queue, also when it joined a revalidation that was running already
+-(void)revalidateWithCompletion:(ChatSDKCAServerConfigRevalidationBlock)completion;
+
+// Calls block on the main queue once the config is ready, immediately if it already is
+-(void)whenReady:(ChatSDKCAServerConfigReadyBlock)block;
+
+@end
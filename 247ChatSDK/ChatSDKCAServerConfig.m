@@ -0,0 +1,204 @@
+//
+//  ChatSDKCAServerConfig.m
+//  247ChatSDK
+//
+//  Copyright (c) 2014 . All rights reserved.
+//
+
+#import "ChatSDKCAServerConfig.h"
+#import "ChatSDKCAServerDetailParsing.h"
+
+static NSString *const kSnapshotURLKey = @"url";
+static NSString *const kSnapshotETagKey = @"etag";
+static NSString *const kSnapshotLastModifiedKey = @"lastModified";
+static NSString *const kSnapshotQueuesKey = @"queues";
+
+@interface ChatSDKCAServerConfig ()
+{
+    NSURL *configURL;
+    NSString *etag;
+    NSString *lastModified;
+    NSMutableArray *readyBlocks;
+    BOOL revalidating;
+    // Completions of the running revalidation
+    NSMutableArray *revalidationBlocks;
+    dispatch_queue_t configQueue;
+}
+
+@property (nonatomic, readwrite, strong) NSDictionary *queueURLs;
+@property (nonatomic, readwrite, assign) BOOL isReady;
+
+@end
+
+@implementation ChatSDKCAServerConfig
+
+@synthesize queueURLs = _queueURLs;
+@synthesize isReady = _isReady;
+
+-(id)initWithURL:(NSURL *)url
+{
+    self = [super init];
+    if (self) {
+        configURL = url;
+        readyBlocks = [[NSMutableArray alloc] init];
+        revalidationBlocks = [[NSMutableArray alloc] init];
+        _queueURLs = [[NSDictionary alloc] init];
+        configQueue = dispatch_queue_create("com.inc247.caServerConfigQueue", NULL);
+    }
+    return self;
+}
+
+-(void)load
+{
+    [self loadWithCompletion:nil];
+}
+
+-(void)loadWithCompletion:(ChatSDKCAServerConfigRevalidationBlock)completion
+{
+    [self restoreSnapshot];
+    [self revalidateWithCompletion:completion];
+}
+
+-(void)whenReady:(ChatSDKCAServerConfigReadyBlock)block
+{
+    if (block == nil) {
+        return;
+    }
+    dispatch_async(dispatch_get_main_queue(), ^(void) {
+        if (_isReady) {
+            block(_queueURLs);
+        } else {
+            [readyBlocks addObject:[block copy]];
+        }
+    });
+}
+
+-(void)revalidate
+{
+    [self revalidateWithCompletion:nil];
+}
+
+-(void)revalidateWithCompletion:(ChatSDKCAServerConfigRevalidationBlock)completion
+{
+    if (configURL == nil) {
+        // Nothing to fetch, callers fall back to chatsdk_agentavailability_url
+        [self markReady];
+        if (completion) {
+            dispatch_async(dispatch_get_main_queue(), ^(void) {
+                completion(YES);
+            });
+        }
+        return;
+    }
+    if (completion) {
+        [revalidationBlocks addObject:[completion copy]];
+    }
+    if (revalidating) {
+        return;
+    }
+    revalidating = YES;
+
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:configURL cachePolicy:NSURLRequestReloadIgnoringLocalCacheData timeoutInterval:30];
+    if (etag) {
+        [request setValue:etag forHTTPHeaderField:@"If-None-Match"];
+    }
+    if (lastModified) {
+        [request setValue:lastModified forHTTPHeaderField:@"If-Modified-Since"];
+    }
+
+    dispatch_async(configQueue, ^(void) {
+        NSHTTPURLResponse *response = nil;
+        NSError *error = nil;
+        NSData *data = [NSURLConnection sendSynchronousRequest:request returningResponse:&response error:&error];
+
+        NSDictionary *parsedQueues = nil;
+        if (!error && [response statusCode] == 200 && [data length] > 0) {
+            ChatSDKCAServerDetailParsing *parser = [[ChatSDKCAServerDetailParsing alloc] initWithXMLData:data];
+            if ([parser parserError] == nil) {
+                parsedQueues = [NSDictionary dictionaryWithDictionary:parser.caXmlResponse];
+            }
+        } else if (error) {
+            NSLog(@"CA server config revalidation failed > %@",[error localizedDescription]);
+        }
+
+        NSDictionary *headers = [response allHeaderFields];
+        BOOL reachedServer = response != nil;
+        dispatch_async(dispatch_get_main_queue(), ^(void) {
+            revalidating = NO;
+            if (parsedQueues) {
+                etag = [headers objectForKey:@"ETag"];
+                lastModified = [headers objectForKey:@"Last-Modified"];
+                self.queueURLs = parsedQueues;
+                [self saveSnapshot];
+            }
+            // 304 keeps the snapshot, failures keep whatever we had
+            [self markReady];
+
+            NSArray *blocks = [revalidationBlocks copy];
+            [revalidationBlocks removeAllObjects];
+            for (ChatSDKCAServerConfigRevalidationBlock block in blocks) {
+                block(reachedServer);
+            }
+        });
+    });
+}
+
+#pragma mark - Snapshot
+
+-(NSString *)snapshotPath
+{
+    NSString *cachesDirectory = [NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES) lastObject];
+    return [cachesDirectory stringByAppendingPathComponent:@"ChatSDKCAServerConfig.plist"];
+}
+
+-(void)restoreSnapshot
+{
+    NSDictionary *snapshot = [NSDictionary dictionaryWithContentsOfFile:[self snapshotPath]];
+    // A snapshot of a different config URL is of no use
+    if (snapshot == nil || ![[snapshot objectForKey:kSnapshotURLKey] isEqualToString:[configURL absoluteString]]) {
+        return;
+    }
+    NSDictionary *queues = [snapshot objectForKey:kSnapshotQueuesKey];
+    if ([queues count] == 0) {
+        return;
+    }
+    etag = [snapshot objectForKey:kSnapshotETagKey];
+    lastModified = [snapshot objectForKey:kSnapshotLastModifiedKey];
+    self.queueURLs = queues;
+    [self markReady];
+}
+
+-(void)saveSnapshot
+{
+    NSMutableDictionary *snapshot = [NSMutableDictionary dictionary];
+    [snapshot setObject:[configURL absoluteString] forKey:kSnapshotURLKey];
+    [snapshot setObject:_queueURLs forKey:kSnapshotQueuesKey];
+    if (etag) {
+        [snapshot setObject:etag forKey:kSnapshotETagKey];
+    }
+    if (lastModified) {
+        [snapshot setObject:lastModified forKey:kSnapshotLastModifiedKey];
+    }
+    NSString *path = [self snapshotPath];
+    dispatch_async(configQueue, ^(void) {
+        [snapshot writeToFile:path atomically:YES];
+    });
+}
+
+-(void)markReady
+{
+    if (![NSThread isMainThread]) {
+        dispatch_async(dispatch_get_main_queue(), ^(void) {
+            [self markReady];
+        });
+        return;
+    }
+    self.isReady = YES;
+    NSArray *blocks = [readyBlocks copy];
+    [readyBlocks removeAllObjects];
+    for (ChatSDKCAServerConfigReadyBlock block in blocks) {
+        block(_queueURLs);
+    }
+}
+
+@end
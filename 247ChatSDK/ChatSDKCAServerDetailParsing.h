@@ -16,4 +16,7 @@
     BOOL isCheckAvailability;
 }
 @property(nonatomic,strong)NSMutableDictionary *caXmlResponse;
+
+// Parses already downloaded config XML, parserError is set if it was malformed
+-(id)initWithXMLData:(NSData *)data;
 @end
@@ -20,6 +20,16 @@
     return self;
 }
 
+-(id)initWithXMLData:(NSData *)data{
+    self=[super initWithData:data];
+    if (self) {
+        self.delegate=self;
+        _caXmlResponse=[NSMutableDictionary new];
+        [self parse];
+    }
+    return self;
+}
+
 -(void)parser:(NSXMLParser *)parser didStartElement:(NSString *)elementName namespaceURI:(NSString *)namespaceURI qualifiedName:(NSString *)qName attributes:(NSDictionary *)attributeDict
 {
     foundStr=[NSMutableString new];
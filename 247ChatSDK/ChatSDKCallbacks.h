@@ -34,6 +34,23 @@
 
 
 @optional
+/*
+ * onChatAgentAvailabilityForQueues  This notification will be called as a callback of
+                             checkAgentAvailabilityForQueues method.
+ * @param availability       NSDictionary mapping each queueId to an NSNumber boolean representing
+                             the availability of the chat agent on that queue.
+ */
+-(void)onChatAgentAvailabilityForQueues:(NSDictionary *)availability;
+
+/*
+ * onChatAgentAvailability:forQueue:  This notification will be called for queues watched with
+                             subscribeToAvailabilityForQueue when their availability changes. If it is
+                             not implemented, onChatAgentAvailability is called instead.
+ * @param connected          A  boolean representing the availability of the chat agent.
+ * @param queueId            The queueId whose availability changed.
+ */
+-(void)onChatAgentAvailability:(BOOL)connected forQueue:(NSString *)queueId;
+
 /*
  * onChatStarted             Notifies application when chat has started. This is an optional 
                              notification and can be used to retrieve the session id of the chat
@@ -62,6 +79,14 @@
  */
 -(void)onAgentMessage:(NSDictionary*)data;
 
+/*
+ * onAgentMessage:count:     Like onAgentMessage, for the messages coalesced by agentMessageCoalescingInterval
+                             of ChatSDKCallbacks. If it is implemented, onAgentMessage is not called.
+ * @param data               The data of the latest of the messages.
+ * @param count              Number of agent messages since the previous call, 1 without coalescing.
+ */
+-(void)onAgentMessage:(NSDictionary*)data count:(NSUInteger)count;
+
 /*
  * onChatMinimized           Notifies application when the chat view has been hidden from the end user. 
                              This is an optional notification and can be used to display a custom 
@@ -87,6 +112,15 @@
  */
 -(void)onNavigationRequest:(NSDictionary *)data;
 
+/*
+ * onChatHibernated          Notifies application when a minimized chat released its chat view to save
+                             memory. The minimize button stays and the chat is loaded again when it is
+                             maximized. This is an optional notification.
+ * @param data               Holds the keys 'reclaimedBytes', the drop of the resident memory of the
+                             application, and 'queueId' when the chat has one
+ */
+-(void)onChatHibernated:(NSDictionary *)data;
+
 @end
 
 @interface ChatSDKCallbacks : NSObject
@@ -96,13 +130,26 @@
 
 @property(nonatomic,strong) id<ChatSDKDelegate> delegate;
 
-// Instance methods
+// Queue the delegate is called on, nil means the main queue. Default value : main queue
+@property(nonatomic,strong) dispatch_queue_t delegateQueue;
+
+// Seconds within which agent messages after the first one are delivered together by one onAgentMessage:count:
+// at the end of the interval, with the latest data. Any other callback delivers the waiting ones before itself.
+// 0 delivers every message. Default value : 0
+@property(atomic,assign) NSTimeInterval agentMessageCoalescingInterval;
+
+// Instance methods, the delegate is called on delegateQueue. onAgentMessageDelegateHandler may be called on any
+// thread, the others on the main thread
 -(void)onChatStartedDelegateHandler:(NSDictionary *)dataDictionary;
 
 -(void)onChatEndedDelegateHandler:(NSDictionary *)dataDictionary;
 
 -(void)onChatAgentAvailabilityDelegateHandler:(BOOL)connectedAgent;
 
+-(void)onChatAgentAvailabilityForQueuesDelegateHandler:(NSDictionary *)availability;
+
+-(void)onChatAgentAvailabilityDelegateHandler:(BOOL)connectedAgent forQueue:(NSString *)queueId;
+
 -(void)onAgentMessageDelegateHandler:(NSDictionary *)dataDictionary;
 
 -(void)onChatMinimizedDelegateHandler:(NSDictionary *)dataDictionary;
@@ -113,4 +160,6 @@
 
 -(void)onNavigationRequestHandler:(NSDictionary *)dataDictionary;
 
+-(void)onChatHibernatedDelegateHandler:(NSDictionary *)dataDictionary;
+
 @end
@@ -8,57 +8,204 @@
 
 #import "ChatSDKCallbacks.h"
 
+@interface ChatSDKCallbacks ()
+{
+    // Agent messages waiting for the next delivery while coalescing, guarded by @synchronized(self)
+    NSUInteger pendingAgentMessages;
+    NSDictionary *latestAgentMessage;
+    BOOL agentMessageDeliveryScheduled;
+    NSTimeInterval lastAgentMessageDelivery;
+    // Bumped by each delivery, so that the trailing delivery of a burst flushed earlier does nothing
+    NSUInteger agentMessageDeliveries;
+}
+@end
 
 @implementation ChatSDKCallbacks
 
 @synthesize delegate;
+@synthesize delegateQueue = _delegateQueue;
+@synthesize agentMessageCoalescingInterval = _agentMessageCoalescingInterval;
+
+-(dispatch_queue_t)delegateQueue
+{
+    return _delegateQueue ? _delegateQueue : dispatch_get_main_queue();
+}
+
+// Runs block on delegateQueue, at once when the caller is on it already. Agent messages still waiting to be
+// coalesced go first, so that e.g. onChatEnded never comes before an agent message received earlier
+-(void)deliverToDelegate:(dispatch_block_t)block
+{
+    dispatch_block_t ordered = ^(void) {
+        [self deliverPendingAgentMessages];
+        block();
+    };
+    dispatch_queue_t queue = self.delegateQueue;
+    if (queue == dispatch_get_main_queue() && [NSThread isMainThread]) {
+        ordered();
+    } else {
+        dispatch_async(queue, ordered);
+    }
+}
 
 // Delegate to start chat
 -(void)onChatStartedDelegateHandler:(NSDictionary *)dataDictionary
 {
-    [delegate onChatStarted:dataDictionary];
+    [self deliverToDelegate:^(void) {
+        [delegate onChatStarted:dataDictionary];
+    }];
 }
 
 // Delegate to End Chat
 -(void)onChatEndedDelegateHandler:(NSDictionary *)dataDictionary
 {
-    [delegate onChatEnded:dataDictionary];
+    [self deliverToDelegate:^(void) {
+        [delegate onChatEnded:dataDictionary];
+    }];
 }
 
 // Delegate to check Agent availability
 -(void)onChatAgentAvailabilityDelegateHandler:(BOOL)connectedAgent
 {
-    [delegate onChatAgentAvailability:connectedAgent];
+    [self deliverToDelegate:^(void) {
+        [delegate onChatAgentAvailability:connectedAgent];
+    }];
+}
+
+// Delegate to check Agent availability of several queues
+-(void)onChatAgentAvailabilityForQueuesDelegateHandler:(NSDictionary *)availability
+{
+    [self deliverToDelegate:^(void) {
+        if ([delegate respondsToSelector:@selector(onChatAgentAvailabilityForQueues:)]) {
+            [delegate onChatAgentAvailabilityForQueues:availability];
+        }
+    }];
+}
+
+// Delegate to notify a changed Agent availability of a subscribed queue
+-(void)onChatAgentAvailabilityDelegateHandler:(BOOL)connectedAgent forQueue:(NSString *)queueId
+{
+    [self deliverToDelegate:^(void) {
+        if ([delegate respondsToSelector:@selector(onChatAgentAvailability:forQueue:)]) {
+            [delegate onChatAgentAvailability:connectedAgent forQueue:queueId];
+        } else {
+            [delegate onChatAgentAvailability:connectedAgent];
+        }
+    }];
 }
 
-// Delegate to notify new message
+// Delegate to notify new message, a burst is delivered at most once per agentMessageCoalescingInterval
 -(void)onAgentMessageDelegateHandler:(NSDictionary *)dataDictionary
 {
-    [delegate onAgentMessage:dataDictionary];
+    NSTimeInterval interval = self.agentMessageCoalescingInterval;
+    if (interval <= 0) {
+        [self deliverToDelegate:^(void) {
+            [self deliverAgentMessage:dataDictionary count:1];
+        }];
+        return;
+    }
+
+    // The first message after a quiet interval goes at once, the next ones wait for the end of the interval
+    NSTimeInterval delay = -1;
+    NSUInteger deliveries = 0;
+    @synchronized(self) {
+        pendingAgentMessages++;
+        latestAgentMessage = dataDictionary;
+        if (!agentMessageDeliveryScheduled) {
+            agentMessageDeliveryScheduled = YES;
+            delay = MAX(0, lastAgentMessageDelivery + interval - [NSDate timeIntervalSinceReferenceDate]);
+            deliveries = agentMessageDeliveries;
+        }
+    }
+    if (delay == 0) {
+        [self deliverToDelegate:^(void) {
+            [self deliverPendingAgentMessages];
+        }];
+    } else if (delay > 0) {
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), self.delegateQueue, ^(void) {
+            [self deliverPendingAgentMessagesAfter:deliveries];
+        });
+    }
+}
+
+// Delivers the pending agent messages, on delegateQueue
+-(void)deliverPendingAgentMessages
+{
+    NSUInteger deliveries = 0;
+    @synchronized(self) {
+        deliveries = agentMessageDeliveries;
+    }
+    [self deliverPendingAgentMessagesAfter:deliveries];
+}
+
+// Delivers the pending agent messages unless another delivery came after the one counted as deliveries
+-(void)deliverPendingAgentMessagesAfter:(NSUInteger)deliveries
+{
+    NSUInteger count = 0;
+    NSDictionary *latest = nil;
+    @synchronized(self) {
+        if (deliveries != agentMessageDeliveries || pendingAgentMessages == 0) {
+            return;
+        }
+        count = pendingAgentMessages;
+        latest = latestAgentMessage;
+        pendingAgentMessages = 0;
+        latestAgentMessage = nil;
+        agentMessageDeliveryScheduled = NO;
+        lastAgentMessageDelivery = [NSDate timeIntervalSinceReferenceDate];
+        agentMessageDeliveries++;
+    }
+    [self deliverAgentMessage:latest count:count];
+}
+
+-(void)deliverAgentMessage:(NSDictionary *)dataDictionary count:(NSUInteger)count
+{
+    if ([delegate respondsToSelector:@selector(onAgentMessage:count:)]) {
+        [delegate onAgentMessage:dataDictionary count:count];
+    } else {
+        [delegate onAgentMessage:dataDictionary];
+    }
 }
 
 // Delegate to minimize chat window
 -(void)onChatMinimizedDelegateHandler:(NSDictionary *)dataDictionary
 {
-    [delegate onChatMinimized:dataDictionary];
+    [self deliverToDelegate:^(void) {
+        [delegate onChatMinimized:dataDictionary];
+    }];
 }
 
 // Delegate to maximize chat window
 -(void)onChatMaximizedDelegateHandler:(NSDictionary *)dataDictionary
 {
-    [delegate onChatMaximized:dataDictionary];
+    [self deliverToDelegate:^(void) {
+        [delegate onChatMaximized:dataDictionary];
+    }];
 }
 
 // Delegate to show error
 -(void)onChatErrorDelegateHandler:(ChatSDKError *)error
 {
-    [delegate onChatError:error];
+    [self deliverToDelegate:^(void) {
+        [delegate onChatError:error];
+    }];
 }
 
 //Delegate for custom url handling
 -(void)onNavigationRequestHandler:(NSDictionary *)dataDictionary
 {
-    [delegate onNavigationRequest:dataDictionary];
+    [self deliverToDelegate:^(void) {
+        [delegate onNavigationRequest:dataDictionary];
+    }];
+}
+
+// Delegate to notify a minimized chat released its chat view
+-(void)onChatHibernatedDelegateHandler:(NSDictionary *)dataDictionary
+{
+    [self deliverToDelegate:^(void) {
+        if ([delegate respondsToSelector:@selector(onChatHibernated:)]) {
+            [delegate onChatHibernated:dataDictionary];
+        }
+    }];
 }
 
 @end
@@ -0,0 +1,115 @@
+//
+//  ChatSDKConfiguration.h
+//  247ChatSDK
+//
+//  Copyright (c) 2014 . All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+extern NSString *const ChatSDKConfigurationErrorDomain;
+// userInfo key of a validation error, "<plist>:<key path>" of the offending value
+extern NSString *const ChatSDKConfigurationKeyErrorKey;
+
+typedef enum {
+    ChatSDKConfigurationErrorMissingValue = 1,
+    ChatSDKConfigurationErrorEmptyValue,
+    ChatSDKConfigurationErrorInvalidValue
+}ChatSDKConfigurationError;
+
+// Values are the position codes of ChatSDKMaximizeButton
+typedef enum {
+    ChatSDKButtonPositionTopLeft = 0,
+    ChatSDKButtonPositionTopCenter = 1,
+    ChatSDKButtonPositionTopRight = 2,
+    ChatSDKButtonPositionMiddleRight = 3,
+    ChatSDKButtonPositionBottomRight = 4,
+    ChatSDKButtonPositionBottomCenter = 5,
+    ChatSDKButtonPositionBottomLeft = 6,
+    ChatSDKButtonPositionMiddleLeft = 7
+}ChatSDKButtonPosition;
+
+typedef enum {
+    ChatSDKAnimationBottomTop,
+    ChatSDKAnimationTopBottom,
+    ChatSDKAnimationLeftRight,
+    ChatSDKAnimationRightLeft
+}ChatSDKAnimationStyle;
+
+typedef enum {
+    ChatSDKVerticalAlignmentNone,
+    ChatSDKVerticalAlignmentTop,
+    ChatSDKVerticalAlignmentMiddle,
+    ChatSDKVerticalAlignmentBottom
+}ChatSDKVerticalAlignment;
+
+typedef enum {
+    ChatSDKHorizontalAlignmentNone,
+    ChatSDKHorizontalAlignmentLeft,
+    ChatSDKHorizontalAlignmentCenter,
+    ChatSDKHorizontalAlignmentRight
+}ChatSDKHorizontalAlignment;
+
+// A Portrait / Landscape pair of chatsdkdefaults.plist
+typedef struct {
+    float portrait;
+    float landscape;
+} ChatSDKOrientedValue;
+
+/*
+ * ChatSDKConfiguration  Parsed & validated chatsdkdefaults.plist + chatsdkconfig.plist. The shared
+                         configuration is read from the main bundle once per process, reloadSharedConfiguration
+                         replaces it with a fresh one. Instances never change, so they can be read on any thread.
+ */
+@interface ChatSDKConfiguration : NSObject
+
+// CHATSDKDEFAULTS
+@property (nonatomic, readonly, assign) BOOL customizeMinimizeState;
+@property (nonatomic, readonly, assign) ChatSDKButtonPosition minimizedButtonPositionPortrait;
+@property (nonatomic, readonly, assign) ChatSDKButtonPosition minimizedButtonPositionLandscape;
+@property (nonatomic, readonly, strong) NSString *minimizedButtonTextColor;
+@property (nonatomic, readonly, strong) NSString *minimizedButtonBackgroundColor;
+@property (nonatomic, readonly, assign) ChatSDKAnimationStyle animationStyle;
+@property (nonatomic, readonly, assign) ChatSDKHorizontalAlignment horizontalAlignmentPortrait;
+@property (nonatomic, readonly, assign) ChatSDKHorizontalAlignment horizontalAlignmentLandscape;
+@property (nonatomic, readonly, assign) ChatSDKVerticalAlignment verticalAlignmentPortrait;
+@property (nonatomic, readonly, assign) ChatSDKVerticalAlignment verticalAlignmentLandscape;
+// Percent of the screen
+@property (nonatomic, readonly, assign) ChatSDKOrientedValue height;
+@property (nonatomic, readonly, assign) ChatSDKOrientedValue width;
+// Points
+@property (nonatomic, readonly, assign) ChatSDKOrientedValue paddingTop;
+@property (nonatomic, readonly, assign) ChatSDKOrientedValue paddingBottom;
+@property (nonatomic, readonly, assign) ChatSDKOrientedValue paddingLeft;
+@property (nonatomic, readonly, assign) ChatSDKOrientedValue paddingRight;
+@property (nonatomic, readonly, strong) NSString *customUrlScheme;
+
+// CHATSDKCONFIG
+@property (nonatomic, readonly, strong) NSURL *chatURL;
+// Base of the checkAvailability URL, queueId & accountId are appended
+@property (nonatomic, readonly, strong) NSString *agentAvailabilityURL;
+@property (nonatomic, readonly, strong) NSString *accountId;
+@property (nonatomic, readonly, strong) NSString *queueId;
+@property (nonatomic, readonly, strong) NSURL *configURL;
+// chatsdk_web_engine is "wkwebview"
+@property (nonatomic, readonly, assign) BOOL prefersWKWebView;
+@property (nonatomic, readonly, assign) BOOL batchesBridgeCalls;
+@property (nonatomic, readonly, strong) NSURL *assetManifestURL;
+
+// NSErrors of ChatSDKConfigurationErrorDomain, empty when valid
+@property (nonatomic, readonly, strong) NSArray *validationErrors;
+@property (nonatomic, readonly, assign) BOOL isValid;
+
++(ChatSDKConfiguration *)sharedConfiguration;
+
+// Reads the plists of the main bundle again, e.g. after they were replaced at runtime
++(ChatSDKConfiguration *)reloadSharedConfiguration;
+
+// Makes configuration the shared one, e.g. one read from outside the main bundle in a headless build
++(void)setSharedConfiguration:(ChatSDKConfiguration *)configuration;
+
++(ChatSDKConfiguration *)configurationWithDefaultsFile:(NSString *)defaultsPath configFile:(NSString *)configPath;
+
+-(id)initWithDefaults:(NSDictionary *)defaults config:(NSDictionary *)config;
+
+@end
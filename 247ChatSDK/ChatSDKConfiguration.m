@@ -0,0 +1,257 @@
+//
+//  ChatSDKConfiguration.m
+//  247ChatSDK
+//
+//  Copyright (c) 2014 . All rights reserved.
+//
+
+#import "ChatSDKConfiguration.h"
+
+NSString *const ChatSDKConfigurationErrorDomain = @"ChatSDKConfigurationErrorDomain";
+NSString *const ChatSDKConfigurationKeyErrorKey = @"ChatSDKConfigurationKey";
+
+static NSString *const kDefaultsPlist = @"chatsdkdefaults";
+static NSString *const kConfigPlist = @"chatsdkconfig";
+
+// Replaced as a whole under the class lock
+static ChatSDKConfiguration *sharedConfiguration = nil;
+
+@interface ChatSDKConfiguration ()
+{
+    NSMutableArray *errors;
+}
+@end
+
+@implementation ChatSDKConfiguration
+
+@synthesize customizeMinimizeState = _customizeMinimizeState;
+@synthesize minimizedButtonPositionPortrait = _minimizedButtonPositionPortrait;
+@synthesize minimizedButtonPositionLandscape = _minimizedButtonPositionLandscape;
+@synthesize minimizedButtonTextColor = _minimizedButtonTextColor;
+@synthesize minimizedButtonBackgroundColor = _minimizedButtonBackgroundColor;
+@synthesize animationStyle = _animationStyle;
+@synthesize horizontalAlignmentPortrait = _horizontalAlignmentPortrait;
+@synthesize horizontalAlignmentLandscape = _horizontalAlignmentLandscape;
+@synthesize verticalAlignmentPortrait = _verticalAlignmentPortrait;
+@synthesize verticalAlignmentLandscape = _verticalAlignmentLandscape;
+@synthesize height = _height;
+@synthesize width = _width;
+@synthesize paddingTop = _paddingTop;
+@synthesize paddingBottom = _paddingBottom;
+@synthesize paddingLeft = _paddingLeft;
+@synthesize paddingRight = _paddingRight;
+@synthesize customUrlScheme = _customUrlScheme;
+@synthesize chatURL = _chatURL;
+@synthesize agentAvailabilityURL = _agentAvailabilityURL;
+@synthesize accountId = _accountId;
+@synthesize queueId = _queueId;
+@synthesize configURL = _configURL;
+@synthesize prefersWKWebView = _prefersWKWebView;
+@synthesize batchesBridgeCalls = _batchesBridgeCalls;
+@synthesize assetManifestURL = _assetManifestURL;
+@synthesize validationErrors = _validationErrors;
+
+#pragma mark - Shared configuration
+
++(ChatSDKConfiguration *)sharedConfiguration
+{
+    @synchronized(self) {
+        if (sharedConfiguration == nil) {
+            sharedConfiguration = [self bundleConfiguration];
+        }
+        return sharedConfiguration;
+    }
+}
+
++(ChatSDKConfiguration *)reloadSharedConfiguration
+{
+    ChatSDKConfiguration *configuration = [self bundleConfiguration];
+    [self setSharedConfiguration:configuration];
+    return configuration;
+}
+
++(void)setSharedConfiguration:(ChatSDKConfiguration *)configuration
+{
+    @synchronized(self) {
+        sharedConfiguration = configuration;
+    }
+}
+
++(ChatSDKConfiguration *)bundleConfiguration
+{
+    NSBundle *bundle = [NSBundle mainBundle];
+    ChatSDKConfiguration *configuration = [self configurationWithDefaultsFile:[bundle pathForResource:kDefaultsPlist ofType:@"plist"] configFile:[bundle pathForResource:kConfigPlist ofType:@"plist"]];
+    for (NSError *error in configuration.validationErrors) {
+        NSLog(@"Chat SDK configuration > %@",[error localizedDescription]);
+    }
+    return configuration;
+}
+
++(ChatSDKConfiguration *)configurationWithDefaultsFile:(NSString *)defaultsPath configFile:(NSString *)configPath
+{
+    NSDictionary *defaults = defaultsPath ? [NSDictionary dictionaryWithContentsOfFile:defaultsPath] : nil;
+    NSDictionary *config = configPath ? [NSDictionary dictionaryWithContentsOfFile:configPath] : nil;
+    return [[ChatSDKConfiguration alloc] initWithDefaults:defaults config:config];
+}
+
+#pragma mark - Parsing
+
+-(id)initWithDefaults:(NSDictionary *)defaults config:(NSDictionary *)config
+{
+    self = [super init];
+    if (self) {
+        errors = [[NSMutableArray alloc] init];
+        [self parseDefaults:defaults];
+        [self parseConfig:config];
+        _validationErrors = [errors copy];
+        errors = nil;
+    }
+    return self;
+}
+
+-(BOOL)isValid
+{
+    return [_validationErrors count] == 0;
+}
+
+-(void)addError:(ChatSDKConfigurationError)code plist:(NSString *)plist key:(NSString *)key
+{
+    NSString *keyPath = [NSString stringWithFormat:@"%@.plist:%@",plist,key];
+    NSString *description = nil;
+    switch (code) {
+        case ChatSDKConfigurationErrorMissingValue:
+            description = [NSString stringWithFormat:@"%@ is missing",keyPath];
+            break;
+        case ChatSDKConfigurationErrorEmptyValue:
+            description = [NSString stringWithFormat:@"%@ is empty",keyPath];
+            break;
+        default:
+            description = [NSString stringWithFormat:@"%@ is not valid",keyPath];
+            break;
+    }
+    [errors addObject:[NSError errorWithDomain:ChatSDKConfigurationErrorDomain code:code userInfo:@{ChatSDKConfigurationKeyErrorKey : keyPath, NSLocalizedDescriptionKey : description}]];
+}
+
+// String value of a required key, reported when missing (& when empty if that is not allowed)
+-(NSString *)requiredString:(NSDictionary *)dictionary key:(NSString *)key plist:(NSString *)plist keyPath:(NSString *)keyPath allowEmpty:(BOOL)allowEmpty
+{
+    id value = [dictionary objectForKey:key];
+    if (value == nil) {
+        [self addError:ChatSDKConfigurationErrorMissingValue plist:plist key:keyPath];
+        return nil;
+    }
+    if (![value isKindOfClass:[NSString class]]) {
+        [self addError:ChatSDKConfigurationErrorInvalidValue plist:plist key:keyPath];
+        return nil;
+    }
+    if (!allowEmpty && [value length] == 0) {
+        [self addError:ChatSDKConfigurationErrorEmptyValue plist:plist key:keyPath];
+    }
+    return value;
+}
+
+static float floatValue(id value)
+{
+    return [value respondsToSelector:@selector(floatValue)] ? [value floatValue] : 0;
+}
+
+static ChatSDKOrientedValue orientedValue(NSDictionary *defaults, NSString *key)
+{
+    NSDictionary *pair = [defaults objectForKey:key];
+    ChatSDKOrientedValue value;
+    value.portrait = [pair isKindOfClass:[NSDictionary class]] ? floatValue([pair objectForKey:@"Portrait"]) : 0;
+    value.landscape = [pair isKindOfClass:[NSDictionary class]] ? floatValue([pair objectForKey:@"Landscape"]) : 0;
+    return value;
+}
+
+static ChatSDKHorizontalAlignment horizontalAlignment(NSString *value)
+{
+    if ([value isEqual:@"left"]) return ChatSDKHorizontalAlignmentLeft;
+    if ([value isEqual:@"center"]) return ChatSDKHorizontalAlignmentCenter;
+    if ([value isEqual:@"right"]) return ChatSDKHorizontalAlignmentRight;
+    return ChatSDKHorizontalAlignmentNone;
+}
+
+static ChatSDKVerticalAlignment verticalAlignment(NSString *value)
+{
+    if ([value isEqual:@"top"]) return ChatSDKVerticalAlignmentTop;
+    if ([value isEqual:@"middle"]) return ChatSDKVerticalAlignmentMiddle;
+    if ([value isEqual:@"bottom"]) return ChatSDKVerticalAlignmentBottom;
+    return ChatSDKVerticalAlignmentNone;
+}
+
+// Only the middle positions are supported, anything else is middle-right
+static ChatSDKButtonPosition buttonPosition(NSString *value)
+{
+    return [value isEqual:@"middle-left"] ? ChatSDKButtonPositionMiddleLeft : ChatSDKButtonPositionMiddleRight;
+}
+
+-(void)parseDefaults:(NSDictionary *)defaults
+{
+    _customizeMinimizeState = [[defaults objectForKey:@"custom minimize state"] boolValue];
+
+    NSDictionary *button = [defaults objectForKey:@"Mimimized button position"];
+    if (![button isKindOfClass:[NSDictionary class]]) {
+        button = nil;
+    }
+    _minimizedButtonBackgroundColor = [self requiredString:button key:@"backgroundColor" plist:kDefaultsPlist keyPath:@"Mimimized button position.backgroundColor" allowEmpty:NO];
+    _minimizedButtonTextColor = [self requiredString:button key:@"textColor" plist:kDefaultsPlist keyPath:@"Mimimized button position.textColor" allowEmpty:NO];
+    _minimizedButtonPositionPortrait = buttonPosition([self requiredString:button key:@"Portrait" plist:kDefaultsPlist keyPath:@"Mimimized button position.Portrait" allowEmpty:YES]);
+    _minimizedButtonPositionLandscape = buttonPosition([self requiredString:button key:@"Landscape" plist:kDefaultsPlist keyPath:@"Mimimized button position.Landscape" allowEmpty:YES]);
+
+    NSString *animation = [defaults objectForKey:@"Animation style"];
+    if ([animation isEqual:@"top-bottom"]) {
+        _animationStyle = ChatSDKAnimationTopBottom;
+    } else if ([animation isEqual:@"left-right"]) {
+        _animationStyle = ChatSDKAnimationLeftRight;
+    } else if ([animation isEqual:@"right-left"]) {
+        _animationStyle = ChatSDKAnimationRightLeft;
+    } else {
+        _animationStyle = ChatSDKAnimationBottomTop;
+    }
+
+    NSDictionary *halign = [defaults objectForKey:@"halign"];
+    NSDictionary *valign = [defaults objectForKey:@"valign"];
+    _horizontalAlignmentPortrait = horizontalAlignment([halign isKindOfClass:[NSDictionary class]] ? [halign objectForKey:@"Portrait"] : nil);
+    _horizontalAlignmentLandscape = horizontalAlignment([halign isKindOfClass:[NSDictionary class]] ? [halign objectForKey:@"Landscape"] : nil);
+    _verticalAlignmentPortrait = verticalAlignment([valign isKindOfClass:[NSDictionary class]] ? [valign objectForKey:@"Portrait"] : nil);
+    _verticalAlignmentLandscape = verticalAlignment([valign isKindOfClass:[NSDictionary class]] ? [valign objectForKey:@"Landscape"] : nil);
+
+    _height = orientedValue(defaults, @"height");
+    _width = orientedValue(defaults, @"width");
+    _paddingTop = orientedValue(defaults, @"padding-top");
+    _paddingBottom = orientedValue(defaults, @"padding-bottom");
+    _paddingLeft = orientedValue(defaults, @"padding-left");
+    _paddingRight = orientedValue(defaults, @"padding-right");
+
+    _customUrlScheme = [self requiredString:defaults key:@"customURLScheme" plist:kDefaultsPlist keyPath:@"customURLScheme" allowEmpty:YES];
+}
+
+-(void)parseConfig:(NSDictionary *)config
+{
+    NSString *chatURL = [self requiredString:config key:@"chatsdk_url" plist:kConfigPlist keyPath:@"chatsdk_url" allowEmpty:NO];
+    if ([chatURL length] > 0) {
+        _chatURL = [NSURL URLWithString:chatURL];
+        if (_chatURL == nil) {
+            [self addError:ChatSDKConfigurationErrorInvalidValue plist:kConfigPlist key:@"chatsdk_url"];
+        }
+    }
+    _agentAvailabilityURL = [self requiredString:config key:@"chatsdk_agentavailability_url" plist:kConfigPlist keyPath:@"chatsdk_agentavailability_url" allowEmpty:YES];
+    _accountId = [self requiredString:config key:@"chatsdk_accountId" plist:kConfigPlist keyPath:@"chatsdk_accountId" allowEmpty:YES];
+    _queueId = [self requiredString:config key:@"chatsdk_queueId" plist:kConfigPlist keyPath:@"chatsdk_queueId" allowEmpty:YES];
+
+    //Optional values
+    NSString *configURL = [config objectForKey:@"chatsdk_config_url"];
+    if ([configURL isKindOfClass:[NSString class]] && [configURL length] > 0) {
+        _configURL = [NSURL URLWithString:configURL];
+    }
+    NSString *webEngine = [config objectForKey:@"chatsdk_web_engine"];
+    _prefersWKWebView = [webEngine isKindOfClass:[NSString class]] && [[webEngine lowercaseString] isEqualToString:@"wkwebview"];
+    _batchesBridgeCalls = [[config objectForKey:@"chatsdk_batch_bridge"] boolValue];
+    NSString *assetManifestURL = [config objectForKey:@"chatsdk_asset_manifest_url"];
+    if ([assetManifestURL isKindOfClass:[NSString class]] && [assetManifestURL length] > 0) {
+        _assetManifestURL = [NSURL URLWithString:assetManifestURL];
+    }
+}
+
+@end
@@ -9,6 +9,7 @@
 #import <Foundation/Foundation.h>
 
 @class ChatSDKBridgeAction;
+@class ChatSDKAssetCache;
 @protocol ChatSDKJSBridgeDelegate;
 
 @interface ChatSDKJSBridge : NSURLCache
@@ -17,18 +18,22 @@
 }
 
 @property(weak) id <ChatSDKJSBridgeDelegate> delegate;
+
+// Chat app assets answered from disk, any other request goes to the system cache
+@property(strong) ChatSDKAssetCache *assetCache;
+
+// Action of a /!chat_exec/<action>?<percent encoded JSON params> call, query may be nil
++ (ChatSDKBridgeAction *)bridgeActionWithName:(NSString *)action query:(NSString *)query;
+
+// Runs action on delegate, a bridge error is added to the result as "error"
++ (NSDictionary *)resultOfAction:(ChatSDKBridgeAction *)action withDelegate:(id <ChatSDKJSBridgeDelegate>)delegate;
+
+// Runs the calls of a /!chat_exec_batch/?<percent encoded JSON [{action, id, params}]> request in order.
+// The result of a call without response is NSNull.
++ (NSArray *)resultsOfBatch:(NSString *)query withDelegate:(id <ChatSDKJSBridgeDelegate>)delegate;
 @end
 
 //Declaring protocol
 @protocol ChatSDKJSBridgeDelegate <NSObject>
 - (NSDictionary *)executeNative:(ChatSDKBridgeAction *)action error:(NSError **)error;
 @end
-
-// Getter-setter for ChatSDKJSBridgeDelegate
-@interface NSURLCache (ChatSDKJSBridge)
-+ (id <ChatSDKJSBridgeDelegate>)ChatSDKJSBridgeDelegate;
-
-+ (void)setChatSDKJSBridgeDelegate:(id <ChatSDKJSBridgeDelegate>)delegate;
-
-
-@end
\ No newline at end of file
@@ -8,108 +8,174 @@
 
 #import "ChatSDKJSBridge.h"
 #import "ChatSDKBridgeAction.h"
+#import "ChatSDKBridgeActionRegistry.h"
+#import "ChatSDKBridgeCodec.h"
+#import "ChatSDKBridgeMetrics.h"
+#import "ChatSDKAssetCache.h"
+
+// Seconds the web view may reuse a bridge preflight, WebKit caps it lower on its own
+static const NSInteger kChatSDKPreflightMaxAge = 86400;
 
 @implementation ChatSDKJSBridge
 
 @synthesize delegate = bridgeDelegate;
+@synthesize assetCache = _assetCache;
 
 //Method to intercept url & extract query parameters
 - (NSCachedURLResponse *)cachedResponseForRequest:(NSURLRequest *)request
 {
-    NSLog(@"URL = %@",[request URL]);    
     NSURL *url = [request URL];
+    ChatSDKBridgeURLKind kind = [ChatSDKBridgeCodec kindOfURL:url];
     
-    //Finding if URL contains chat_exec & extracting query parameterss
-    if ([[url absoluteString] rangeOfString:@"/!chat_exec/"].location != NSNotFound)
+    // If URL does not contain chat_exec, system will handle it
+    if (kind == ChatSDKBridgeURLNone)
     {
-        NSString *action = nil;
-        if ([[url pathComponents] count] > 1)
+        NSCachedURLResponse *assetResponse = [self.assetCache cachedResponseForRequest:request];
+        if (assetResponse)
         {
-            //Getting method name using lastPathComponent
-            action = [url lastPathComponent];
+            return assetResponse;
         }
-        NSString *queryString = [url query];
-        
-        NSString *methodName = [request HTTPMethod];
+        return [super cachedResponseForRequest:request];
+    }
     
-        //Checking if method name is OPTIONS and changing it to GET
-        if([methodName isEqualToString:@"OPTIONS"])
-        {
-            NSDictionary *headerFields= [request allHTTPHeaderFields];
-            NSString *headerString=[headerFields objectForKey:@"Access-Control-Request-Method"];
-            if ([headerString isEqualToString:@"GET"] )
-            {
-                methodName=@"GET";
+    //CORS preflight of a bridge call, answered on its own & cacheable so the action is not run twice
+    if ([[request HTTPMethod] isEqualToString:@"OPTIONS"])
+    {
+        return [self preflightResponseForRequest:request];
+    }
+    
+    NSTimeInterval startTime = [NSDate timeIntervalSinceReferenceDate];
+    NSString *queryString = [url query];
+    
+    //Batch of calls queued by the chat app, answered with the array of their results
+    if (kind == ChatSDKBridgeURLBatch)
+    {
+        NSArray *results = [ChatSDKJSBridge resultsOfBatch:queryString withDelegate:self.delegate];
+        NSMutableArray *callIds = [NSMutableArray arrayWithCapacity:[results count]];
+        for (id result in results) {
+            id callId = [result isKindOfClass:[NSDictionary class]] ? [result objectForKey:@"id"] : nil;
+            if (callId) {
+                [callIds addObject:callId];
             }
         }
-        
-        NSDictionary *parameters = nil;    
-        //Converting encoded parameters JSON Object into NSDictionary
-        @try {
-            if ([methodName isEqualToString:@"GET"])
-            {
-                NSString *encodedQueryString = [queryString stringByReplacingPercentEscapesUsingEncoding:NSASCIIStringEncoding];
-                parameters = [NSJSONSerialization JSONObjectWithData:[encodedQueryString dataUsingEncoding:NSUTF8StringEncoding] options:kNilOptions error:NULL];
-            } 
-        }
-        @catch (NSException *e) {
-            NSLog(@"Execption in paramerts JSON to NSDictionary conversion %@",[e description]);
-        }
-        
-        NSLog(@"REQUEST : ACTION=%@, PARAMS=%@",action,parameters);
-        
-        ChatSDKBridgeAction *bridgeAction = [[ChatSDKBridgeAction alloc] initWithAction:action andParams:parameters];
-        NSError *bridgeError = nil;
-        
-        NSMutableDictionary *nativeResult = [[self.delegate executeNative:bridgeAction error:&bridgeError] mutableCopy];
-        
-        // Sending error message to JS
-        if (bridgeError) {
-            [nativeResult setObject:@{ @"code" : [NSNumber numberWithInt:bridgeError.code], @"message" : [bridgeError localizedDescription] } forKey:@"error"];
-        }
-        
-        NSLog(@"RESPONSE : %@",nativeResult);
+        NSCachedURLResponse *batchResponse = [self cachedResponseForRequest:request withJSONObject:results callId:[callIds componentsJoinedByString:@","]];
+        [[ChatSDKBridgeMetrics sharedMetrics] recordAction:@"!batch" bridgeTime:[NSDate timeIntervalSinceReferenceDate] - startTime requestBytes:[queryString length] responseBytes:[[batchResponse data] length]];
+        return batchResponse;
+    }
     
-        // Creating response object
-        NSCachedURLResponse *cachedURLResponse = nil;
-        if (nativeResult) {
-            NSError *error = nil;
-            NSData *data = [NSJSONSerialization dataWithJSONObject:nativeResult options:NSJSONWritingPrettyPrinted error:&error];
-            NSString *dataString = [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
-      
-            NSData *bodyData = [dataString dataUsingEncoding:NSUTF8StringEncoding];
-            NSDictionary *headers = @{@"Access-Control-Allow-Origin" : @"*", @"Access-Control-Allow-Headers" : @"Origin, x-requested-with, content-type, accept" ,@"Access-Control-Request-Method":@"POST",@"MIMEType" : @"application/json", @"Cache-Control": @"max-age=315360000" , @"Expires": @"Fri, 01 May 2020 03:47:24 GMT" ,@"Last-Modified" : @"" , @"Etag" : @""};
-            NSHTTPURLResponse *urlResponse = [[NSHTTPURLResponse alloc] initWithURL:request.URL statusCode:200 HTTPVersion:@"1.1" headerFields:headers];
-            cachedURLResponse = [[NSCachedURLResponse alloc] initWithResponse:urlResponse data:bodyData];
-      
-        }
-        return cachedURLResponse;
+    //Extracting action & query parameters of chat_exec
+    NSString *action = nil;
+    if ([[url pathComponents] count] > 1)
+    {
+        //Getting method name using lastPathComponent
+        action = [url lastPathComponent];
     }
-  
-    // If URL does not contain chat_exec, system will handle it
-    return [super cachedResponseForRequest:request];
+    NSString *methodName = [request HTTPMethod];
+    
+    ChatSDKBridgeAction *bridgeAction = [ChatSDKJSBridge bridgeActionWithName:action query:([methodName isEqualToString:@"GET"] ? queryString : nil)];
+    
+    NSDictionary *nativeResult = [ChatSDKJSBridge resultOfAction:bridgeAction withDelegate:self.delegate];
+    
+    NSCachedURLResponse *callResponse = [self cachedResponseForRequest:request withJSONObject:nativeResult callId:[bridgeAction.params objectForKey:@"id"]];
+    // An async action is recorded by its registry when it completes
+    if (![ChatSDKBridgeActionRegistry isIgnoreEnvelope:nativeResult]) {
+        [[ChatSDKBridgeMetrics sharedMetrics] recordAction:bridgeAction.action bridgeTime:[NSDate timeIntervalSinceReferenceDate] - startTime requestBytes:[queryString length] responseBytes:[[callResponse data] length]];
+    }
+    return callResponse;
 }
 
-@end
+// Bridge calls are answered here only, never stored
+- (void)storeCachedResponse:(NSCachedURLResponse *)cachedResponse forRequest:(NSURLRequest *)request
+{
+    if ([ChatSDKBridgeCodec kindOfURL:[request URL]] != ChatSDKBridgeURLNone) {
+        return;
+    }
+    [super storeCachedResponse:cachedResponse forRequest:request];
+}
 
+- (NSCachedURLResponse *)preflightResponseForRequest:(NSURLRequest *)request
+{
+    NSString *requestHeaders = [request valueForHTTPHeaderField:@"Access-Control-Request-Headers"];
+    NSDictionary *headers = @{@"Access-Control-Allow-Origin" : @"*",
+                              @"Access-Control-Allow-Methods" : @"GET, POST, OPTIONS",
+                              @"Access-Control-Allow-Headers" : requestHeaders ? requestHeaders : @"Origin, x-requested-with, content-type, accept",
+                              @"Access-Control-Max-Age" : [NSString stringWithFormat:@"%ld",(long)kChatSDKPreflightMaxAge],
+                              @"Content-Length" : @"0"};
+    NSHTTPURLResponse *urlResponse = [[NSHTTPURLResponse alloc] initWithURL:request.URL statusCode:200 HTTPVersion:@"1.1" headerFields:headers];
+    return [[NSCachedURLResponse alloc] initWithResponse:urlResponse data:[NSData data] userInfo:nil storagePolicy:NSURLCacheStorageNotAllowed];
+}
 
+// Creating response object, nil when there is nothing to answer. Every call gets a fresh, non-cacheable answer keyed by its id.
+- (NSCachedURLResponse *)cachedResponseForRequest:(NSURLRequest *)request withJSONObject:(id)object callId:(id)callId
+{
+    NSCachedURLResponse *cachedURLResponse = nil;
+    if (object) {
+        NSData *bodyData = [ChatSDKBridgeCodec dataWithJSONObject:object];
+        if (bodyData == nil) {
+            return nil;
+        }
+        
+        NSString *etag = [NSString stringWithFormat:@"\"%@\"",callId ? callId : @""];
+        NSDictionary *headers = @{@"Access-Control-Allow-Origin" : @"*", @"Access-Control-Allow-Headers" : @"Origin, x-requested-with, content-type, accept" ,@"Access-Control-Request-Method":@"POST",@"MIMEType" : @"application/json", @"Content-Type" : @"application/json", @"Cache-Control": @"no-store, no-cache, must-revalidate" , @"Pragma" : @"no-cache" , @"Expires": @"0" , @"Etag" : etag};
+        NSHTTPURLResponse *urlResponse = [[NSHTTPURLResponse alloc] initWithURL:request.URL statusCode:200 HTTPVersion:@"1.1" headerFields:headers];
+        cachedURLResponse = [[NSCachedURLResponse alloc] initWithResponse:urlResponse data:bodyData userInfo:nil storagePolicy:NSURLCacheStorageNotAllowed];
+    }
+    return cachedURLResponse;
+}
 
-@implementation NSURLCache (ChatSDKJSBridge)
++ (ChatSDKBridgeAction *)bridgeActionWithName:(NSString *)action query:(NSString *)query
+{
+    //Converting encoded parameters JSON Object into NSDictionary
+    NSDictionary *parameters = [ChatSDKBridgeCodec JSONObjectWithPercentEncodedQuery:query];
+    if (![parameters isKindOfClass:[NSDictionary class]]) {
+        parameters = nil;
+    }
+    
+    return [[ChatSDKBridgeAction alloc] initWithAction:action andParams:parameters];
+}
 
-+ (id <ChatSDKJSBridgeDelegate>)ChatSDKJSBridgeDelegate {
-  NSURLCache *sharedURLCache = [NSURLCache sharedURLCache];
-  if ([sharedURLCache isKindOfClass:[ChatSDKJSBridge class]]) {
-    return [(ChatSDKJSBridge *) sharedURLCache delegate];
-  }
-  return nil;
++ (NSArray *)resultsOfBatch:(NSString *)query withDelegate:(id <ChatSDKJSBridgeDelegate>)delegate
+{
+    NSArray *calls = [ChatSDKBridgeCodec JSONObjectWithPercentEncodedQuery:query];
+    if (![calls isKindOfClass:[NSArray class]]) {
+        return [NSArray array];
+    }
+    
+    NSMutableArray *results = [NSMutableArray arrayWithCapacity:[calls count]];
+    for (NSDictionary *call in calls) {
+        id result = nil;
+        if ([call isKindOfClass:[NSDictionary class]]) {
+            // params is what a single call sends as query, its id is the call id
+            NSMutableDictionary *params = [NSMutableDictionary dictionary];
+            if ([[call objectForKey:@"params"] isKindOfClass:[NSDictionary class]]) {
+                [params addEntriesFromDictionary:[call objectForKey:@"params"]];
+            }
+            if ([call objectForKey:@"id"] && ![params objectForKey:@"id"]) {
+                [params setObject:[call objectForKey:@"id"] forKey:@"id"];
+            }
+            ChatSDKBridgeAction *bridgeAction = [[ChatSDKBridgeAction alloc] initWithAction:[call objectForKey:@"action"] andParams:params];
+            result = [ChatSDKJSBridge resultOfAction:bridgeAction withDelegate:delegate];
+        }
+        [results addObject:result ? result : [NSNull null]];
+    }
+    return results;
 }
 
-+ (void)setChatSDKJSBridgeDelegate:(id <ChatSDKJSBridgeDelegate>)delegate {
-  NSURLCache *sharedURLCache = [NSURLCache sharedURLCache];
-  if ([sharedURLCache isKindOfClass:[ChatSDKJSBridge class]]) {
-    [(ChatSDKJSBridge *) sharedURLCache setDelegate:delegate];
-  }
++ (NSDictionary *)resultOfAction:(ChatSDKBridgeAction *)action withDelegate:(id <ChatSDKJSBridgeDelegate>)delegate
+{
+    NSError *bridgeError = nil;
+    
+    NSTimeInterval startTime = [NSDate timeIntervalSinceReferenceDate];
+    NSMutableDictionary *nativeResult = [[delegate executeNative:action error:&bridgeError] mutableCopy];
+    if (![ChatSDKBridgeActionRegistry isIgnoreEnvelope:nativeResult]) {
+        [[ChatSDKBridgeMetrics sharedMetrics] recordAction:action.action nativeTime:[NSDate timeIntervalSinceReferenceDate] - startTime failed:(bridgeError != nil)];
+    }
+    
+    // Sending error message to JS
+    if (bridgeError) {
+        [nativeResult setObject:@{ @"code" : [NSNumber numberWithInt:bridgeError.code], @"message" : [bridgeError localizedDescription] } forKey:@"error"];
+    }
+    return nativeResult;
 }
 
 @end
-
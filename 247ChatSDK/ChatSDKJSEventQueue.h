@@ -0,0 +1,38 @@
+//
+//  ChatSDKJSEventQueue.h
+//  247ChatSDK
+//
+//  Copyright (c) 2014 . All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+typedef void (^ChatSDKJSEventDispatchHandler)(NSString *script);
+
+/*
+ * ChatSDKJSEventQueue  Native -> JS calls of one main run loop turn, evaluated as one script.
+                        A call with a coalescing key replaces the pending call of the same key,
+                        e.g. only the latest location is sent. Arguments are serialized to JSON at
+                        flush, so superseded calls cost nothing. Main queue only.
+ */
+@interface ChatSDKJSEventQueue : NSObject
+
+// Number of calls waiting for the next flush
+@property (nonatomic, readonly) NSUInteger pendingCount;
+
+// handler gets the combined script of each flush, it is not called for an empty queue
+-(id)initWithDispatchHandler:(ChatSDKJSEventDispatchHandler)handler;
+
+// Queues function(<argument as JSON>); key may be nil
+-(void)enqueueFunction:(NSString *)function argument:(id)argument coalescingKey:(NSString *)key;
+
+// Queues a ready made script, never coalesced
+-(void)enqueueScript:(NSString *)script;
+
+// Runs the pending calls now instead of at the end of the run loop turn
+-(void)flush;
+
+// Drops the pending calls, e.g. when the chat view goes away
+-(void)clear;
+
+@end
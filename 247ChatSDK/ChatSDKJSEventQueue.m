@@ -0,0 +1,119 @@
+//
+//  ChatSDKJSEventQueue.m
+//  247ChatSDK
+//
+//  Copyright (c) 2014 . All rights reserved.
+//
+
+#import "ChatSDKJSEventQueue.h"
+
+@interface ChatSDKJSEvent : NSObject
+@property (nonatomic, strong) NSString *function;
+@property (nonatomic, strong) id argument;
+@property (nonatomic, strong) NSString *script;
+@end
+
+@implementation ChatSDKJSEvent
+@end
+
+@interface ChatSDKJSEventQueue ()
+{
+    ChatSDKJSEventDispatchHandler dispatchHandler;
+    // ChatSDKJSEvent in call order
+    NSMutableArray *events;
+    // coalescing key -> ChatSDKJSEvent
+    NSMutableDictionary *coalescedEvents;
+    BOOL flushScheduled;
+}
+@end
+
+@implementation ChatSDKJSEventQueue
+
+-(id)initWithDispatchHandler:(ChatSDKJSEventDispatchHandler)handler
+{
+    self = [super init];
+    if (self) {
+        dispatchHandler = [handler copy];
+        events = [[NSMutableArray alloc] init];
+        coalescedEvents = [[NSMutableDictionary alloc] init];
+    }
+    return self;
+}
+
+-(NSUInteger)pendingCount
+{
+    return [events count];
+}
+
+-(void)enqueueFunction:(NSString *)function argument:(id)argument coalescingKey:(NSString *)key
+{
+    ChatSDKJSEvent *event = key ? [coalescedEvents objectForKey:key] : nil;
+    if (event) {
+        // Superseded, the newer argument takes the place of the older call
+        event.function = function;
+        event.argument = argument;
+        return;
+    }
+    event = [[ChatSDKJSEvent alloc] init];
+    event.function = function;
+    event.argument = argument;
+    if (key) {
+        [coalescedEvents setObject:event forKey:key];
+    }
+    [self addEvent:event];
+}
+
+-(void)enqueueScript:(NSString *)script
+{
+    if (script == nil) {
+        return;
+    }
+    ChatSDKJSEvent *event = [[ChatSDKJSEvent alloc] init];
+    event.script = script;
+    [self addEvent:event];
+}
+
+-(void)addEvent:(ChatSDKJSEvent *)event
+{
+    [events addObject:event];
+    if (!flushScheduled) {
+        flushScheduled = YES;
+        dispatch_async(dispatch_get_main_queue(), ^(void) {
+            [self flush];
+        });
+    }
+}
+
+-(void)flush
+{
+    flushScheduled = NO;
+    if ([events count] == 0) {
+        return;
+    }
+    NSArray *pending = events;
+    events = [[NSMutableArray alloc] init];
+    [coalescedEvents removeAllObjects];
+
+    NSMutableString *script = [NSMutableString string];
+    for (ChatSDKJSEvent *event in pending) {
+        // A throwing call must not stop the ones after it
+        if (event.script) {
+            [script appendFormat:@"try{%@;}catch(e){}",event.script];
+            continue;
+        }
+        NSData *jsonData = event.argument ? [NSJSONSerialization dataWithJSONObject:event.argument options:0 error:NULL] : nil;
+        NSString *json = jsonData ? [[NSString alloc] initWithData:jsonData encoding:NSUTF8StringEncoding] : @"";
+        [script appendFormat:@"try{%@(%@);}catch(e){}",event.function,json];
+    }
+    if (dispatchHandler) {
+        dispatchHandler(script);
+    }
+}
+
+-(void)clear
+{
+    [events removeAllObjects];
+    [coalescedEvents removeAllObjects];
+}
+
+@end
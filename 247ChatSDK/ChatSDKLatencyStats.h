@@ -0,0 +1,23 @@
+//
+//  ChatSDKLatencyStats.h
+//  247ChatSDK
+//
+//  Copyright (c) 2014 . All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+// Latencies (in seconds) of the last few requests to one endpoint. Not thread safe.
+@interface ChatSDKLatencyStats : NSObject
+
+// Number of samples held, at most the window size
+@property (nonatomic, readonly) NSUInteger count;
+
+-(id)initWithWindowSize:(NSUInteger)windowSize;
+
+-(void)addSample:(NSTimeInterval)latency;
+
+// percentile in 0...1, e.g. 0.95. Returns 0 when there are no samples.
+-(NSTimeInterval)latencyAtPercentile:(double)percentile;
+
+@end
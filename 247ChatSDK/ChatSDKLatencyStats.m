@@ -0,0 +1,70 @@
+//
+//  ChatSDKLatencyStats.m
+//  247ChatSDK
+//
+//  Copyright (c) 2014 . All rights reserved.
+//
+
+#import "ChatSDKLatencyStats.h"
+
+@interface ChatSDKLatencyStats ()
+{
+    NSTimeInterval *samples;
+    NSUInteger windowSize;
+    NSUInteger next;
+}
+@property (nonatomic, readwrite) NSUInteger count;
+@end
+
+@implementation ChatSDKLatencyStats
+
+@synthesize count = _count;
+
+-(id)initWithWindowSize:(NSUInteger)size
+{
+    self = [super init];
+    if (self) {
+        windowSize = MAX(size, 1);
+        samples = calloc(windowSize, sizeof(NSTimeInterval));
+    }
+    return self;
+}
+
+-(void)dealloc
+{
+    free(samples);
+}
+
+-(void)addSample:(NSTimeInterval)latency
+{
+    // Ring buffer, the oldest sample is overwritten once the window is full
+    samples[next] = latency;
+    next = (next + 1) % windowSize;
+    if (_count < windowSize) {
+        _count++;
+    }
+}
+
+static int compareIntervals(const void *a, const void *b)
+{
+    NSTimeInterval x = *(const NSTimeInterval *)a;
+    NSTimeInterval y = *(const NSTimeInterval *)b;
+    return (x > y) - (x < y);
+}
+
+-(NSTimeInterval)latencyAtPercentile:(double)percentile
+{
+    if (_count == 0) {
+        return 0;
+    }
+    NSTimeInterval sorted[_count];
+    memcpy(sorted, samples, _count * sizeof(NSTimeInterval));
+    qsort(sorted, _count, sizeof(NSTimeInterval), compareIntervals);
+
+    double clamped = MIN(MAX(percentile, 0.0), 1.0);
+    NSUInteger index = (NSUInteger)ceil(clamped * _count);
+    index = index > 0 ? index - 1 : 0;
+    return sorted[index];
+}
+
+@end
@@ -0,0 +1,59 @@
+//
+//  ChatSDKLayoutEngine.h
+//  247ChatSDK
+//
+//  Copyright (c) 2014 . All rights reserved.
+//
+
+#import <UIKit/UIKit.h>
+
+@class ChatSDKConfiguration;
+
+typedef enum {
+    // iPhone before iOS 7, shortened by the keyboard
+    ChatSDKWebViewLayoutPhone,
+    // iPhone on iOS 7, the web view scrolls above the keyboard itself
+    ChatSDKWebViewLayoutPhoneFullHeight,
+    // iPad, sized & aligned by chatsdkdefaults.plist
+    ChatSDKWebViewLayoutPad
+}ChatSDKWebViewLayoutStyle;
+
+// Geometry of a view, center & bounds do not depend on the transform unlike the frame
+typedef struct {
+    CGPoint center;
+    CGRect bounds;
+    CGAffineTransform transform;
+} ChatSDKViewLayout;
+
+/*
+ * ChatSDKLayoutEngine  Frames of the chat web view & the maximize button for one screen size & configuration,
+                        computed once for every orientation so that a rotation only looks the layout up.
+                        Keyboard dependent layouts are kept for the last keyboard height of each orientation.
+                        Main thread only.
+ */
+@interface ChatSDKLayoutEngine : NSObject
+
+@property (nonatomic, readonly, assign) CGSize screenSize;
+@property (nonatomic, readonly, strong) ChatSDKConfiguration *configuration;
+
+// Engine of the main screen & the shared configuration, replaced once either of them changed
++(ChatSDKLayoutEngine *)currentEngine;
+
+-(id)initWithScreenSize:(CGSize)screenSize configuration:(ChatSDKConfiguration *)configuration;
+
+// NO for an unknown orientation
+-(BOOL)getWebViewLayout:(ChatSDKViewLayout *)layout style:(ChatSDKWebViewLayoutStyle)style orientation:(UIInterfaceOrientation)orientation keyboardHeight:(CGFloat)keyboardHeight;
+
+// Positions are ChatSDKButtonPosition values
+-(BOOL)getButtonLayout:(ChatSDKViewLayout *)layout portraitPosition:(int)portraitPosition landscapePosition:(int)landscapePosition orientation:(UIInterfaceOrientation)orientation;
+
+// Translation taking the web view off screen in the configured animation style
+-(CGPoint)webViewAnimationOffsetForOrientation:(UIInterfaceOrientation)orientation;
+
+// Translation hiding the button behind the screen edge it is attached to
+-(CGPoint)buttonAnimationOffsetAtPortraitPosition:(int)portraitPosition landscapePosition:(int)landscapePosition orientation:(UIInterfaceOrientation)orientation;
+
+@end
+
+// Assigns the parts of layout that differ from the view's, returns NO when the view was already laid out so
+BOOL ChatSDKApplyViewLayout(UIView *view, ChatSDKViewLayout layout);
@@ -0,0 +1,371 @@
+//
+//  ChatSDKLayoutEngine.m
+//  247ChatSDK
+//
+//  Copyright (c) 2014 . All rights reserved.
+//
+
+#import "ChatSDKLayoutEngine.h"
+#import "ChatSDKConfiguration.h"
+#import "ChatSDKConstants.h"
+
+#define kOrientationCount 4
+#define kButtonPositionCount 8
+#define kStatusBarHeight 20.0f
+
+// Offset & quarter turns of the button attached at a position, by orientation index
+typedef struct {
+    CGFloat tx;
+    CGFloat ty;
+    int quarterTurns;
+} ChatSDKButtonRotation;
+
+static const ChatSDKButtonRotation kButtonRotations[kOrientationCount][kButtonPositionCount] = {
+    // Portrait
+    {{10,10,1}, {0,0,4}, {-10,10,3}, {-10,10,3}, {10,10,3}, {0,0,4}, {-10,10,1}, {10,10,1}},
+    // Portrait upside down
+    {{10,10,3}, {0,0,2}, {0,10,1}, {0,10,1}, {10,10,1}, {0,0,2}, {-10,10,3}, {10,10,3}},
+    // Landscape left
+    {{10,20,4}, {0,0,3}, {-10,0,2}, {-10,0,2}, {10,0,2}, {0,0,3}, {-10,20,4}, {10,20,4}},
+    // Landscape right
+    {{10,0,2}, {10,0,1}, {-10,20,4}, {-10,20,4}, {10,20,4}, {10,0,1}, {-10,0,2}, {10,0,2}}
+};
+
+static int orientationIndex(UIInterfaceOrientation orientation)
+{
+    switch (orientation) {
+        case UIInterfaceOrientationPortrait: return 0;
+        case UIInterfaceOrientationPortraitUpsideDown: return 1;
+        case UIInterfaceOrientationLandscapeLeft: return 2;
+        case UIInterfaceOrientationLandscapeRight: return 3;
+        default: return -1;
+    }
+}
+
+static const UIInterfaceOrientation kOrientations[kOrientationCount] = {
+    UIInterfaceOrientationPortrait,
+    UIInterfaceOrientationPortraitUpsideDown,
+    UIInterfaceOrientationLandscapeLeft,
+    UIInterfaceOrientationLandscapeRight
+};
+
+static ChatSDKViewLayout layoutWithFrame(CGRect frame, CGSize boundsSize, CGAffineTransform transform)
+{
+    ChatSDKViewLayout layout;
+    layout.center = CGPointMake(CGRectGetMidX(frame), CGRectGetMidY(frame));
+    layout.bounds = CGRectMake(0, 0, boundsSize.width, boundsSize.height);
+    layout.transform = transform;
+    return layout;
+}
+
+// Screen coordinates of an offset given in the coordinates of the interface
+static CGPoint rotatedOffset(CGPoint offset, UIInterfaceOrientation orientation)
+{
+    switch (orientation) {
+        case UIInterfaceOrientationPortraitUpsideDown: return CGPointMake(-offset.x, -offset.y);
+        case UIInterfaceOrientationLandscapeLeft: return CGPointMake(offset.y, -offset.x);
+        case UIInterfaceOrientationLandscapeRight: return CGPointMake(-offset.y, offset.x);
+        default: return offset;
+    }
+}
+
+BOOL ChatSDKApplyViewLayout(UIView *view, ChatSDKViewLayout layout)
+{
+    BOOL changed = NO;
+    if (!CGAffineTransformEqualToTransform(view.transform, layout.transform)) {
+        view.transform = layout.transform;
+        changed = YES;
+    }
+    if (!CGRectEqualToRect(view.bounds, layout.bounds)) {
+        view.bounds = layout.bounds;
+        changed = YES;
+    }
+    if (!CGPointEqualToPoint(view.center, layout.center)) {
+        view.center = layout.center;
+        changed = YES;
+    }
+    return changed;
+}
+
+@interface ChatSDKLayoutEngine ()
+{
+    ChatSDKViewLayout webViewLayouts[3][kOrientationCount];
+    ChatSDKViewLayout buttonLayouts[kOrientationCount][kButtonPositionCount];
+    // ChatSDKWebViewLayoutPhone with the keyboard up
+    ChatSDKViewLayout keyboardLayouts[kOrientationCount];
+    CGFloat keyboardHeights[kOrientationCount];
+}
+@end
+
+@implementation ChatSDKLayoutEngine
+
+@synthesize screenSize = _screenSize;
+@synthesize configuration = _configuration;
+
++(ChatSDKLayoutEngine *)currentEngine
+{
+    static ChatSDKLayoutEngine *currentEngine = nil;
+    CGSize screenSize = [[UIScreen mainScreen] bounds].size;
+    ChatSDKConfiguration *configuration = [ChatSDKConfiguration sharedConfiguration];
+    if (currentEngine == nil || currentEngine.configuration != configuration || !CGSizeEqualToSize(currentEngine.screenSize, screenSize)) {
+        currentEngine = [[ChatSDKLayoutEngine alloc] initWithScreenSize:screenSize configuration:configuration];
+    }
+    return currentEngine;
+}
+
+-(id)initWithScreenSize:(CGSize)screenSize configuration:(ChatSDKConfiguration *)configuration
+{
+    if (self = [super init]) {
+        _screenSize = screenSize;
+        _configuration = configuration;
+        for (int o = 0; o < kOrientationCount; o++) {
+            webViewLayouts[ChatSDKWebViewLayoutPhone][o] = [self phoneLayoutForOrientation:kOrientations[o] keyboardHeight:0];
+            webViewLayouts[ChatSDKWebViewLayoutPhoneFullHeight][o] = [self phoneFullHeightLayoutForOrientation:kOrientations[o]];
+            webViewLayouts[ChatSDKWebViewLayoutPad][o] = [self padLayoutForOrientation:kOrientations[o]];
+            for (int p = 0; p < kButtonPositionCount; p++) {
+                buttonLayouts[o][p] = [self buttonLayoutAtPosition:p orientation:kOrientations[o]];
+            }
+        }
+    }
+    return self;
+}
+
+-(BOOL)getWebViewLayout:(ChatSDKViewLayout *)layout style:(ChatSDKWebViewLayoutStyle)style orientation:(UIInterfaceOrientation)orientation keyboardHeight:(CGFloat)keyboardHeight
+{
+    int o = orientationIndex(orientation);
+    if (o < 0) {
+        return NO;
+    }
+    if (style == ChatSDKWebViewLayoutPhone && keyboardHeight > 0) {
+        if (keyboardHeights[o] != keyboardHeight) {
+            keyboardLayouts[o] = [self phoneLayoutForOrientation:orientation keyboardHeight:keyboardHeight];
+            keyboardHeights[o] = keyboardHeight;
+        }
+        *layout = keyboardLayouts[o];
+        return YES;
+    }
+    *layout = webViewLayouts[style][o];
+    return YES;
+}
+
+-(BOOL)getButtonLayout:(ChatSDKViewLayout *)layout portraitPosition:(int)portraitPosition landscapePosition:(int)landscapePosition orientation:(UIInterfaceOrientation)orientation
+{
+    int o = orientationIndex(orientation);
+    int position = UIInterfaceOrientationIsLandscape(orientation) ? landscapePosition : portraitPosition;
+    if (o < 0 || position < 0 || position >= kButtonPositionCount) {
+        return NO;
+    }
+    *layout = buttonLayouts[o][position];
+    return YES;
+}
+
+-(CGPoint)webViewAnimationOffsetForOrientation:(UIInterfaceOrientation)orientation
+{
+    // Portrait offset, the screen is turned under the other orientations
+    CGFloat distance = UIInterfaceOrientationIsLandscape(orientation) ? _screenSize.width : _screenSize.height;
+    CGPoint offset = CGPointZero;
+    switch (_configuration.animationStyle) {
+        case ChatSDKAnimationTopBottom: offset = CGPointMake(0, -distance); break;
+        case ChatSDKAnimationBottomTop: offset = CGPointMake(0, distance); break;
+        case ChatSDKAnimationLeftRight: offset = CGPointMake(-distance, 0); break;
+        case ChatSDKAnimationRightLeft: offset = CGPointMake(distance, 0); break;
+    }
+    return rotatedOffset(offset, orientation);
+}
+
+-(CGPoint)buttonAnimationOffsetAtPortraitPosition:(int)portraitPosition landscapePosition:(int)landscapePosition orientation:(UIInterfaceOrientation)orientation
+{
+    int position = UIInterfaceOrientationIsLandscape(orientation) ? landscapePosition : portraitPosition;
+    CGFloat distance = MAXIMIZE_BUTTON_HEIGHT;
+    CGPoint offset = CGPointZero;
+    if (position == ChatSDKButtonPositionTopRight || position == ChatSDKButtonPositionMiddleRight || position == ChatSDKButtonPositionBottomRight) {
+        offset = CGPointMake(distance, 0);
+    } else if (position == ChatSDKButtonPositionTopLeft || position == ChatSDKButtonPositionBottomLeft || position == ChatSDKButtonPositionMiddleLeft) {
+        offset = CGPointMake(-distance, 0);
+    } else if (position == ChatSDKButtonPositionTopCenter) {
+        offset = CGPointMake(0, -distance);
+    } else if (position == ChatSDKButtonPositionBottomCenter) {
+        offset = CGPointMake(0, distance);
+    }
+    return rotatedOffset(offset, orientation);
+}
+
+#pragma mark Web view
+
+-(ChatSDKViewLayout)phoneLayoutForOrientation:(UIInterfaceOrientation)orientation keyboardHeight:(CGFloat)keyboardHeight
+{
+    CGFloat deviceHeight = _screenSize.height;
+    if (orientation == UIInterfaceOrientationLandscapeLeft) {
+        CGRect frame = CGRectMake(kStatusBarHeight, 0, 300.0f - keyboardHeight, deviceHeight);
+        return layoutWithFrame(frame, CGSizeMake(frame.size.height, frame.size.width), CGAffineTransformMakeRotation(3*M_PI/2));
+    }
+    if (orientation == UIInterfaceOrientationLandscapeRight) {
+        CGRect frame = CGRectMake(keyboardHeight, 0, 300.0f - keyboardHeight, deviceHeight);
+        return layoutWithFrame(frame, CGSizeMake(frame.size.height, frame.size.width), CGAffineTransformMakeRotation(M_PI/2));
+    }
+    CGRect frame = CGRectMake(0, kStatusBarHeight, 320.0f, deviceHeight - kStatusBarHeight - keyboardHeight);
+    return layoutWithFrame(frame, frame.size, CGAffineTransformIdentity);
+}
+
+-(ChatSDKViewLayout)phoneFullHeightLayoutForOrientation:(UIInterfaceOrientation)orientation
+{
+    CGFloat deviceHeight = _screenSize.height;
+    if (orientation == UIInterfaceOrientationLandscapeLeft) {
+        return layoutWithFrame(CGRectMake(kStatusBarHeight, 0, 300, deviceHeight), CGSizeMake(deviceHeight, 300), CGAffineTransformMakeRotation(3*M_PI/2));
+    }
+    if (orientation == UIInterfaceOrientationLandscapeRight) {
+        return layoutWithFrame(CGRectMake(0, 0, 300, deviceHeight), CGSizeMake(deviceHeight, 300), CGAffineTransformMakeRotation(M_PI/2));
+    }
+    return layoutWithFrame(CGRectMake(0, kStatusBarHeight, 320, deviceHeight - kStatusBarHeight), CGSizeMake(320, deviceHeight - kStatusBarHeight), CGAffineTransformIdentity);
+}
+
+-(ChatSDKViewLayout)padLayoutForOrientation:(UIInterfaceOrientation)orientation
+{
+    CGFloat deviceWidth = _screenSize.width;
+    CGFloat deviceHeight = _screenSize.height;
+    CGFloat widthPortrait = floor((_configuration.width.portrait / 100) * deviceWidth);
+    CGFloat heightPortrait = floor((_configuration.height.portrait / 100) * deviceHeight);
+    //reading height in width and width in height
+    CGFloat widthLandscape = floor((_configuration.width.landscape / 100) * deviceWidth);
+    CGFloat heightLandscape = floor((_configuration.height.landscape / 100) * deviceHeight);
+    CGPoint margin = [self padMarginsForOrientation:orientation];
+
+    if (orientation == UIInterfaceOrientationLandscapeLeft || orientation == UIInterfaceOrientationLandscapeRight) {
+        CGSize boundsSize = CGSizeMake(floor((_configuration.width.landscape / 100) * deviceHeight), floor((_configuration.height.landscape / 100) * deviceWidth));
+        CGAffineTransform transform = CGAffineTransformMakeRotation(orientation == UIInterfaceOrientationLandscapeLeft ? 3*M_PI/2 : M_PI/2);
+        return layoutWithFrame(CGRectMake(margin.x, margin.y, heightLandscape, widthLandscape), boundsSize, transform);
+    }
+    return layoutWithFrame(CGRectMake(margin.x, margin.y, widthPortrait, heightPortrait - margin.y), CGSizeMake(widthPortrait, heightPortrait - margin.y), CGAffineTransformIdentity);
+}
+
+// Origin of the iPad web view, landscape margins are given in the rotated coordinates
+-(CGPoint)padMarginsForOrientation:(UIInterfaceOrientation)orientation
+{
+    CGFloat screenWidth = _screenSize.width;
+    CGFloat screenHeight = _screenSize.height;
+    CGFloat widthPortrait = floor((_configuration.width.portrait / 100) * screenWidth);
+    CGFloat heightPortrait = floor((_configuration.height.portrait / 100) * screenHeight);
+    CGFloat widthLandscape = floor((_configuration.width.landscape / 100) * screenWidth);
+    CGFloat heightLandscape = floor((_configuration.height.landscape / 100) * screenHeight);
+    //Clipping Fix
+    CGFloat diff = heightLandscape - widthLandscape;
+
+    ChatSDKVerticalAlignment verticalAlign = _configuration.verticalAlignmentPortrait;
+    ChatSDKHorizontalAlignment horizontalAlign = _configuration.horizontalAlignmentPortrait;
+    CGFloat marginLeft = 0;
+    CGFloat marginTop = 0;
+
+    if (orientation == UIInterfaceOrientationPortrait || orientation == UIInterfaceOrientationPortraitUpsideDown) {
+        if (verticalAlign == ChatSDKVerticalAlignmentTop) {
+            marginTop = _configuration.paddingTop.portrait;
+        } else if (verticalAlign == ChatSDKVerticalAlignmentMiddle) {
+            marginTop = (screenHeight - heightPortrait) / 2;
+        } else if (verticalAlign == ChatSDKVerticalAlignmentBottom) {
+            marginTop = screenHeight - heightPortrait;
+        }
+
+        if (horizontalAlign == ChatSDKHorizontalAlignmentLeft) {
+            marginLeft = _configuration.paddingLeft.portrait;
+        } else if (horizontalAlign == ChatSDKHorizontalAlignmentCenter) {
+            marginLeft = (screenWidth - widthPortrait) / 2 + _configuration.paddingLeft.portrait;
+        } else if (horizontalAlign == ChatSDKHorizontalAlignmentRight) {
+            marginLeft = screenWidth - widthPortrait - _configuration.paddingRight.portrait;
+        }
+
+        //Status bar adjustment
+        return CGPointMake(marginLeft, marginTop + kStatusBarHeight);
+    }
+
+    if (orientation == UIInterfaceOrientationLandscapeLeft) {
+        if (verticalAlign == ChatSDKVerticalAlignmentTop) {
+            marginTop = _configuration.paddingTop.landscape;
+        } else if (verticalAlign == ChatSDKVerticalAlignmentMiddle) {
+            marginTop = (screenWidth - heightLandscape) / 2;
+        } else if (verticalAlign == ChatSDKVerticalAlignmentBottom) {
+            marginTop = screenWidth - heightLandscape;
+        }
+
+        if (horizontalAlign == ChatSDKHorizontalAlignmentLeft) {
+            marginLeft = screenHeight - widthLandscape - _configuration.paddingLeft.landscape - diff/2;
+            marginTop -= diff/2;
+        } else if (horizontalAlign == ChatSDKHorizontalAlignmentCenter) {
+            marginLeft = (screenHeight - widthLandscape) / 2 - _configuration.paddingLeft.landscape;
+        } else if (horizontalAlign == ChatSDKHorizontalAlignmentRight) {
+            marginLeft = _configuration.paddingRight.landscape + diff/2;
+            marginTop -= diff/2;
+        }
+
+        //Status bar adjustment
+        return CGPointMake(marginTop + kStatusBarHeight, marginLeft);
+    }
+
+    if (orientation == UIInterfaceOrientationLandscapeRight) {
+        if (verticalAlign == ChatSDKVerticalAlignmentTop) {
+            marginTop = screenWidth - heightLandscape - _configuration.paddingTop.landscape;
+        } else if (verticalAlign == ChatSDKVerticalAlignmentMiddle) {
+            marginTop = (screenWidth - heightLandscape) / 2;
+        } else if (verticalAlign == ChatSDKVerticalAlignmentBottom) {
+            marginTop = screenWidth - heightLandscape;
+        }
+
+        if (horizontalAlign == ChatSDKHorizontalAlignmentLeft) {
+            marginLeft = _configuration.paddingLeft.landscape + diff/2;
+            marginTop += diff/2;
+        } else if (horizontalAlign == ChatSDKHorizontalAlignmentCenter) {
+            marginLeft = (screenHeight - widthLandscape) / 2 + _configuration.paddingLeft.landscape;
+        } else if (horizontalAlign == ChatSDKHorizontalAlignmentRight) {
+            marginLeft = screenHeight - widthLandscape - _configuration.paddingRight.landscape - diff/2;
+            marginTop += diff/2;
+        }
+
+        //Status bar adjustment
+        return CGPointMake(marginTop - kStatusBarHeight, marginLeft);
+    }
+    return CGPointZero;
+}
+
+#pragma mark Maximize button
+
+-(ChatSDKViewLayout)buttonLayoutAtPosition:(int)position orientation:(UIInterfaceOrientation)orientation
+{
+    CGFloat screenWidth = _screenSize.width;
+    CGFloat screenHeight = _screenSize.height;
+    CGFloat btnWidth = MAXIMISE_BUTTON_WIDTH;
+    CGFloat btnHeight = MAXIMIZE_BUTTON_HEIGHT;
+
+    // Origins of TL, TM, TR, RM, BR, BM, BL, LM in portrait, the other orientations start further in the list
+    CGPoint origins[kButtonPositionCount] = {
+        CGPointMake(0, 0),
+        CGPointMake((screenWidth - btnWidth) / 2, 0),
+        CGPointMake(screenWidth - btnWidth, 0),
+        CGPointMake(screenWidth - btnWidth, (screenHeight - btnWidth) / 2),
+        CGPointMake(screenWidth - btnWidth, screenHeight - btnWidth),
+        CGPointMake((screenWidth - btnWidth) / 2, screenHeight - btnWidth),
+        CGPointMake(0, screenHeight - btnWidth),
+        CGPointMake(0, (screenHeight - btnWidth) / 2)
+    };
+    int shift = 0;
+    if (orientation == UIInterfaceOrientationLandscapeRight) {
+        shift = 1;
+    } else if (orientation == UIInterfaceOrientationPortraitUpsideDown) {
+        shift = 2;
+    } else if (orientation == UIInterfaceOrientationLandscapeLeft) {
+        shift = 3;
+    }
+    CGPoint origin = origins[(position + shift*2) % kButtonPositionCount];
+
+    //Status bar & landscape patches
+    if (orientation == UIInterfaceOrientationPortrait) {
+        origin.y += kStatusBarHeight;
+    } else if (orientation == UIInterfaceOrientationLandscapeLeft) {
+        origin.x += 10;
+    } else if (orientation == UIInterfaceOrientationLandscapeRight) {
+        origin.x -= 10;
+    }
+
+    ChatSDKButtonRotation rotation = kButtonRotations[orientationIndex(orientation)][position];
+    CGAffineTransform transform = CGAffineTransformConcat(CGAffineTransformMakeTranslation(rotation.tx, rotation.ty), CGAffineTransformMakeRotation(rotation.quarterTurns*M_PI/2.0));
+    return layoutWithFrame(CGRectMake(origin.x, origin.y, btnWidth, btnHeight), CGSizeMake(btnWidth, btnHeight), transform);
+}
+
+@end
@@ -9,6 +9,7 @@
 #import <UIKit/UIKit.h>
 #import <Foundation/Foundation.h>
 #import <CoreLocation/CoreLocation.h>
+#import "ChatSDK.h"
 
 @protocol ChatSDKLocationDelegate;
 
@@ -21,11 +22,36 @@
     CLLocation *userlocation;
     
     BOOL locationServiceEnabled;
+    // startTracking was called & stopTracking was not
+    BOOL tracking;
+    // an on demand fix is being waited for
+    BOOL locating;
+    // bumped by each on demand request, so that the timeout of an earlier one leaves the current one alone
+    NSUInteger locatingGeneration;
+    NSDate *lastUpdate;
+    // latest fix that came before minimumInterval elapsed, sent by pendingTimer when it does
+    CLLocation *pendingLocation;
+    NSTimer *pendingTimer;
 }
 
 - (void)startTracking;
 - (void)stopTracking;
 
+// On demand mode : starts one fix, delivered through updateLoaction:. Does nothing in the other modes.
+- (void)requestLocation;
+
+// Steps accuracy down to about a kilometer (no GPS) while chat is minimized or the app is in background
+- (void)setReducedAccuracy:(BOOL)reduced;
+
+@property(nonatomic, assign) ChatSDKLocationTrackingMode trackingMode;
+// Used by ChatSDKLocationTrackingContinuous, default kCLLocationAccuracyNearestTenMeters
+@property(nonatomic, assign) CLLocationAccuracy desiredAccuracy;
+// Meters the device must move before an update, default 5
+@property(nonatomic, assign) CLLocationDistance distanceFilter;
+// Least seconds between two updates sent to the chat app, the latest fix in between is sent at the end, default 0
+@property(nonatomic, assign) NSTimeInterval minimumInterval;
+@property(nonatomic, readonly, assign) BOOL reducedAccuracy;
+
 
 @property(nonatomic,strong) id<ChatSDKLocationDelegate> delegate;
 
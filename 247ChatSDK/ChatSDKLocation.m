@@ -8,20 +8,35 @@
 
 #import "ChatSDKLocation.h"
 
+// Accuracy & distance filter while chat is minimized or in background
+static const CLLocationAccuracy kReducedAccuracy = 1000;
+static const CLLocationDistance kReducedDistanceFilter = 500;
+// Seconds an on demand fix may take, the best one so far is used after it
+static const NSTimeInterval kOnDemandTimeout = 15;
+
 @implementation ChatSDKLocation
 @synthesize locationManager;
 @synthesize userlocation;
 @synthesize delegate;
+@synthesize trackingMode=_trackingMode;
+@synthesize desiredAccuracy=_desiredAccuracy;
+@synthesize distanceFilter=_distanceFilter;
+@synthesize minimumInterval=_minimumInterval;
+@synthesize reducedAccuracy=_reducedAccuracy;
 
 -(id)init
 {
-    locationManager = [[CLLocationManager alloc] init];
-    [locationManager setDelegate:self];
-    //Only applies when in foreground otherwise it is very significant changes
-    [locationManager setDesiredAccuracy:kCLLocationAccuracyNearestTenMeters];
-    
-    //check location service status of device.
-    locationServiceEnabled=[CLLocationManager locationServicesEnabled];
+    self = [super init];
+    if (self) {
+        locationManager = [[CLLocationManager alloc] init];
+        [locationManager setDelegate:self];
+        _trackingMode = ChatSDKLocationTrackingContinuous;
+        _desiredAccuracy = kCLLocationAccuracyNearestTenMeters;
+        _distanceFilter = 5;
+        
+        //check location service status of device.
+        locationServiceEnabled=[CLLocationManager locationServicesEnabled];
+    }
     return self;
 }
 
@@ -31,41 +46,138 @@
 //    if (!locationServiceEnabled) {
 //        [self showEnableLocation];
 //    }
-    [locationManager startUpdatingLocation];
+    tracking = YES;
+    [self applyTrackingMode];
 }
 
 - (void)stopTracking {
+    tracking = NO;
+    locating = NO;
+    [self cancelPendingLocation];
     [locationManager stopUpdatingLocation];
+    [locationManager stopMonitoringSignificantLocationChanges];
 }
 
+- (void)requestLocation {
+    if (!tracking || _trackingMode != ChatSDKLocationTrackingOnDemand || locating) {
+        return;
+    }
+    locating = YES;
+    NSUInteger generation = ++locatingGeneration;
+    [locationManager setDesiredAccuracy:_reducedAccuracy ? kReducedAccuracy : _desiredAccuracy];
+    [locationManager setDistanceFilter:kCLDistanceFilterNone];
+    [locationManager startUpdatingLocation];
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(kOnDemandTimeout * NSEC_PER_SEC)), dispatch_get_main_queue(), ^(void) {
+        if (locating && locatingGeneration == generation) {
+            [self finishRequest];
+        }
+    });
+}
 
--(void)locationManager:(CLLocationManager *)manager didUpdateLocations:(NSArray *)locations
-{
-    float distance=[userlocation distanceFromLocation:[locations lastObject]];
-    
-    if (distance>5 || !userlocation)
-    {
-        userlocation=(CLLocation*)[locations lastObject];
-        NSLog(@"distance = %f",distance);
-        [self.delegate updateLoaction:userlocation];
+- (void)setReducedAccuracy:(BOOL)reduced {
+    if (_reducedAccuracy == reduced) {
+        return;
+    }
+    _reducedAccuracy = reduced;
+    if (tracking && !locating) {
+        [self applyTrackingMode];
     }
-    userlocation=(CLLocation*)[locations lastObject];
-    
 }
 
-- (void)locationManager:(CLLocationManager *)manager didUpdateToLocation:(CLLocation *)newLocation fromLocation:(CLLocation *)oldLocation {
+// Starts the location services the mode needs & stops the others
+- (void)applyTrackingMode {
+    switch (_trackingMode) {
+        case ChatSDKLocationTrackingSignificantChange:
+            [locationManager stopUpdatingLocation];
+            if ([CLLocationManager significantLocationChangeMonitoringAvailable]) {
+                [locationManager startMonitoringSignificantLocationChanges];
+            }
+            break;
+        case ChatSDKLocationTrackingOnDemand:
+            [locationManager stopUpdatingLocation];
+            [locationManager stopMonitoringSignificantLocationChanges];
+            break;
+        default:
+            [locationManager stopMonitoringSignificantLocationChanges];
+            [locationManager setDesiredAccuracy:_reducedAccuracy ? MAX(_desiredAccuracy, kReducedAccuracy) : _desiredAccuracy];
+            [locationManager setDistanceFilter:_reducedAccuracy ? MAX(_distanceFilter, kReducedDistanceFilter) : _distanceFilter];
+            [locationManager startUpdatingLocation];
+            break;
+    }
+}
 
-    userlocation=(CLLocation*)newLocation;
-    
-    float distance=[oldLocation distanceFromLocation:newLocation];
-    
+- (void)finishRequest {
+    locating = NO;
+    [locationManager stopUpdatingLocation];
+    if (userlocation) {
+        lastUpdate = [NSDate date];
+        [self.delegate updateLoaction:userlocation];
+    }
+}
+
+- (void)receivedLocation:(CLLocation *)location {
+    if (location == nil) {
+        return;
+    }
+    if (locating) {
+        userlocation=location;
+        // Good enough or as good as it gets
+        if (location.horizontalAccuracy >= 0 && location.horizontalAccuracy <= [locationManager desiredAccuracy]) {
+            [self finishRequest];
+        }
+        return;
+    }
     
-    if (distance>5 || !userlocation)
+    // The native distance filter does not apply to significant changes
+    CLLocationDistance distance = [userlocation distanceFromLocation:location];
+    BOOL moved = !userlocation || distance >= (_trackingMode == ChatSDKLocationTrackingContinuous ? 0 : _distanceFilter);
+    BOOL due = !lastUpdate || -[lastUpdate timeIntervalSinceNow] >= _minimumInterval;
+    if (!moved)
     {
-        //Update location only if location distance is 5meter or more.
-        [self.delegate updateLoaction:userlocation];
+        return;
+    }
+    if (due)
+    {
+        [self cancelPendingLocation];
+        [self deliverLocation:location];
+        return;
+    }
+    // Too early, the latest fix goes when minimumInterval elapsed
+    pendingLocation=location;
+    if (pendingTimer==nil)
+    {
+        NSTimeInterval delay = _minimumInterval + [lastUpdate timeIntervalSinceNow];
+        pendingTimer=[NSTimer scheduledTimerWithTimeInterval:MAX(0, delay) target:self selector:@selector(deliverPendingLocation) userInfo:nil repeats:NO];
     }
-    //NSLog(@"Entered new Location with the coordinates Latitude: %f Longitude: %f", currentCoordinates.latitude, currentCoordinates.longitude);
+}
+
+- (void)deliverLocation:(CLLocation *)location {
+    userlocation=location;
+    lastUpdate=[NSDate date];
+    [self.delegate updateLoaction:userlocation];
+}
+
+- (void)deliverPendingLocation {
+    CLLocation *location=pendingLocation;
+    [self cancelPendingLocation];
+    if (tracking && location != nil) {
+        [self deliverLocation:location];
+    }
+}
+
+- (void)cancelPendingLocation {
+    [pendingTimer invalidate];
+    pendingTimer=nil;
+    pendingLocation=nil;
+}
+
+-(void)locationManager:(CLLocationManager *)manager didUpdateLocations:(NSArray *)locations
+{
+    [self receivedLocation:[locations lastObject]];
+}
+
+- (void)locationManager:(CLLocationManager *)manager didUpdateToLocation:(CLLocation *)newLocation fromLocation:(CLLocation *)oldLocation {
+    [self receivedLocation:newLocation];
 }
 
 - (void)locationManager:(CLLocationManager *)manager didFailWithError:(NSError *)error
@@ -104,7 +216,9 @@
     
     switch(status) {
         case kCLAuthorizationStatusNotDetermined:
-            [locationManager startUpdatingLocation];
+            if (tracking && !locating) {
+                [self applyTrackingMode];
+            }
             //Access denied by user
             //errorString = @"Access to Location Services denied by user";
             //Do something...
@@ -123,7 +237,9 @@
             //Do something else...
             break;
         case kCLAuthorizationStatusAuthorized:
-            [locationManager startUpdatingLocation];
+            if (tracking && !locating) {
+                [self applyTrackingMode];
+            }
             //Probably temporary...
             //errorString = @"Location data unavailable";
             //Do something else...
@@ -9,18 +9,20 @@
 #import <UIKit/UIKit.h>
 
 @interface ChatSDKMaximizeButton : UIButton{
-    NSMutableArray *positionsArray;
     int btnWidth;
     int btnHeight;
 }
 
 @property int portraitPos;
 @property int landscapePos;
+//Least seconds between two redraws of the badge, increments in between are drawn once. 0 draws once per run loop turn
+@property NSTimeInterval badgeUpdateInterval;
 
 -(void)rotateButton;
 -(void)checkRotation;
 -(void)resetBadge;
 -(void)incrementBadgeCount;
+-(void)incrementBadgeCountBy:(NSUInteger)count;
 -(void)hideWithAnimation;
 -(void)showWithAnimation;
 @end
@@ -0,0 +1,71 @@
+//
+//  ChatSDKRequestScheduler.h
+//  247ChatSDK
+//
+//  Copyright (c) 2014 . All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+// How a scheduled request ended
+typedef enum {
+    ChatSDKRequestSucceeded,
+    // Not worth another attempt, e.g. the server answered with an error
+    ChatSDKRequestFailed,
+    // e.g. the connection was lost, tried again after a backoff unless it was the last attempt
+    ChatSDKRequestRetry
+}ChatSDKRequestResult;
+
+typedef void (^ChatSDKRequestDone)(ChatSDKRequestResult result);
+
+// Sends the request, done must be called once on any thread. attempt starts at 1
+typedef void (^ChatSDKScheduledRequest)(NSUInteger attempt, BOOL lastAttempt, ChatSDKRequestDone done);
+
+/*
+ * ChatSDKRequestScheduler   Runs the network requests of the SDK as long as the network is reachable and
+                             keeps them while it is not. When reachable turns YES the kept requests are sent,
+                             spread over flushSpread so that they do not all start in the same instant. A
+                             request asking for a retry is tried again after an exponential backoff with
+                             jitter, up to maximumAttempts. A request scheduled with the key of a waiting or
+                             running one is dropped, the one already there does the same work.
+                             Main queue only, done may be called on any thread.
+ */
+@interface ChatSDKRequestScheduler : NSObject
+
+// Set by the owner from Reachability. Default value : YES
+@property (nonatomic, assign) BOOL reachable;
+
+// Backoff before the second attempt, doubled for each further one. Default value : 1
+@property (nonatomic, assign) NSTimeInterval initialBackoff;
+
+// Default value : 60
+@property (nonatomic, assign) NSTimeInterval maximumBackoff;
+
+// Attempts of a request, the first one included. Default value : 5
+@property (nonatomic, assign) NSUInteger maximumAttempts;
+
+// Requests kept while offline or waiting for a retry, the oldest is dropped beyond. Default value : 64
+@property (nonatomic, assign) NSUInteger maximumQueueDepth;
+
+// Seconds over which the kept requests are sent when the network comes back. Default value : 1
+@property (nonatomic, assign) NSTimeInterval flushSpread;
+
+// Requests not running, i.e. kept while offline or waiting for their retry
+@property (nonatomic, readonly) NSUInteger queueDepth;
+
+// key may be nil, such requests are never dropped as duplicates
+-(void)scheduleRequest:(ChatSDKScheduledRequest)request withKey:(NSString *)key;
+
+// A running request of key is not stopped, its done is ignored
+-(void)cancelRequestsWithKey:(NSString *)key;
+-(void)cancelAllRequests;
+
+// {"since", "queueDepth", "running", "scheduled", "succeeded", "failed", "retries", "coalesced", "dropped",
+// "cancelled", "flushes"}, counts since the last resetMetrics
+-(NSDictionary *)metrics;
+-(void)resetMetrics;
+
+// Errors of a request that an attempt on a working network may not get, e.g. no connection or a timeout
++(BOOL)isConnectivityError:(NSError *)error;
+
+@end
@@ -0,0 +1,286 @@
+//
+//  ChatSDKRequestScheduler.m
+//  247ChatSDK
+//
+//  Copyright (c) 2014 . All rights reserved.
+//
+
+#import "ChatSDKRequestScheduler.h"
+
+typedef enum {
+    // Kept until the network is reachable
+    ChatSDKScheduledEntryWaiting,
+    ChatSDKScheduledEntryBackingOff,
+    ChatSDKScheduledEntryRunning
+}ChatSDKScheduledEntryState;
+
+@interface ChatSDKScheduledEntry : NSObject
+@property (nonatomic, strong) NSString *key;
+@property (nonatomic, copy) ChatSDKScheduledRequest request;
+@property (nonatomic, assign) NSUInteger attempts;
+@property (nonatomic, assign) ChatSDKScheduledEntryState state;
+// Bumped on each start & backoff so that a late timer or done of an earlier one is dropped
+@property (nonatomic, assign) NSUInteger generation;
+@end
+
+@implementation ChatSDKScheduledEntry
+@end
+
+@interface ChatSDKRequestScheduler ()
+{
+    // Oldest first
+    NSMutableArray *entries;
+    NSDate *since;
+    NSUInteger scheduled;
+    NSUInteger succeeded;
+    NSUInteger failed;
+    NSUInteger retries;
+    NSUInteger coalesced;
+    NSUInteger dropped;
+    NSUInteger cancelled;
+    NSUInteger flushes;
+}
+@end
+
+@implementation ChatSDKRequestScheduler
+
+@synthesize reachable = _reachable;
+@synthesize initialBackoff = _initialBackoff;
+@synthesize maximumBackoff = _maximumBackoff;
+@synthesize maximumAttempts = _maximumAttempts;
+@synthesize maximumQueueDepth = _maximumQueueDepth;
+@synthesize flushSpread = _flushSpread;
+
+-(id)init
+{
+    self = [super init];
+    if (self) {
+        entries = [[NSMutableArray alloc] init];
+        since = [NSDate date];
+        _reachable = YES;
+        _initialBackoff = 1;
+        _maximumBackoff = 60;
+        _maximumAttempts = 5;
+        _maximumQueueDepth = 64;
+        _flushSpread = 1;
+    }
+    return self;
+}
+
+-(void)setReachable:(BOOL)reachable
+{
+    if (_reachable == reachable) {
+        return;
+    }
+    _reachable = reachable;
+    if (!reachable) {
+        // Running requests end on their own, backed off ones wait when their retry is due
+        return;
+    }
+    flushes++;
+    for (ChatSDKScheduledEntry *entry in [entries copy]) {
+        if (entry.state == ChatSDKScheduledEntryWaiting) {
+            [self startEntry:entry afterDelay:[self randomDelayUpTo:_flushSpread]];
+        }
+    }
+}
+
+-(NSUInteger)queueDepth
+{
+    NSUInteger depth = 0;
+    for (ChatSDKScheduledEntry *entry in entries) {
+        if (entry.state != ChatSDKScheduledEntryRunning) {
+            depth++;
+        }
+    }
+    return depth;
+}
+
+-(void)scheduleRequest:(ChatSDKScheduledRequest)request withKey:(NSString *)key
+{
+    if (request == nil) {
+        return;
+    }
+    if (key != nil && [self entryWithKey:key] != nil) {
+        coalesced++;
+        return;
+    }
+    scheduled++;
+
+    ChatSDKScheduledEntry *entry = [[ChatSDKScheduledEntry alloc] init];
+    entry.key = key;
+    entry.request = request;
+    entry.state = ChatSDKScheduledEntryWaiting;
+    [entries addObject:entry];
+
+    if (_reachable) {
+        [self startEntry:entry];
+    } else {
+        [self trimQueue];
+    }
+}
+
+-(void)cancelRequestsWithKey:(NSString *)key
+{
+    ChatSDKScheduledEntry *entry = key ? [self entryWithKey:key] : nil;
+    if (entry != nil) {
+        cancelled++;
+        [entries removeObject:entry];
+    }
+}
+
+-(void)cancelAllRequests
+{
+    cancelled += [entries count];
+    [entries removeAllObjects];
+}
+
+-(NSDictionary *)metrics
+{
+    NSUInteger running = [entries count] - [self queueDepth];
+    return @{ @"since" : [NSNumber numberWithDouble:[since timeIntervalSince1970]],
+              @"queueDepth" : [NSNumber numberWithUnsignedInteger:[self queueDepth]],
+              @"running" : [NSNumber numberWithUnsignedInteger:running],
+              @"scheduled" : [NSNumber numberWithUnsignedInteger:scheduled],
+              @"succeeded" : [NSNumber numberWithUnsignedInteger:succeeded],
+              @"failed" : [NSNumber numberWithUnsignedInteger:failed],
+              @"retries" : [NSNumber numberWithUnsignedInteger:retries],
+              @"coalesced" : [NSNumber numberWithUnsignedInteger:coalesced],
+              @"dropped" : [NSNumber numberWithUnsignedInteger:dropped],
+              @"cancelled" : [NSNumber numberWithUnsignedInteger:cancelled],
+              @"flushes" : [NSNumber numberWithUnsignedInteger:flushes] };
+}
+
+-(void)resetMetrics
+{
+    since = [NSDate date];
+    scheduled = succeeded = failed = retries = coalesced = dropped = cancelled = flushes = 0;
+}
+
++(BOOL)isConnectivityError:(NSError *)error
+{
+    if (![[error domain] isEqualToString:NSURLErrorDomain]) {
+        return NO;
+    }
+    switch ([error code]) {
+        case NSURLErrorNotConnectedToInternet:
+        case NSURLErrorNetworkConnectionLost:
+        case NSURLErrorTimedOut:
+        case NSURLErrorCannotFindHost:
+        case NSURLErrorCannotConnectToHost:
+        case NSURLErrorDNSLookupFailed:
+        case NSURLErrorInternationalRoamingOff:
+        case NSURLErrorCallIsActive:
+        case NSURLErrorDataNotAllowed:
+            return YES;
+        default:
+            return NO;
+    }
+}
+
+#pragma mark - Entries
+
+-(ChatSDKScheduledEntry *)entryWithKey:(NSString *)key
+{
+    for (ChatSDKScheduledEntry *entry in entries) {
+        if ([entry.key isEqualToString:key]) {
+            return entry;
+        }
+    }
+    return nil;
+}
+
+// Drops the oldest requests that are not running beyond maximumQueueDepth
+-(void)trimQueue
+{
+    while ([self queueDepth] > _maximumQueueDepth) {
+        for (ChatSDKScheduledEntry *entry in entries) {
+            if (entry.state != ChatSDKScheduledEntryRunning) {
+                dropped++;
+                [entries removeObject:entry];
+                break;
+            }
+        }
+    }
+}
+
+-(void)startEntry:(ChatSDKScheduledEntry *)entry afterDelay:(NSTimeInterval)delay
+{
+    NSUInteger generation = ++entry.generation;
+    __weak ChatSDKRequestScheduler *weakSelf = self;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), dispatch_get_main_queue(), ^(void) {
+        ChatSDKRequestScheduler *strongSelf = weakSelf;
+        if (strongSelf == nil || entry.generation != generation || ![strongSelf->entries containsObject:entry]) {
+            return;
+        }
+        [strongSelf startEntry:entry];
+    });
+}
+
+-(void)startEntry:(ChatSDKScheduledEntry *)entry
+{
+    if (!_reachable) {
+        entry.state = ChatSDKScheduledEntryWaiting;
+        [self trimQueue];
+        return;
+    }
+    entry.state = ChatSDKScheduledEntryRunning;
+    entry.attempts++;
+    if (entry.attempts > 1) {
+        retries++;
+    }
+    NSUInteger generation = ++entry.generation;
+    BOOL lastAttempt = entry.attempts >= _maximumAttempts;
+
+    __weak ChatSDKRequestScheduler *weakSelf = self;
+    __block BOOL finished = NO;
+    entry.request(entry.attempts, lastAttempt, ^(ChatSDKRequestResult result) {
+        dispatch_async(dispatch_get_main_queue(), ^(void) {
+            ChatSDKRequestScheduler *strongSelf = weakSelf;
+            // Only the first done of an attempt counts, & none of a cancelled request
+            if (finished || strongSelf == nil || entry.generation != generation || ![strongSelf->entries containsObject:entry]) {
+                return;
+            }
+            finished = YES;
+            [strongSelf finishEntry:entry withResult:result];
+        });
+    });
+}
+
+-(void)finishEntry:(ChatSDKScheduledEntry *)entry withResult:(ChatSDKRequestResult)result
+{
+    if (result == ChatSDKRequestRetry && entry.attempts < _maximumAttempts) {
+        entry.state = ChatSDKScheduledEntryBackingOff;
+        [self startEntry:entry afterDelay:[self backoffAfterAttempt:entry.attempts]];
+        [self trimQueue];
+        return;
+    }
+    if (result == ChatSDKRequestSucceeded) {
+        succeeded++;
+    } else {
+        failed++;
+    }
+    [entries removeObject:entry];
+}
+
+// initialBackoff doubled per attempt up to maximumBackoff, of which a random second half is taken so that
+// clients that lost the network together do not retry together
+-(NSTimeInterval)backoffAfterAttempt:(NSUInteger)attempt
+{
+    NSTimeInterval backoff = _initialBackoff;
+    for (NSUInteger i = 1; i < attempt && backoff < _maximumBackoff; i++) {
+        backoff *= 2;
+    }
+    backoff = MIN(backoff, _maximumBackoff);
+    return backoff / 2 + [self randomDelayUpTo:backoff / 2];
+}
+
+-(NSTimeInterval)randomDelayUpTo:(NSTimeInterval)maximum
+{
+    if (maximum <= 0) {
+        return 0;
+    }
+    return maximum * ((double)arc4random_uniform(1000) / 1000.0);
+}
+
+@end
@@ -0,0 +1,58 @@
+//
+//  ChatSDKSession.h
+//  247ChatSDK
+//
+//  Copyright (c) 2014 . All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "ChatSDKCallbacks.h"
+
+/*
+ * ChatSDKSession               One chat with its own chat view, minimize button, native bridge & callbacks,
+                                so that chats of different queues (e.g. sales & support) run side by side.
+                                Sessions are opened by openSessionForQueue:contextInfo: of ChatSDK, startChat
+                                and the other chat methods of ChatSDK drive a default session of their own.
+                                Main thread only.
+ */
+@interface ChatSDKSession : NSObject
+
+/* queueId : Queue of the chat, sent to the chat app by getqueueid */
+@property (nonatomic, readonly, strong) NSString *queueId;
+
+/* contextInfo : Pre-chat context information sent to the chat app by getcontext */
+@property (nonatomic, strong) NSDictionary *contextInfo;
+
+/*
+ callbacks : Receives the notifications of this chat (onChatStarted, onChatMinimized, onAgentMessage ...).
+ Default value : chatSDKCallbacks of ChatSDK
+ */
+@property (nonatomic, strong) ChatSDKCallbacks *callbacks;
+
+/* isActive : The chat view was created and the chat is not ended yet */
+@property (nonatomic, readonly) BOOL isActive;
+
+/* isMinimized : The chat is shown as its minimize button */
+@property (nonatomic, readonly) BOOL isMinimized;
+
+/*
+ * start                        Loads the chat view, or brings it into view when the chat is running already.
+ */
+-(void)start;
+
+/*
+ * maximize                     Brings the chat into view when it is minimized.
+ */
+-(void)maximize;
+
+/*
+ * minimize                     Animates the chat out of view and shows its minimize button.
+ */
+-(void)minimize;
+
+/*
+ * end                          Closes the chat view and ends the session, start loads a new chat.
+ */
+-(void)end;
+
+@end
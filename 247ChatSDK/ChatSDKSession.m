@@ -0,0 +1,971 @@
+//
+//  ChatSDKSession.m
+//  247ChatSDK
+//
+//  Copyright (c) 2014 . All rights reserved.
+//
+
+#import "ChatSDKSession.h"
+#import "ChatSDKSessionManager.h"
+#import "ChatSDKBridgeAction.h"
+#import "ChatSDKBridgeActionRegistry.h"
+#import "ChatSDKBridgeCodec.h"
+#import "ChatSDKJSEventQueue.h"
+#import "ChatSDKJSBridge.h"
+#import "ChatSDKAssetCache.h"
+#import "ChatSDKTranscriptStore.h"
+#import "ChatSDKURLProtocol.h"
+#import "ChatSDKConstants.h"
+#import "ChatSDKConfiguration.h"
+#import "ChatSDKWebView.h"
+#import "ChatSDKMaximizeButton.h"
+
+// Defined in ChatSDK.m
+extern int COMPILED_WITH_VER;
+
+// Seconds WebKit is given to free the released page before the memory is measured again
+static const NSTimeInterval kHibernationMeasureDelay = 1.0;
+// Seconds the chat app is given to answer the hibernate status with hibernateready
+static const NSTimeInterval kHibernateReadyTimeout = 2.0;
+
+@interface ChatSDKSession ()<ChatSDKWebViewDelegate,ChatSDKJSBridgeDelegate>
+{
+    __weak id<ChatSDKSessionOwner> owner;
+    __weak ChatSDKSessionManager *manager;
+    // chatsdk_session of the chat page URL, nil for the default session
+    NSString *sessionTag;
+    ChatSDKWebView *chatWebview;
+    // Engine chatWebview was asked for, it is given back to the pool of that engine
+    ChatSDKWebEngine requestedEngine;
+    ChatSDKMaximizeButton *chatButton;
+    UIActivityIndicatorView *indicatorView;
+    // Boolean variable to have check on first load
+    BOOL firstTimeFlag;
+    // Answers the chat app's chat_exec calls, scoped to this session's pages by ChatSDKURLProtocol
+    ChatSDKJSBridge *cache;
+    // Actions bound to this session, the others are answered by the registry of ChatSDK
+    ChatSDKBridgeActionRegistry *bridgeActions;
+    // Native -> JS calls, evaluated once per run loop turn
+    ChatSDKJSEventQueue *jsEvents;
+
+    // chatWebview was loaded by preloadWithTimeout: and is not shown yet
+    BOOL chatPrewarmed;
+    // the preloaded chat app finished loading
+    BOOL prewarmLoaded;
+    NSTimer *prewarmTimer;
+
+    BOOL chatMinimized;
+    // chatWebview was released while minimized, maximize loads the chat again
+    BOOL hibernated;
+    NSTimer *hibernateTimer;
+    // hibernate was sent to the chat app, chatWebview goes on hibernateready or hibernateReadyTimer
+    BOOL hibernating;
+    NSTimer *hibernateReadyTimer;
+    unsigned long long residentBeforeHibernation;
+
+    // done of the scheduled reload of a chat that failed to load, nil when none is running
+    ChatSDKRequestDone loadRetryDone;
+    BOOL loadRetryIsLast;
+}
+@end
+
+@implementation ChatSDKSession
+
+@synthesize queueId = _queueId;
+@synthesize contextInfo = _contextInfo;
+@synthesize callbacks = _callbacks;
+
+-(id)initWithQueue:(NSString *)queueId contextInfo:(NSDictionary *)contextInfo tag:(NSString *)tag owner:(id<ChatSDKSessionOwner>)sessionOwner manager:(ChatSDKSessionManager *)sessionManager
+{
+    if (self = [super init])
+    {
+        _queueId = queueId;
+        _contextInfo = contextInfo;
+        sessionTag = tag;
+        owner = sessionOwner;
+        manager = sessionManager;
+
+        [self registerBridgeActions];
+
+        __weak ChatSDKSession *weakQueueOwner = self;
+        jsEvents = [[ChatSDKJSEventQueue alloc] initWithDispatchHandler:^(NSString *script) {
+            ChatSDKSession *strongSelf = weakQueueOwner;
+            if (strongSelf == nil) {
+                return;
+            }
+            [strongSelf->chatWebview evaluateJavaScript:script];
+        }];
+    }
+    return self;
+}
+
+-(NSString *)tag
+{
+    return sessionTag;
+}
+
+// Transcripts are kept per queue, so that the next chat of the queue finds the history of this one
+-(NSString *)transcriptKey
+{
+    return _queueId ? _queueId : @"";
+}
+
+-(void)recordTranscriptEntryOfType:(NSString *)type data:(id)data
+{
+    [[owner transcriptStoreForSession:self] appendEntryOfType:type data:data toTranscript:[self transcriptKey]];
+}
+
+-(ChatSDKCallbacks *)callbacks
+{
+    return _callbacks ? _callbacks : [owner callbacksForSession:self];
+}
+
+-(BOOL)isActive
+{
+    return (chatWebview!=nil || hibernated) && !chatPrewarmed;
+}
+
+-(BOOL)isMinimized
+{
+    return (chatWebview!=nil || hibernated) && chatMinimized;
+}
+
+-(BOOL)isHibernated
+{
+    return hibernated;
+}
+
+-(BOOL)isPrewarmed
+{
+    return chatPrewarmed;
+}
+
+-(void)start
+{
+    if(hibernated)
+    {
+        [self maximize];
+    }
+    else if(!chatWebview)
+    {
+        [self loadChatWebView];
+
+        // Starting the indicator view initially
+        [self showLoadingIndicator];
+    }
+    else if(chatPrewarmed)
+    {
+        // Attaching the preloaded chat instead of loading it again
+        [self attachPrewarmedChat];
+    }
+    else
+    {
+        [self maximize];
+    }
+}
+
+//Creates chatWebview, the maximize button & the JS bridge and starts loading the chat app
+-(void)loadChatWebView
+{
+    ChatSDKConfiguration *configuration = [ChatSDKConfiguration sharedConfiguration];
+    UIWindow *chatWindow = [owner windowForSession:self];
+    [manager addSession:self];
+
+    //The bridge only sees requests of this session's pages, the shared NSURLCache of the application is left alone
+    ChatSDKAssetCache *assetCache = [owner assetCacheForSession:self];
+    [ChatSDKURLProtocol unregisterBridge:cache];
+    cache = [[ChatSDKJSBridge alloc] init];
+    cache.assetCache = assetCache;
+    [assetCache refresh];
+    [ChatSDKURLProtocol registerBridge:cache forHost:[configuration.chatURL host] session:sessionTag];
+    bridgeActions.fallbackRegistry = [owner bridgeActionsForSession:self];
+
+    // WKWebView only when chatsdkconfig.plist asks for it
+    requestedEngine = ChatSDKWebEngineUIWebView;
+    if(configuration.prefersWKWebView)
+    {
+        requestedEngine = ChatSDKWebEngineWKWebView;
+    }
+
+    // A warm engine of the pool when there is one
+    chatWebview = [manager dequeueWebViewWithEngine:requestedEngine];
+    // Bridge calls are routed by web view, whatever URL a redirect or pushState gives the page
+    [ChatSDKURLProtocol registerBridge:cache forWebViewToken:chatWebview.identityToken];
+    [self resetChatWebView];
+
+    //Making maximize button
+    if(!chatButton)
+    {
+        chatButton = [self createChatButton];
+    }
+    [chatButton rotateButton];
+    [chatWindow addSubview:chatButton];
+    chatButton.hidden=YES;
+
+    // Setting ChatSDKJSBridgeDelegate to self
+    [cache setDelegate:self];
+    [chatWebview setBridgeDelegate:self];
+    [chatWebview setBatchesBridgeCalls:configuration.batchesBridgeCalls];
+    [chatWebview setDelegate:self];
+
+    NSURL *websiteUrl = [ChatSDKURLProtocol URL:configuration.chatURL taggedWithSession:sessionTag];
+    NSURLRequest *urlRequest = [NSURLRequest requestWithURL:websiteUrl];
+    [chatWebview loadRequest:urlRequest];
+}
+
+//Lays chatWebview out for the device
+-(void)resetChatWebView
+{
+    if (UI_USER_INTERFACE_IDIOM() == UIUserInterfaceIdiomPad)
+    {
+        if([[[UIDevice currentDevice] systemVersion] floatValue] >=7.0f && COMPILED_WITH_VER>=7)
+        {
+            //Default resizing
+            [chatWebview resetWebViewForIpadWithFrame];
+        }else{
+            [chatWebview resetWebViewForIpad];
+        }
+    }
+    else
+    {
+        if([[[UIDevice currentDevice] systemVersion] floatValue] >=7.0f && COMPILED_WITH_VER>=7)
+        {
+            [chatWebview resetWebViewWithFrame];
+        }else{
+            [chatWebview resetWebView];
+        }
+    }
+}
+
+-(void)showLoadingIndicator
+{
+    if(indicatorView==nil)
+    {
+        UIWindow *chatWindow = [owner windowForSession:self];
+        indicatorView = [[UIActivityIndicatorView alloc] initWithActivityIndicatorStyle:UIActivityIndicatorViewStyleGray];
+        indicatorView.center = chatWindow.center;
+        [chatWindow addSubview:indicatorView];
+        [indicatorView startAnimating];
+    }
+}
+
+-(void)hideLoadingIndicator
+{
+    if(indicatorView!=nil)
+    {
+        [indicatorView stopAnimating];
+        [indicatorView removeFromSuperview];
+        indicatorView = nil;
+    }
+}
+
+-(void)preloadWithTimeout:(NSTimeInterval)timeout
+{
+    if(chatWebview)
+    {
+        return;
+    }
+    chatPrewarmed=YES;
+    prewarmLoaded=NO;
+    [self loadChatWebView];
+
+    [prewarmTimer invalidate];
+    if(timeout>0)
+    {
+        prewarmTimer=[NSTimer scheduledTimerWithTimeInterval:timeout target:self selector:@selector(releaseIfPrewarmed) userInfo:nil repeats:NO];
+    }
+}
+
+//start on a preloaded chat, show it at once if it finished loading
+-(void)attachPrewarmedChat
+{
+    [prewarmTimer invalidate];
+    prewarmTimer=nil;
+    chatPrewarmed=NO;
+
+    if(prewarmLoaded)
+    {
+        [self presentLoadedChat];
+    }
+    else
+    {
+        //chatWebViewDidFinishLoad will present it
+        [self showLoadingIndicator];
+    }
+}
+
+//Drops a preloaded chat that nobody started
+-(void)releaseIfPrewarmed
+{
+    [prewarmTimer invalidate];
+    prewarmTimer=nil;
+    if(!chatPrewarmed)
+    {
+        return;
+    }
+    chatPrewarmed=NO;
+    prewarmLoaded=NO;
+    firstTimeFlag=FALSE;
+
+    [self tearDownChatWebView];
+    [owner sessionDidEnd:self];
+}
+
+//Gives chatWebview back to the pool & stops intercepting the chat app's requests
+-(void)tearDownChatWebView
+{
+    [self cancelLoadRetry];
+    [self hideLoadingIndicator];
+    if(chatWebview!=nil)
+    {
+        [manager recycleWebView:chatWebview engine:requestedEngine];
+        chatWebview=nil;
+        [jsEvents clear];
+    }
+    // Remove maximizeButton from superView
+    if(chatButton!=nil)
+    {
+        [chatButton removeFromSuperview];
+        chatButton=nil;
+    }
+    [ChatSDKURLProtocol unregisterBridge:cache];
+    cache=nil;
+}
+
+-(void)maximize
+{
+    [self cancelHibernation];
+    // Only a preloaded chat to bring into view
+    if(chatPrewarmed)
+    {
+        [self attachPrewarmedChat];
+        return;
+    }
+    if(hibernated)
+    {
+        [self wakeFromHibernation];
+        return;
+    }
+    if(chatWebview==nil)
+    {
+        return;
+    }
+
+    [chatButton hideWithAnimation];
+    chatWebview.hidden = NO;
+    chatMinimized=NO;
+    [owner sessionDidChangeMinimized:self];
+    [[owner windowForSession:self] bringSubviewToFront:chatWebview];
+
+    [self resetChatWebView];
+    [chatWebview showWithAnimation];
+    dispatch_async(dispatch_get_main_queue(), ^(void) {
+        //Resetting badge count
+        [chatButton resetBadge];
+
+        // Creating a blank NSDictionary.
+        NSDictionary *tempDict = [[NSDictionary alloc] init];
+        // CALLING DELEGATE FUNCTION WHICH WILL NOTIFY APPLICATION ABOUT MAXIMIZECHAT
+        [self.callbacks onChatMaximizedDelegateHandler:tempDict];
+    });
+
+    //send maximize notification to JS Bridge
+    [self sendApplicationStatus:@"maximize"];
+}
+
+-(void)minimize
+{
+    // A preloaded chat is not in view yet
+    if(chatPrewarmed || chatWebview==nil)
+    {
+        return;
+    }
+
+    //send minimize notification to JS Bridge
+    [self sendApplicationStatus:@"minimize"];
+
+    //nobody looks at the chat, a rough location will do
+    chatMinimized=YES;
+    [owner sessionDidChangeMinimized:self];
+
+    //Add chatbutton on screen and hide chatsdkwebview
+    [chatWebview hideWithAnimation];
+    chatButton.hidden=NO;
+    [chatButton showWithAnimation];
+    [chatButton checkRotation];
+    [[owner windowForSession:self] bringSubviewToFront:chatButton];
+
+    dispatch_async(dispatch_get_main_queue(), ^(void) {
+        // Creating a blank NSDictionary.
+        NSDictionary *tempDict = [[NSDictionary alloc] init];
+        // CALLING DELEGATE FUNCTION WHICH WILL NOTIFY APPLICATION ABOUT MINIMIZECHAT
+        [self.callbacks onChatMinimizedDelegateHandler:tempDict];
+    });
+
+    [self scheduleHibernation];
+}
+
+-(void)scheduleHibernation
+{
+    [self cancelHibernation];
+    NSTimeInterval delay=[owner hibernationDelayForSession:self];
+    if(delay>0)
+    {
+        hibernateTimer=[NSTimer scheduledTimerWithTimeInterval:delay target:self selector:@selector(hibernate) userInfo:nil repeats:NO];
+    }
+}
+
+-(void)cancelHibernation
+{
+    [hibernateTimer invalidate];
+    hibernateTimer=nil;
+    [hibernateReadyTimer invalidate];
+    hibernateReadyTimer=nil;
+    hibernating=NO;
+}
+
+-(void)hibernate
+{
+    [hibernateTimer invalidate];
+    hibernateTimer=nil;
+    if(!chatMinimized || chatPrewarmed || hibernated || hibernating || chatWebview==nil)
+    {
+        return;
+    }
+    hibernating=YES;
+    residentBeforeHibernation=ChatSDKResidentMemory();
+
+    //Last word of the chat app, e.g. to save what it shows with addtranscriptentry, it answers with hibernateready
+    [self sendApplicationStatus:@"hibernate"];
+    [jsEvents flush];
+
+    //A chat app that does not know hibernateready is released anyway
+    hibernateReadyTimer=[NSTimer scheduledTimerWithTimeInterval:kHibernateReadyTimeout target:self selector:@selector(completeHibernation) userInfo:nil repeats:NO];
+}
+
+-(void)hibernateImmediately
+{
+    //The chat app gets its last word but no time to answer, the memory is needed now
+    [self hibernate];
+    [self completeHibernationRecyclingView:NO];
+}
+
+//Releases the chat view once the chat app saved its state
+-(void)completeHibernation
+{
+    [self completeHibernationRecyclingView:YES];
+}
+
+//recycle NO drops the chat view instead of giving it to the pool
+-(void)completeHibernationRecyclingView:(BOOL)recycle
+{
+    if(!hibernating)
+    {
+        return;
+    }
+    hibernating=NO;
+    [hibernateReadyTimer invalidate];
+    hibernateReadyTimer=nil;
+    // Maximized or ended in the meantime
+    if(!chatMinimized || chatWebview==nil)
+    {
+        return;
+    }
+    unsigned long long residentBefore=residentBeforeHibernation;
+
+    //The minimize button & its badge stay, the page & its bridge go
+    [self cancelLoadRetry];
+    hibernated=YES;
+    firstTimeFlag=FALSE;
+    if(recycle)
+    {
+        [manager recycleWebView:chatWebview engine:requestedEngine];
+    }
+    else
+    {
+        [chatWebview prepareForReuse];
+    }
+    chatWebview=nil;
+    [jsEvents clear];
+    [ChatSDKURLProtocol unregisterBridge:cache];
+    cache=nil;
+
+    //WebKit frees the page over the next moments
+    __weak ChatSDKSession *weakSelf=self;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(kHibernationMeasureDelay * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        ChatSDKSession *strongSelf=weakSelf;
+        if(strongSelf==nil)
+        {
+            return;
+        }
+        unsigned long long residentAfter=ChatSDKResidentMemory();
+        unsigned long long reclaimedBytes=residentBefore>residentAfter ? residentBefore-residentAfter : 0;
+        NSDictionary *tempDict=[NSDictionary dictionaryWithObjectsAndKeys:[NSNumber numberWithUnsignedLongLong:reclaimedBytes],@"reclaimedBytes",strongSelf.queueId,@"queueId", nil];
+        // CALLING DELEGATE FUNCTION WHICH WILL NOTIFY APPLICATION ABOUT HIBERNATION
+        [strongSelf.callbacks onChatHibernatedDelegateHandler:tempDict];
+    });
+}
+
+//maximize of a hibernated chat, the chat app is loaded again & restores itself from the transcript
+-(void)wakeFromHibernation
+{
+    hibernated=NO;
+    chatMinimized=NO;
+    [owner sessionDidChangeMinimized:self];
+
+    //loadChatWebView hides the minimize button until the chat is loaded
+    [self loadChatWebView];
+    [self showLoadingIndicator];
+
+    dispatch_async(dispatch_get_main_queue(), ^(void) {
+        //Resetting badge count
+        [chatButton resetBadge];
+
+        // Creating a blank NSDictionary.
+        NSDictionary *tempDict = [[NSDictionary alloc] init];
+        // CALLING DELEGATE FUNCTION WHICH WILL NOTIFY APPLICATION ABOUT MAXIMIZECHAT
+        [self.callbacks onChatMaximizedDelegateHandler:tempDict];
+    });
+}
+
+//The badge is redrawn as often as agent messages are delivered, with the interval of the moment
+-(void)incrementBadgeCount
+{
+    chatButton.badgeUpdateInterval = self.callbacks.agentMessageCoalescingInterval;
+    [chatButton incrementBadgeCount];
+}
+
+-(BOOL)receiveAgentMessage:(id)data
+{
+    if(!hibernated)
+    {
+        return NO;
+    }
+    [self incrementBadgeCount];
+    [self recordTranscriptEntryOfType:@"agentmessage" data:data];
+    // CALLING DELEGATE FUNCTION WHICH WILL NOTIFY APPLICATION ABOUT ONAGENTMESSAGE
+    [self.callbacks onAgentMessageDelegateHandler:data];
+    return YES;
+}
+
+-(void)end
+{
+    // A chat that was only preloaded never started, nothing to report
+    if(chatPrewarmed)
+    {
+        [self releaseIfPrewarmed];
+        return;
+    }
+
+    // Assigning flag to FALSE.
+    firstTimeFlag = FALSE;
+
+    [self cancelHibernation];
+    [self tearDownChatWebView];
+    chatMinimized=NO;
+    hibernated=NO;
+
+    dispatch_async(dispatch_get_main_queue(), ^(void) {
+        // Creating a blank NSDictionary.
+        NSDictionary *tempDict = [[NSDictionary alloc] init];
+        // CALLING DELEGATE FUNCTION WHICH WILL NOTIFY APPLICATION ABOUT ENDCHAT
+        [self.callbacks onChatEndedDelegateHandler:tempDict];
+    });
+
+    [owner sessionDidEnd:self];
+}
+
+//Method for chatButtonClicked()
+-(void)chatButtonClicked
+{
+    [self maximize];
+}
+
+-(void)sendApplicationStatus:(NSString *)status
+{
+    // Nothing listens without chat view
+    if(chatWebview==nil || status==nil)
+    {
+        return;
+    }
+    NSDictionary *Dic=[NSDictionary dictionaryWithObjectsAndKeys:status,@"applicationStatus", nil];
+    NSDictionary *sendingDic=[NSDictionary dictionaryWithObjectsAndKeys:Dic,@"result", nil];
+
+    // Only the latest status of a run loop turn is sent
+    [jsEvents enqueueFunction:@"ApplicationStatus" argument:sendingDic coalescingKey:@"ApplicationStatus"];
+}
+
+-(void)sendLocation:(CLLocation *)newLocation
+{
+    if(chatWebview==nil || newLocation==nil)
+    {
+        return;
+    }
+    NSString *latitudeString = [NSString stringWithFormat:@"%f",newLocation.coordinate.latitude];
+    NSString *longitudeString = [NSString stringWithFormat:@"%f",newLocation.coordinate.longitude];
+
+    NSDictionary *Dic=[NSDictionary dictionaryWithObjectsAndKeys:latitudeString,@"latitude",longitudeString,@"longitude", nil];
+    NSDictionary *sendingDic=[NSDictionary dictionaryWithObjectsAndKeys:Dic,@"result", nil];
+
+    // Only the latest location of a run loop turn is sent
+    [jsEvents enqueueFunction:@"ReceivedLocation" argument:sendingDic coalescingKey:@"ReceivedLocation"];
+}
+
+#pragma mark ChatSDKJSBridge Delegate
+
+- (NSDictionary *)executeNative:(ChatSDKBridgeAction *)nativeAction error:(NSError **)error {
+    return [bridgeActions executeAction:nativeAction error:error];
+}
+
+//Native actions of Bridge.js bound to this chat, the actions of ChatSDK answer the rest
+-(void)registerBridgeActions
+{
+    bridgeActions = [[ChatSDKBridgeActionRegistry alloc] init];
+    __weak ChatSDKSession *weakSelf = self;
+
+    // Async results of the shared actions are completed here too, in the chat that asked
+    bridgeActions.asyncCompletionHandler = ^(NSDictionary *envelope) {
+        ChatSDKSession *strongSelf = weakSelf;
+        if (strongSelf == nil) {
+            return;
+        }
+        if (strongSelf->chatWebview == nil) {
+            return;
+        }
+        [strongSelf->jsEvents enqueueScript:[ChatSDKWebView scriptCompletingNativeCall:envelope]];
+    };
+
+    //-----------MINIMIZE CHAT------------//
+    [bridgeActions registerAction:@"minimizechat" handler:^NSDictionary *(ChatSDKBridgeAction *action, NSError **error) {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            // Calling minimize
+            [weakSelf minimize];
+        });
+        return [[NSDictionary alloc] init];
+    }];
+
+    //-----------END CHAT------------//
+    [bridgeActions registerAction:@"endchat" handler:^NSDictionary *(ChatSDKBridgeAction *action, NSError **error) {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            // Caling end
+            [weakSelf end];
+        });
+        return nil;
+    }];
+
+    //-----------ONAGENTMESSAGE------------//
+    [bridgeActions registerAction:@"onagentmessage" handler:^NSDictionary *(ChatSDKBridgeAction *action, NSError **error) {
+        [weakSelf recordTranscriptEntryOfType:@"agentmessage" data:[action.params objectForKey:@"data"]];
+        // CALLING DELEGATE FUNCTION WHICH WILL NOTIFY APPLICATION ABOUT ONAGENTMESSAGE, it goes to the delegate queue itself
+        [weakSelf.callbacks onAgentMessageDelegateHandler:[action.params objectForKey:@"data"]];
+        return [[NSDictionary alloc] init];
+    }];
+
+    //-----------GETCONTEXT------------//
+    [bridgeActions registerAction:@"getcontext" handler:^NSDictionary *(ChatSDKBridgeAction *action, NSError **error) {
+        NSDictionary *contextInfo = weakSelf.contextInfo;
+        return contextInfo ? contextInfo : [[NSDictionary alloc] init];
+    }];
+
+    //-----------getqueue------------//
+    [bridgeActions registerAction:@"getqueueid" handler:^NSDictionary *(ChatSDKBridgeAction *action, NSError **error) {
+        return [[NSDictionary alloc] initWithObjectsAndKeys:weakSelf.queueId,@"QueueId", nil];
+    }];
+
+    //-----------CHATSTARTED------------//
+    [bridgeActions registerAction:@"chatstarted" handler:^NSDictionary *(ChatSDKBridgeAction *action, NSError **error) {
+        [weakSelf recordTranscriptEntryOfType:@"chatstarted" data:[action.params objectForKey:@"data"]];
+        dispatch_async(dispatch_get_main_queue(), ^{
+            // CALLING DELEGATE FUNCTION WHICH WILL NOTIFY APPLICATION ABOUT ONCHATSTARTED
+            [weakSelf.callbacks onChatStartedDelegateHandler:[action.params objectForKey:@"data"]];
+        });
+        return [[NSDictionary alloc] init];
+    }];
+
+    //-----------GET TRANSCRIPT------------//
+    // data {"since" : <seq of the last entry the chat app has>, "limit"}, answers {"entries" : [{"seq", "type", "time", "data"}]}
+    [bridgeActions registerAction:@"gettranscript" asyncHandler:^(ChatSDKBridgeAction *action, ChatSDKBridgeActionCompletion completion) {
+        ChatSDKSession *strongSelf = weakSelf;
+        ChatSDKTranscriptStore *store = strongSelf ? [strongSelf->owner transcriptStoreForSession:strongSelf] : nil;
+        if (store == nil) {
+            completion([NSDictionary dictionaryWithObject:[NSArray array] forKey:@"entries"], nil);
+            return;
+        }
+        NSDictionary *request = [action.params objectForKey:@"data"];
+        long long since = 0;
+        NSUInteger limit = 0;
+        if ([request isKindOfClass:[NSDictionary class]]) {
+            since = [[request objectForKey:@"since"] longLongValue];
+            limit = [[request objectForKey:@"limit"] unsignedIntegerValue];
+        }
+        [store entriesOfTranscript:[strongSelf transcriptKey] afterSequence:since limit:limit completion:^(NSArray *entries) {
+            completion([NSDictionary dictionaryWithObject:entries forKey:@"entries"], nil);
+        }];
+    }];
+
+    //-----------ADD TRANSCRIPT ENTRY------------//
+    // data {"type", "data"}, e.g. the visitor's own messages
+    [bridgeActions registerAction:@"addtranscriptentry" handler:^NSDictionary *(ChatSDKBridgeAction *action, NSError **error) {
+        NSDictionary *entry = [action.params objectForKey:@"data"];
+        if ([entry isKindOfClass:[NSDictionary class]] && [[entry objectForKey:@"type"] isKindOfClass:[NSString class]]) {
+            [weakSelf recordTranscriptEntryOfType:[entry objectForKey:@"type"] data:[entry objectForKey:@"data"]];
+        }
+        return [[NSDictionary alloc] init];
+    }];
+
+    //-----------HIBERNATE READY------------//
+    // Answer of the chat app to the hibernate status once it saved what it shows
+    [bridgeActions registerAction:@"hibernateready" handler:^NSDictionary *(ChatSDKBridgeAction *action, NSError **error) {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [weakSelf completeHibernation];
+        });
+        return [[NSDictionary alloc] init];
+    }];
+
+    //-----------CLEAR TRANSCRIPT------------//
+    [bridgeActions registerAction:@"cleartranscript" handler:^NSDictionary *(ChatSDKBridgeAction *action, NSError **error) {
+        ChatSDKSession *strongSelf = weakSelf;
+        if (strongSelf) {
+            [[strongSelf->owner transcriptStoreForSession:strongSelf] removeTranscript:[strongSelf transcriptKey]];
+        }
+        return [[NSDictionary alloc] init];
+    }];
+}
+
+#pragma mark Load retry
+
+-(NSString *)loadRetryKey
+{
+    return [NSString stringWithFormat:@"chatload|%@", sessionTag ? sessionTag : @""];
+}
+
+//Loads the chat app again through the request scheduler, which waits for the network & backs off between attempts
+-(void)scheduleLoadRetry
+{
+    __weak ChatSDKSession *weakSelf=self;
+    [[owner requestSchedulerForSession:self] scheduleRequest:^(NSUInteger attempt, BOOL lastAttempt, ChatSDKRequestDone done) {
+        ChatSDKSession *strongSelf=weakSelf;
+        if(strongSelf==nil || strongSelf->chatWebview==nil)
+        {
+            done(ChatSDKRequestFailed);
+            return;
+        }
+        strongSelf->loadRetryDone=[done copy];
+        strongSelf->loadRetryIsLast=lastAttempt;
+        strongSelf->firstTimeFlag=FALSE;
+        NSURL *websiteUrl=[ChatSDKURLProtocol URL:[ChatSDKConfiguration sharedConfiguration].chatURL taggedWithSession:strongSelf->sessionTag];
+        [strongSelf->chatWebview loadRequest:[NSURLRequest requestWithURL:websiteUrl]];
+    } withKey:[self loadRetryKey]];
+}
+
+-(void)finishLoadRetry:(ChatSDKRequestResult)result
+{
+    ChatSDKRequestDone done=loadRetryDone;
+    loadRetryDone=nil;
+    if(done)
+    {
+        done(result);
+    }
+}
+
+-(void)cancelLoadRetry
+{
+    loadRetryDone=nil;
+    [[owner requestSchedulerForSession:self] cancelRequestsWithKey:[self loadRetryKey]];
+}
+
+#pragma mark WebView Delegate
+-(void)chatWebViewDidFinishLoad:(ChatSDKWebView *)webView
+{
+    // A web view this session let go of, or the error page. The pooled blank page is never forwarded
+    if(webView!=chatWebview || !firstTimeFlag)
+    {
+        return;
+    }
+    [self finishLoadRetry:ChatSDKRequestSucceeded];
+    // The page may have landed on another URL than the one loaded
+    [ChatSDKURLProtocol registerBridge:cache forDocumentURL:webView.currentURL];
+
+    //Keyboard Up Event Fix on iOS7, compiled with iOS7
+    if([[[UIDevice currentDevice] systemVersion] floatValue] >=7.0f && COMPILED_WITH_VER>=7)
+    {
+
+        if(UI_USER_INTERFACE_IDIOM() == UIUserInterfaceIdiomPad){
+
+            [chatWebview evaluateJavaScript:@"document.addEventListener('touchstart',function(e){var tag = e.target.tagName; if(tag && ((tag.toLowerCase() === 'input' && e.target.type === 'text') || (tag.toLowerCase() === 'textarea'))){setTimeout(function(){e.target.focus();},0);}}); window.onorientationchange = function(){if((window.orientation == 90 || window.orientation == -90 || window.orientation == 0 || window.orientation == 180) && (document.activeElement && (document.activeElement.tagName.toLowerCase() === 'input' || document.activeElement.tagName.toLowerCase() === 'textarea'))){ var elem = document.activeElement;elem.blur();elem.focus();}}; var metaTag = document.getElementsByTagName(\"meta\"); metaTag[0].parentNode.removeChild(metaTag[0]);"];
+        }
+        else{
+
+            [chatWebview evaluateJavaScript:@"document.addEventListener('touchstart',function(e){var tag = e.target.tagName; if(tag && ((tag.toLowerCase() === 'input' && e.target.type === 'text') || (tag.toLowerCase() === 'textarea'))){setTimeout(function(){e.target.focus();},0);}}); window.onorientationchange = function(){if((window.orientation == 90 || window.orientation == -90) && (document.activeElement && (document.activeElement.tagName.toLowerCase() === 'input' || document.activeElement.tagName.toLowerCase() === 'textarea'))){ var elem = document.activeElement;elem.blur();elem.focus();}}; var metaTag = document.getElementsByTagName(\"meta\"); metaTag[0].parentNode.removeChild(metaTag[0]);"];
+        }
+    }
+
+    //Viewport fix
+    NSString* js =
+    @"var meta = document.createElement('meta'); "
+    @"meta.setAttribute( 'name', 'viewport' ); "
+    @"meta.setAttribute( 'content', 'width = 320px, initial-scale = 1.0, user-scalable = yes' ); "
+    @"document.getElementsByTagName('head')[0].appendChild(meta)";
+    [chatWebview evaluateJavaScript: js];
+
+    //Preloaded chat stays hidden until start attaches it
+    if(chatPrewarmed)
+    {
+        prewarmLoaded=YES;
+        return;
+    }
+
+    [self presentLoadedChat];
+}
+
+//Shows the loaded chat app
+-(void)presentLoadedChat
+{
+    /*
+     location tracking starts after loading webView Completely,
+     because we are sending it to JS Bridge via webView.
+     */
+    [owner sessionDidPresent:self];
+
+    [self hideLoadingIndicator];
+
+    [chatWebview showWithAnimation];
+    [[owner windowForSession:self] addSubview:chatWebview];
+
+    // The next chat gets a warm engine
+    [manager fillPoolWithEngine:requestedEngine];
+}
+
+-(void)chatWebView:(ChatSDKWebView *)webView didFailLoadWithError:(NSError *)error
+{
+    // A load replaced by the next one, or a web view this session let go of
+    if(webView!=chatWebview || ([[error domain] isEqualToString:NSURLErrorDomain] && [error code]==NSURLErrorCancelled))
+    {
+        return;
+    }
+    //Nobody is waiting for a preloaded chat, just drop it
+    if(chatPrewarmed)
+    {
+        [self releaseIfPrewarmed];
+        return;
+    }
+    NSLog(@"indidfailloadwitherror");
+    firstTimeFlag = FALSE;
+
+    //No network, the chat app is loaded again once there is, the error page only comes after the last attempt
+    if([ChatSDKRequestScheduler isConnectivityError:error] && (loadRetryDone==nil || !loadRetryIsLast))
+    {
+        if(loadRetryDone!=nil)
+        {
+            [self finishLoadRetry:ChatSDKRequestRetry];
+        }
+        else
+        {
+            [self scheduleLoadRetry];
+        }
+        return;
+    }
+    [self finishLoadRetry:ChatSDKRequestFailed];
+    [self hideLoadingIndicator];
+
+    [chatWebview loadHTMLString:ERROR_PAGE_STRING baseURL:nil];
+    [[owner windowForSession:self] addSubview:chatWebview];
+}
+
+- (BOOL)chatWebView:(ChatSDKWebView *)webView shouldStartLoadWithRequest:(NSURLRequest *)request
+{
+    if(webView!=chatWebview)
+    {
+        return NO;
+    }
+    if([[[request URL] absoluteString] rangeOfString:@"chatsdk_closedialog"].location != NSNotFound)
+    {
+        // Calling Function to destroy ChatWebview.
+        [self end];
+        firstTimeFlag = FALSE;
+        // Creating a blank NSDictionary.
+        dispatch_async(dispatch_get_main_queue(), ^(void) {
+            NSDictionary *tempDict = [[NSDictionary alloc] init];
+            // CALLING DELEGATE FUNCTION WHICH WILL NOTIFY APPLICATION ABOUT ENDCHAT
+            [self.callbacks onChatEndedDelegateHandler:tempDict];
+        });
+        return NO;
+    }
+    else if([[[request URL] absoluteString] hasPrefix:[NSString stringWithFormat:@"http://%@",[ChatSDKConfiguration sharedConfiguration].customUrlScheme]])
+    {
+        // Creating a blank NSDictionary.
+        dispatch_async(dispatch_get_main_queue(), ^(void) {
+            // CALLING DELEGATE FUNCTION WITH URL WHICH WILL NOTIFY APPLICATION ABOUT CUSTOM URL
+            NSDictionary *tempDict = [[NSDictionary alloc] initWithObjects:[NSArray arrayWithObject:[[request URL] absoluteString]] forKeys:[NSArray arrayWithObject:@"url"]];
+            [self.callbacks onNavigationRequestHandler:tempDict];
+        });
+        return NO;
+    }
+    else if([[[request URL] absoluteString] hasPrefix:[NSString stringWithFormat:@"http://chat_exec_agentmessage"]])
+    {
+        NSDictionary *params=[ChatSDKBridgeCodec JSONObjectWithPercentEncodedQuery:[[request URL] query]];
+        id data=[params isKindOfClass:[NSDictionary class]] ? [params objectForKey:@"data"] : nil;
+
+        // Already on main, the badge batches a burst into one redraw & the callbacks coalesce it
+        //Increment badge count if chat is minimized
+        if(chatWebview.hidden)
+        {
+            [self incrementBadgeCount];
+        }
+        [self recordTranscriptEntryOfType:@"agentmessage" data:data];
+        // CALLING DELEGATE FUNCTION WHICH WILL NOTIFY APPLICATION ABOUT ONAGENTMESSAGE
+        [self.callbacks onAgentMessageDelegateHandler:data];
+
+        return NO;
+    }
+    else
+    {
+        if(firstTimeFlag == TRUE)
+        {
+            [[UIApplication sharedApplication] openURL:[NSURL URLWithString:[[request URL] absoluteString] ]];
+            return NO;
+        }
+        else
+        {
+            // Assigning flag to TRUE.
+            firstTimeFlag = TRUE;
+            [ChatSDKURLProtocol registerBridge:cache forDocumentURL:[request URL]];
+            return YES;
+        }
+    }
+    return YES;
+}
+
+// UICOLOR FROM HEXADECIMAL VALUE
+-(UIColor *)colorFromHexString:(NSString *)hexString {
+    unsigned rgbValue = 0;
+    NSScanner *scanner = [NSScanner scannerWithString:hexString];
+    [scanner setScanLocation:1]; // bypass '#' character
+    [scanner scanHexInt:&rgbValue];
+    return [UIColor colorWithRed:((rgbValue & 0xFF0000) >> 16)/255.0 green:((rgbValue & 0xFF00) >> 8)/255.0 blue:(rgbValue & 0xFF)/255.0 alpha:1.0];
+}
+
+-(ChatSDKMaximizeButton *)createChatButton
+{
+    //Creating ChatSDKMaximizeButton
+    ChatSDKMaximizeButton *chatBtn = [[ChatSDKMaximizeButton alloc] init];
+
+    ChatSDKConfiguration *configuration = [ChatSDKConfiguration sharedConfiguration];
+    UIColor *backgroundColor = [self colorFromHexString:configuration.minimizedButtonBackgroundColor];
+    [chatBtn setBackgroundColor:backgroundColor];
+    UIColor *textColor = [self colorFromHexString:configuration.minimizedButtonTextColor];
+    [chatBtn setTitleColor:textColor forState:UIControlStateNormal];
+    [chatBtn addTarget:self action:@selector(chatButtonClicked) forControlEvents:UIControlEventTouchUpInside];
+
+    return chatBtn;
+}
+
+- (void)dealloc {
+    [prewarmTimer invalidate];
+    [hibernateTimer invalidate];
+    [hibernateReadyTimer invalidate];
+    // This session is going away, so stop answering its chat app's requests
+    [ChatSDKURLProtocol unregisterBridge:cache];
+}
+
+@end
@@ -0,0 +1,107 @@
+//
+//  ChatSDKSessionManager.h
+//  247ChatSDK
+//
+//  Copyright (c) 2014 . All rights reserved.
+//
+
+#import <UIKit/UIKit.h>
+#import <CoreLocation/CoreLocation.h>
+#import "ChatSDKSession.h"
+#import "ChatSDKWebView.h"
+#import "ChatSDKRequestScheduler.h"
+
+@class ChatSDKAssetCache;
+@class ChatSDKBridgeActionRegistry;
+@class ChatSDKTranscriptStore;
+@class ChatSDKSessionManager;
+
+// Resident memory of the app in bytes, 0 when it can not be read. Defined in ChatSDK.m
+extern unsigned long long ChatSDKResidentMemory(void);
+
+// What a session needs from ChatSDK, which keeps the state shared by all chats
+@protocol ChatSDKSessionOwner <NSObject>
+-(UIWindow *)windowForSession:(ChatSDKSession *)session;
+// Callbacks of a session the application did not give its own
+-(ChatSDKCallbacks *)callbacksForSession:(ChatSDKSession *)session;
+-(ChatSDKAssetCache *)assetCacheForSession:(ChatSDKSession *)session;
+// Actions that do not depend on the session, e.g. those of the application
+-(ChatSDKBridgeActionRegistry *)bridgeActionsForSession:(ChatSDKSession *)session;
+// nil when transcripts are not kept
+-(ChatSDKTranscriptStore *)transcriptStoreForSession:(ChatSDKSession *)session;
+// Seconds a session stays minimized before it hibernates, 0 only hibernates on memory warning
+-(NSTimeInterval)hibernationDelayForSession:(ChatSDKSession *)session;
+// Retries of a chat load that failed for want of network
+-(ChatSDKRequestScheduler *)requestSchedulerForSession:(ChatSDKSession *)session;
+// The loaded chat came into view, location is tracked from now on
+-(void)sessionDidPresent:(ChatSDKSession *)session;
+-(void)sessionDidChangeMinimized:(ChatSDKSession *)session;
+-(void)sessionDidEnd:(ChatSDKSession *)session;
+@end
+
+// Used by ChatSDK & ChatSDKSessionManager only
+@interface ChatSDKSession (ChatSDKSessionManager)
+
+// tag is the chatsdk_session of the chat page URL, nil for the default session of startChat
+-(id)initWithQueue:(NSString *)queueId contextInfo:(NSDictionary *)contextInfo tag:(NSString *)tag owner:(id<ChatSDKSessionOwner>)owner manager:(ChatSDKSessionManager *)manager;
+
+-(NSString *)tag;
+
+// Loaded hidden by preloadWithTimeout: & not started yet
+-(BOOL)isPrewarmed;
+
+// Loads the chat hidden, it is released after timeout unless started, 0 keeps it
+-(void)preloadWithTimeout:(NSTimeInterval)timeout;
+-(void)releaseIfPrewarmed;
+
+-(void)sendApplicationStatus:(NSString *)status;
+-(void)sendLocation:(CLLocation *)location;
+
+// Minimized with its chat view released, see hibernate
+-(BOOL)isHibernated;
+
+// Releases the chat view of a minimized session, the minimize button & its badge stay and maximize
+// loads the chat again. Does nothing to a session that is not minimized
+-(void)hibernate;
+
+// hibernate without waiting for the chat app to answer, the chat view is released instead of going to the
+// pool. For memory warnings
+-(void)hibernateImmediately;
+
+// An agent message that arrived outside the chat view, e.g. by push notification. Counted on the badge
+// of a hibernated session, NO when the chat view is loaded & gets the message itself
+-(BOOL)receiveAgentMessage:(id)data;
+
+@end
+
+/*
+ * ChatSDKSessionManager  The open sessions & a pool of idle chat web views. Creating the WebKit engine of a
+                          web view is the larger part of a cold chat load, so a pooled view that already ran
+                          a blank page is handed to the next session, and an ended session gives its view
+                          back. Main thread only.
+ */
+@interface ChatSDKSessionManager : NSObject
+
+// Idle web views kept, 0 turns the pool off. Default value : 1
+@property (nonatomic, assign) NSUInteger poolSize;
+
+@property (nonatomic, readonly) NSArray *sessions;
+
+-(void)addSession:(ChatSDKSession *)session;
+-(void)removeSession:(ChatSDKSession *)session;
+
+// Open session of queueId, nil when there is none
+-(ChatSDKSession *)sessionForQueue:(NSString *)queueId;
+
+// A pooled web view of engine, or a new one
+-(ChatSDKWebView *)dequeueWebViewWithEngine:(ChatSDKWebEngine)engine;
+
+// Blanks webView, made for engine, & keeps it for the next session while the pool has room
+-(void)recycleWebView:(ChatSDKWebView *)webView engine:(ChatSDKWebEngine)engine;
+
+// Creates the missing idle web views on a later run loop turn, so it does not delay the chat being shown
+-(void)fillPoolWithEngine:(ChatSDKWebEngine)engine;
+
+-(void)drainPool;
+
+@end
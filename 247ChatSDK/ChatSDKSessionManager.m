@@ -0,0 +1,121 @@
+//
+//  ChatSDKSessionManager.m
+//  247ChatSDK
+//
+//  Copyright (c) 2014 . All rights reserved.
+//
+
+#import "ChatSDKSessionManager.h"
+
+@interface ChatSDKSessionManager ()
+{
+    NSMutableArray *openSessions;
+    // Blank ChatSDKWebViews waiting for a session, made for poolEngine (WKWebView may fall back to UIWebView)
+    NSMutableArray *idleWebViews;
+    ChatSDKWebEngine poolEngine;
+    BOOL fillScheduled;
+}
+@end
+
+@implementation ChatSDKSessionManager
+
+@synthesize poolSize = _poolSize;
+
+-(id)init
+{
+    if (self = [super init]) {
+        openSessions = [[NSMutableArray alloc] init];
+        idleWebViews = [[NSMutableArray alloc] init];
+        _poolSize = 1;
+    }
+    return self;
+}
+
+-(void)setPoolSize:(NSUInteger)poolSize
+{
+    _poolSize = poolSize;
+    while ([idleWebViews count] > _poolSize) {
+        [idleWebViews removeLastObject];
+    }
+}
+
+-(NSArray *)sessions
+{
+    return [NSArray arrayWithArray:openSessions];
+}
+
+-(void)addSession:(ChatSDKSession *)session
+{
+    if (session != nil && ![openSessions containsObject:session]) {
+        [openSessions addObject:session];
+    }
+}
+
+-(void)removeSession:(ChatSDKSession *)session
+{
+    [openSessions removeObject:session];
+}
+
+-(ChatSDKSession *)sessionForQueue:(NSString *)queueId
+{
+    for (ChatSDKSession *session in openSessions) {
+        if (session.queueId == queueId || [session.queueId isEqualToString:queueId]) {
+            return session;
+        }
+    }
+    return nil;
+}
+
+-(ChatSDKWebView *)dequeueWebViewWithEngine:(ChatSDKWebEngine)engine
+{
+    if (engine == poolEngine && [idleWebViews count] > 0) {
+        ChatSDKWebView *webView = [idleWebViews lastObject];
+        [idleWebViews removeLastObject];
+        return webView;
+    }
+    return [[ChatSDKWebView alloc] initWithEngine:engine];
+}
+
+-(void)recycleWebView:(ChatSDKWebView *)webView engine:(ChatSDKWebEngine)engine
+{
+    if (webView == nil) {
+        return;
+    }
+    [webView prepareForReuse];
+    if (engine != poolEngine) {
+        [idleWebViews removeAllObjects];
+        poolEngine = engine;
+    }
+    if ([idleWebViews count] < _poolSize && ![idleWebViews containsObject:webView]) {
+        [idleWebViews addObject:webView];
+    }
+}
+
+-(void)fillPoolWithEngine:(ChatSDKWebEngine)engine
+{
+    if (engine != poolEngine) {
+        // Views of the other engine are of no use since chatsdkconfig.plist changed
+        [idleWebViews removeAllObjects];
+        poolEngine = engine;
+    }
+    if (fillScheduled || [idleWebViews count] >= _poolSize) {
+        return;
+    }
+    fillScheduled = YES;
+    // After the chat being shown got its frames
+    dispatch_async(dispatch_get_main_queue(), ^{
+        fillScheduled = NO;
+        while ([idleWebViews count] < _poolSize) {
+            ChatSDKWebView *webView = [[ChatSDKWebView alloc] initWithEngine:poolEngine];
+            [webView prepareForReuse];
+            [idleWebViews addObject:webView];
+        }
+    });
+}
+
+-(void)drainPool
+{
+    [idleWebViews removeAllObjects];
+}
+
+@end
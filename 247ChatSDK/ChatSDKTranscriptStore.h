@@ -0,0 +1,45 @@
+//
+//  ChatSDKTranscriptStore.h
+//  247ChatSDK
+//
+//  Copyright (c) 2014 . All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/*
+ * ChatSDKTranscriptStore  SQLite copy of what the chat app showed, one transcript per key (the queueId of a
+                           session), so that a chat reopened after endChat, a failed load or a relaunch can
+                           render its history before it reconnects. Entries older than maximumAge and the
+                           oldest entries above maximumSize are dropped. Appends return at once and are
+                           written in order on a queue of the store, reads see every append made before them.
+                           On iOS the files are protected until the device is first unlocked.
+                           May be used from any thread.
+ */
+@interface ChatSDKTranscriptStore : NSObject
+
+// Seconds an entry is kept, 0 keeps it until maximumSize is reached. Default value : 86400
+@property (atomic, assign) NSTimeInterval maximumAge;
+
+// Bytes of entry data kept over all transcripts, 0 means no limit. Default value : 262144
+@property (atomic, assign) unsigned long long maximumSize;
+
+// Caches/ChatSDKTranscript/transcript.sqlite
++(NSString *)defaultPath;
+
+-(id)initWithPath:(NSString *)path;
+
+// data must be serializable to JSON, e.g. the data of onagentmessage
+-(void)appendEntryOfType:(NSString *)type data:(id)data toTranscript:(NSString *)transcript;
+
+// Entries with a sequence above sequence, oldest first: [{"seq", "type", "time" (seconds since 1970), "data"}].
+// limit 0 returns all of them
+-(NSArray *)entriesOfTranscript:(NSString *)transcript afterSequence:(long long)sequence limit:(NSUInteger)limit;
+
+// Like entriesOfTranscript:afterSequence:limit: without blocking the caller, completion runs on the store queue
+-(void)entriesOfTranscript:(NSString *)transcript afterSequence:(long long)sequence limit:(NSUInteger)limit completion:(void (^)(NSArray *entries))completion;
+
+-(void)removeTranscript:(NSString *)transcript;
+-(void)removeAllTranscripts;
+
+@end
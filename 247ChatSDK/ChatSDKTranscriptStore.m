@@ -0,0 +1,315 @@
+//
+//  ChatSDKTranscriptStore.m
+//  247ChatSDK
+//
+//  Copyright (c) 2014 . All rights reserved.
+//
+
+#import "ChatSDKTranscriptStore.h"
+#import <sqlite3.h>
+
+// Appends between two checks of maximumAge
+static const NSUInteger kTrimInterval = 32;
+
+// Transcripts hold what the visitor wrote, they stay encrypted until the device was unlocked once. The SQLite
+// of iOS applies it to the database, its -wal & its -shm, other SQLites leave the files as they are
+#ifdef SQLITE_OPEN_FILEPROTECTION_COMPLETEUNTILFIRSTUSERAUTHENTICATION
+static const int kFileProtectionFlags = SQLITE_OPEN_FILEPROTECTION_COMPLETEUNTILFIRSTUSERAUTHENTICATION;
+#else
+static const int kFileProtectionFlags = 0;
+#endif
+
+static const char *kSchema =
+"PRAGMA journal_mode=WAL;"
+"PRAGMA synchronous=NORMAL;"
+"CREATE TABLE IF NOT EXISTS entries (seq INTEGER PRIMARY KEY AUTOINCREMENT, transcript TEXT NOT NULL, type TEXT NOT NULL, time REAL NOT NULL, data BLOB NOT NULL);"
+"CREATE INDEX IF NOT EXISTS entries_transcript ON entries (transcript, seq);";
+
+@interface ChatSDKTranscriptStore ()
+{
+    NSString *databasePath;
+    // Everything below is only touched on storeQueue
+    dispatch_queue_t storeQueue;
+    sqlite3 *database;
+    sqlite3_stmt *insertStatement;
+    sqlite3_stmt *selectStatement;
+    // Bytes of entry data in the database
+    unsigned long long storedBytes;
+    NSUInteger appendsSinceTrim;
+}
+@end
+
+@implementation ChatSDKTranscriptStore
+
+@synthesize maximumAge = _maximumAge;
+@synthesize maximumSize = _maximumSize;
+
++(NSString *)defaultPath
+{
+    NSString *cachesDirectory = [NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES) lastObject];
+    return [[cachesDirectory stringByAppendingPathComponent:@"ChatSDKTranscript"] stringByAppendingPathComponent:@"transcript.sqlite"];
+}
+
+-(id)initWithPath:(NSString *)path
+{
+    self = [super init];
+    if (self) {
+        databasePath = [path copy];
+        storeQueue = dispatch_queue_create("com.inc247.transcriptStoreQueue", NULL);
+        _maximumAge = 86400;
+        _maximumSize = 262144;
+    }
+    return self;
+}
+
+-(void)dealloc
+{
+    // The queue's blocks retain the store, none of them is left
+    [self closeDatabase];
+}
+
+-(void)appendEntryOfType:(NSString *)type data:(id)data toTranscript:(NSString *)transcript
+{
+    // Wrapped in an array so that strings & numbers serialize too
+    NSArray *wrapped = [NSArray arrayWithObject:data ? data : [NSNull null]];
+    if (type == nil || ![NSJSONSerialization isValidJSONObject:wrapped]) {
+        return;
+    }
+    // Serialized on the caller's thread, data may change after this returns
+    NSData *json = [NSJSONSerialization dataWithJSONObject:wrapped options:0 error:NULL];
+    NSString *key = transcript ? transcript : @"";
+    NSTimeInterval time = [[NSDate date] timeIntervalSince1970];
+
+    dispatch_async(storeQueue, ^(void) {
+        if (![self openDatabase]) {
+            return;
+        }
+        sqlite3_bind_text(insertStatement, 1, [key UTF8String], -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(insertStatement, 2, [type UTF8String], -1, SQLITE_TRANSIENT);
+        sqlite3_bind_double(insertStatement, 3, time);
+        sqlite3_bind_blob(insertStatement, 4, [json bytes], (int)[json length], SQLITE_STATIC);
+        if (sqlite3_step(insertStatement) != SQLITE_DONE) {
+            NSLog(@"Chat transcript entry not saved > %s", sqlite3_errmsg(database));
+        } else {
+            storedBytes += [json length];
+        }
+        sqlite3_reset(insertStatement);
+        sqlite3_clear_bindings(insertStatement);
+
+        unsigned long long maximumSize = self.maximumSize;
+        if (++appendsSinceTrim >= kTrimInterval || (maximumSize > 0 && storedBytes > maximumSize)) {
+            [self trim];
+        }
+    });
+}
+
+-(NSArray *)entriesOfTranscript:(NSString *)transcript afterSequence:(long long)sequence limit:(NSUInteger)limit
+{
+    __block NSArray *entries = nil;
+    dispatch_sync(storeQueue, ^(void) {
+        entries = [self readEntriesOfTranscript:transcript afterSequence:sequence limit:limit];
+    });
+    return entries;
+}
+
+-(void)entriesOfTranscript:(NSString *)transcript afterSequence:(long long)sequence limit:(NSUInteger)limit completion:(void (^)(NSArray *entries))completion
+{
+    if (completion == nil) {
+        return;
+    }
+    dispatch_async(storeQueue, ^(void) {
+        completion([self readEntriesOfTranscript:transcript afterSequence:sequence limit:limit]);
+    });
+}
+
+-(void)removeTranscript:(NSString *)transcript
+{
+    NSString *key = transcript ? transcript : @"";
+    dispatch_async(storeQueue, ^(void) {
+        if (![self openDatabase]) {
+            return;
+        }
+        [self deleteEntriesWhere:"transcript = ?" bind:^(sqlite3_stmt *query) {
+            sqlite3_bind_text(query, 1, [key UTF8String], -1, SQLITE_TRANSIENT);
+        }];
+    });
+}
+
+-(void)removeAllTranscripts
+{
+    dispatch_async(storeQueue, ^(void) {
+        if (![self openDatabase]) {
+            return;
+        }
+        sqlite3_exec(database, "DELETE FROM entries", NULL, NULL, NULL);
+        storedBytes = 0;
+    });
+}
+
+#pragma mark - Database
+
+// Opens the database on first use, a database that can not be read is replaced by an empty one
+-(BOOL)openDatabase
+{
+    if (database != NULL) {
+        return YES;
+    }
+    [self createDirectory];
+
+    for (int attempt = 0; attempt < 2; attempt++) {
+        if (sqlite3_open_v2([databasePath fileSystemRepresentation], &database, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX | kFileProtectionFlags, NULL) == SQLITE_OK
+            && sqlite3_exec(database, kSchema, NULL, NULL, NULL) == SQLITE_OK
+            && sqlite3_prepare_v2(database, "INSERT INTO entries (transcript, type, time, data) VALUES (?, ?, ?, ?)", -1, &insertStatement, NULL) == SQLITE_OK
+            && sqlite3_prepare_v2(database, "SELECT seq, type, time, data FROM entries WHERE transcript = ? AND seq > ? AND time >= ? ORDER BY seq LIMIT ?", -1, &selectStatement, NULL) == SQLITE_OK) {
+            [self protectExistingFiles];
+            storedBytes = [self queryStoredBytes];
+            [self trim];
+            return YES;
+        }
+        NSLog(@"Chat transcript store could not be opened > %s", database ? sqlite3_errmsg(database) : "out of memory");
+        [self closeDatabase];
+        [[NSFileManager defaultManager] removeItemAtPath:databasePath error:NULL];
+        [[NSFileManager defaultManager] removeItemAtPath:[databasePath stringByAppendingString:@"-wal"] error:NULL];
+        [[NSFileManager defaultManager] removeItemAtPath:[databasePath stringByAppendingString:@"-shm"] error:NULL];
+    }
+    return NO;
+}
+
+-(void)createDirectory
+{
+    NSDictionary *attributes = nil;
+#ifdef SQLITE_OPEN_FILEPROTECTION_COMPLETEUNTILFIRSTUSERAUTHENTICATION
+    attributes = [NSDictionary dictionaryWithObject:NSFileProtectionCompleteUntilFirstUserAuthentication forKey:NSFileProtectionKey];
+#endif
+    [[NSFileManager defaultManager] createDirectoryAtPath:[databasePath stringByDeletingLastPathComponent] withIntermediateDirectories:YES attributes:attributes error:NULL];
+}
+
+// Files written by an earlier version of the SDK were created without protection
+-(void)protectExistingFiles
+{
+#ifdef SQLITE_OPEN_FILEPROTECTION_COMPLETEUNTILFIRSTUSERAUTHENTICATION
+    NSDictionary *attributes = [NSDictionary dictionaryWithObject:NSFileProtectionCompleteUntilFirstUserAuthentication forKey:NSFileProtectionKey];
+    NSArray *paths = [NSArray arrayWithObjects:[databasePath stringByDeletingLastPathComponent], databasePath, [databasePath stringByAppendingString:@"-wal"], [databasePath stringByAppendingString:@"-shm"], nil];
+    for (NSString *path in paths) {
+        if ([[NSFileManager defaultManager] fileExistsAtPath:path]) {
+            [[NSFileManager defaultManager] setAttributes:attributes ofItemAtPath:path error:NULL];
+        }
+    }
+#endif
+}
+
+-(void)closeDatabase
+{
+    sqlite3_finalize(insertStatement);
+    insertStatement = NULL;
+    sqlite3_finalize(selectStatement);
+    selectStatement = NULL;
+    sqlite3_close(database);
+    database = NULL;
+}
+
+-(unsigned long long)queryStoredBytes
+{
+    unsigned long long bytes = 0;
+    sqlite3_stmt *statement = NULL;
+    if (sqlite3_prepare_v2(database, "SELECT IFNULL(SUM(LENGTH(data)), 0) FROM entries", -1, &statement, NULL) == SQLITE_OK && sqlite3_step(statement) == SQLITE_ROW) {
+        bytes = (unsigned long long)sqlite3_column_int64(statement, 0);
+    }
+    sqlite3_finalize(statement);
+    return bytes;
+}
+
+// Deletes the entries matching condition, whose parameters bind sets, & takes their bytes off storedBytes
+-(void)deleteEntriesWhere:(const char *)condition bind:(void (^)(sqlite3_stmt *statement))bind
+{
+    unsigned long long bytes = 0;
+    sqlite3_stmt *statement = NULL;
+    if (sqlite3_prepare_v2(database, [[NSString stringWithFormat:@"SELECT IFNULL(SUM(LENGTH(data)), 0) FROM entries WHERE %s", condition] UTF8String], -1, &statement, NULL) == SQLITE_OK) {
+        bind(statement);
+        if (sqlite3_step(statement) == SQLITE_ROW) {
+            bytes = (unsigned long long)sqlite3_column_int64(statement, 0);
+        }
+    }
+    sqlite3_finalize(statement);
+    if (bytes == 0) {
+        return;
+    }
+
+    statement = NULL;
+    if (sqlite3_prepare_v2(database, [[NSString stringWithFormat:@"DELETE FROM entries WHERE %s", condition] UTF8String], -1, &statement, NULL) == SQLITE_OK) {
+        bind(statement);
+        if (sqlite3_step(statement) == SQLITE_DONE) {
+            storedBytes = storedBytes > bytes ? storedBytes - bytes : 0;
+        }
+    }
+    sqlite3_finalize(statement);
+}
+
+// Drops the entries older than maximumAge, then the oldest ones until a quarter below maximumSize
+-(void)trim
+{
+    appendsSinceTrim = 0;
+
+    NSTimeInterval maximumAge = self.maximumAge;
+    if (maximumAge > 0) {
+        NSTimeInterval oldest = [[NSDate date] timeIntervalSince1970] - maximumAge;
+        [self deleteEntriesWhere:"time < ?" bind:^(sqlite3_stmt *query) {
+            sqlite3_bind_double(query, 1, oldest);
+        }];
+    }
+
+    unsigned long long maximumSize = self.maximumSize;
+    if (maximumSize == 0 || storedBytes <= maximumSize) {
+        return;
+    }
+    // Room for the next appends before trimming again. The oldest entries are walked until enough bytes are
+    // found, then deleted with one statement
+    unsigned long long excess = storedBytes - (maximumSize - maximumSize / 4);
+    unsigned long long freed = 0;
+    long long lastSequence = -1;
+    sqlite3_stmt *statement = NULL;
+    if (sqlite3_prepare_v2(database, "SELECT seq, LENGTH(data) FROM entries ORDER BY seq", -1, &statement, NULL) == SQLITE_OK) {
+        while (freed < excess && sqlite3_step(statement) == SQLITE_ROW) {
+            lastSequence = sqlite3_column_int64(statement, 0);
+            freed += (unsigned long long)sqlite3_column_int64(statement, 1);
+        }
+    }
+    sqlite3_finalize(statement);
+    if (lastSequence >= 0) {
+        [self deleteEntriesWhere:"seq <= ?" bind:^(sqlite3_stmt *query) {
+            sqlite3_bind_int64(query, 1, lastSequence);
+        }];
+    }
+}
+
+-(NSArray *)readEntriesOfTranscript:(NSString *)transcript afterSequence:(long long)sequence limit:(NSUInteger)limit
+{
+    NSMutableArray *entries = [NSMutableArray array];
+    if (![self openDatabase]) {
+        return entries;
+    }
+    NSTimeInterval maximumAge = self.maximumAge;
+    NSTimeInterval oldest = maximumAge > 0 ? [[NSDate date] timeIntervalSince1970] - maximumAge : 0;
+
+    sqlite3_bind_text(selectStatement, 1, [(transcript ? transcript : @"") UTF8String], -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(selectStatement, 2, sequence);
+    sqlite3_bind_double(selectStatement, 3, oldest);
+    sqlite3_bind_int64(selectStatement, 4, limit > 0 ? (sqlite3_int64)limit : -1);
+    while (sqlite3_step(selectStatement) == SQLITE_ROW) {
+        const char *type = (const char *)sqlite3_column_text(selectStatement, 1);
+        NSData *json = [NSData dataWithBytes:sqlite3_column_blob(selectStatement, 3) length:sqlite3_column_bytes(selectStatement, 3)];
+        NSArray *wrapped = [NSJSONSerialization JSONObjectWithData:json options:0 error:NULL];
+        if (type == NULL || ![wrapped isKindOfClass:[NSArray class]] || [wrapped count] != 1) {
+            continue;
+        }
+        [entries addObject:@{ @"seq" : [NSNumber numberWithLongLong:sqlite3_column_int64(selectStatement, 0)],
+                              @"type" : [NSString stringWithUTF8String:type],
+                              @"time" : [NSNumber numberWithDouble:sqlite3_column_double(selectStatement, 2)],
+                              @"data" : [wrapped objectAtIndex:0] }];
+    }
+    sqlite3_reset(selectStatement);
+    sqlite3_clear_bindings(selectStatement);
+    return entries;
+}
+
+@end
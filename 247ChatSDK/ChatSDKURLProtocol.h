@@ -0,0 +1,46 @@
+//
+//  ChatSDKURLProtocol.h
+//  247ChatSDK
+//
+//  Copyright (c) 2014 . All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+@class ChatSDKJSBridge;
+
+// Header of the bridge calls of a ChatSDKWebView, carries its identityToken
+extern NSString *const ChatSDKWebViewTokenHeader;
+
+/*
+ * ChatSDKURLProtocol  Answers chat_exec calls & cached chat app assets through a ChatSDKJSBridge, but only
+                       for requests of a page of a registered host (by mainDocumentURL). Requests of the
+                       host app carry no main document and are let through after one nil check, and the
+                       shared NSURLCache is never touched.
+                       Several chats of one host are told apart by the web view they run in: the
+                       ChatSDKWebViewTokenHeader of their bridge calls, else their page URL as last
+                       registered, else the chatsdk_session parameter of that URL, which a redirect or
+                       pushState may drop.
+ */
+@interface ChatSDKURLProtocol : NSURLProtocol
+
+// Intercepts the requests of pages of host, replaces any bridge registered for it
++(void)registerBridge:(ChatSDKJSBridge *)bridge forHost:(NSString *)host;
+
+// Intercepts the requests of pages of host whose URL carries chatsdk_session=session, nil session is the same
+// as registerBridge:forHost:
++(void)registerBridge:(ChatSDKJSBridge *)bridge forHost:(NSString *)host session:(NSString *)session;
+
+// Intercepts the requests carrying ChatSDKWebViewTokenHeader token, i.e. those of the web view of token
++(void)registerBridge:(ChatSDKJSBridge *)bridge forWebViewToken:(NSString *)token;
+
+// Intercepts the requests of the page at url, the fragment aside. Called again as the page moves to another URL
++(void)registerBridge:(ChatSDKJSBridge *)bridge forDocumentURL:(NSURL *)url;
+
+// url with chatsdk_session=session added to its query
++(NSURL *)URL:(NSURL *)url taggedWithSession:(NSString *)session;
+
+// Stops intercepting for every host bridge was registered for
++(void)unregisterBridge:(ChatSDKJSBridge *)bridge;
+
+@end
@@ -0,0 +1,193 @@
+//
+//  ChatSDKURLProtocol.m
+//  247ChatSDK
+//
+//  Copyright (c) 2014 . All rights reserved.
+//
+
+#import "ChatSDKURLProtocol.h"
+#import "ChatSDKJSBridge.h"
+#import "ChatSDKBridgeCodec.h"
+#import "ChatSDKAssetCache.h"
+
+NSString *const ChatSDKWebViewTokenHeader = @"X-ChatSDK-WebView";
+
+// lowercase host, "host|session", "token|<token>" or "document|<url>" -> ChatSDKJSBridge, replaced as a whole
+// under the class lock
+static NSDictionary *scopedBridges = nil;
+
+static NSString *const ChatSDKSessionParameter = @"chatsdk_session=";
+
+// Session tag of a chat page URL, nil for the untagged chat
+static NSString *ChatSDKSessionOfURL(NSURL *url)
+{
+    NSString *query = [url query];
+    if (query == nil) {
+        return nil;
+    }
+    for (NSString *parameter in [query componentsSeparatedByString:@"&"]) {
+        if ([parameter hasPrefix:ChatSDKSessionParameter]) {
+            return [parameter substringFromIndex:[ChatSDKSessionParameter length]];
+        }
+    }
+    return nil;
+}
+
+static NSString *ChatSDKBridgeKey(NSString *host, NSString *session)
+{
+    NSString *key = [host lowercaseString];
+    return session ? [NSString stringWithFormat:@"%@|%@", key, session] : key;
+}
+
+// Document URL key, the fragment is left out as pushState & anchors change it without a new page
+static NSString *ChatSDKDocumentKey(NSURL *url)
+{
+    NSString *absolute = [url absoluteString];
+    NSRange hash = [absolute rangeOfString:@"#"];
+    if (hash.location != NSNotFound) {
+        absolute = [absolute substringToIndex:hash.location];
+    }
+    return [@"document|" stringByAppendingString:absolute];
+}
+
+@implementation ChatSDKURLProtocol
+
++(void)registerBridge:(ChatSDKJSBridge *)bridge forHost:(NSString *)host
+{
+    [self registerBridge:bridge forHost:host session:nil];
+}
+
++(void)registerBridge:(ChatSDKJSBridge *)bridge forHost:(NSString *)host session:(NSString *)session
+{
+    if (bridge == nil || [host length] == 0) {
+        return;
+    }
+    [self registerBridge:bridge forKey:ChatSDKBridgeKey(host, session)];
+}
+
++(void)registerBridge:(ChatSDKJSBridge *)bridge forWebViewToken:(NSString *)token
+{
+    if (bridge == nil || [token length] == 0) {
+        return;
+    }
+    [self registerBridge:bridge forKey:[@"token|" stringByAppendingString:token]];
+}
+
++(void)registerBridge:(ChatSDKJSBridge *)bridge forDocumentURL:(NSURL *)url
+{
+    if (bridge == nil || [url host] == nil) {
+        return;
+    }
+    [self registerBridge:bridge forKey:ChatSDKDocumentKey(url)];
+}
+
+// A document URL or token moving to another bridge, e.g. a pooled web view reused by the next chat, leaves
+// the previous one
++(void)registerBridge:(ChatSDKJSBridge *)bridge forKey:(NSString *)key
+{
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        [NSURLProtocol registerClass:[ChatSDKURLProtocol class]];
+    });
+    @synchronized(self) {
+        NSMutableDictionary *bridges = scopedBridges ? [scopedBridges mutableCopy] : [NSMutableDictionary dictionary];
+        [bridges setObject:bridge forKey:key];
+        scopedBridges = bridges;
+    }
+}
+
++(void)unregisterBridge:(ChatSDKJSBridge *)bridge
+{
+    if (bridge == nil) {
+        return;
+    }
+    @synchronized(self) {
+        NSMutableDictionary *bridges = [scopedBridges mutableCopy];
+        [bridges removeObjectsForKeys:[scopedBridges allKeysForObject:bridge]];
+        scopedBridges = bridges;
+    }
+}
+
++(NSURL *)URL:(NSURL *)url taggedWithSession:(NSString *)session
+{
+    if (url == nil || session == nil) {
+        return url;
+    }
+    NSString *absolute = [url absoluteString];
+    NSString *fragment = nil;
+    NSRange hash = [absolute rangeOfString:@"#"];
+    if (hash.location != NSNotFound) {
+        fragment = [absolute substringFromIndex:hash.location];
+        absolute = [absolute substringToIndex:hash.location];
+    }
+    NSString *separator = [url query] ? @"&" : @"?";
+    NSString *tagged = [NSString stringWithFormat:@"%@%@%@%@%@", absolute, separator, ChatSDKSessionParameter, session, fragment ? fragment : @""];
+    return [NSURL URLWithString:tagged];
+}
+
+// Bridge answering request, nil when the request is not one of ours
++(ChatSDKJSBridge *)bridgeForRequest:(NSURLRequest *)request
+{
+    NSURL *mainDocumentURL = [request mainDocumentURL];
+    NSString *host = [mainDocumentURL host];
+    if (host == nil) {
+        return nil;
+    }
+    NSString *token = [request valueForHTTPHeaderField:ChatSDKWebViewTokenHeader];
+    // A tagged page only talks to its own session, never to the untagged chat of the host
+    ChatSDKJSBridge *bridge = nil;
+    @synchronized(self) {
+        if (token != nil) {
+            bridge = [scopedBridges objectForKey:[@"token|" stringByAppendingString:token]];
+        }
+        if (bridge == nil) {
+            bridge = [scopedBridges objectForKey:ChatSDKDocumentKey(mainDocumentURL)];
+        }
+        if (bridge == nil) {
+            bridge = [scopedBridges objectForKey:ChatSDKBridgeKey(host, ChatSDKSessionOfURL(mainDocumentURL))];
+        }
+    }
+    if (bridge == nil) {
+        return nil;
+    }
+    if ([ChatSDKBridgeCodec kindOfURL:[request URL]] != ChatSDKBridgeURLNone || [bridge.assetCache hasAssetForRequest:request]) {
+        return bridge;
+    }
+    return nil;
+}
+
++(BOOL)canInitWithRequest:(NSURLRequest *)request
+{
+    return [self bridgeForRequest:request] != nil;
+}
+
++(NSURLRequest *)canonicalRequestForRequest:(NSURLRequest *)request
+{
+    return request;
+}
+
+-(void)startLoading
+{
+    NSURLRequest *request = [self request];
+    NSCachedURLResponse *cachedResponse = [[ChatSDKURLProtocol bridgeForRequest:request] cachedResponseForRequest:request];
+    if (cachedResponse == nil) {
+        if ([ChatSDKBridgeCodec kindOfURL:[request URL]] == ChatSDKBridgeURLNone) {
+            // The asset went away with a version swap since canInitWithRequest:
+            [[self client] URLProtocol:self didFailWithError:[NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorResourceUnavailable userInfo:nil]];
+            return;
+        }
+        // Unknown action, answered like the chat server would
+        NSHTTPURLResponse *notFound = [[NSHTTPURLResponse alloc] initWithURL:[request URL] statusCode:404 HTTPVersion:@"1.1" headerFields:@{@"Access-Control-Allow-Origin" : @"*", @"Content-Length" : @"0"}];
+        cachedResponse = [[NSCachedURLResponse alloc] initWithResponse:notFound data:[NSData data] userInfo:nil storagePolicy:NSURLCacheStorageNotAllowed];
+    }
+    [[self client] URLProtocol:self didReceiveResponse:[cachedResponse response] cacheStoragePolicy:NSURLCacheStorageNotAllowed];
+    [[self client] URLProtocol:self didLoadData:[cachedResponse data]];
+    [[self client] URLProtocolDidFinishLoading:self];
+}
+
+-(void)stopLoading
+{
+    // Answered synchronously in startLoading, nothing to cancel
+}
+
+@end
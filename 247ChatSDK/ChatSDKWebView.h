@@ -8,7 +8,55 @@
 
 #import <UIKit/UIKit.h>
 
-@interface ChatSDKWebView : UIWebView
+@class ChatSDKWebView;
+@protocol ChatSDKJSBridgeDelegate;
+
+// Web view hosting the chat app
+typedef enum {
+    // UIWebView, JS -> native calls are intercepted by ChatSDKJSBridge
+    ChatSDKWebEngineUIWebView,
+    // WKWebView (iOS 8+), JS -> native calls arrive as script messages
+    ChatSDKWebEngineWKWebView
+}ChatSDKWebEngine;
+
+@protocol ChatSDKWebViewDelegate <NSObject>
+-(BOOL)chatWebView:(ChatSDKWebView *)webView shouldStartLoadWithRequest:(NSURLRequest *)request;
+-(void)chatWebViewDidFinishLoad:(ChatSDKWebView *)webView;
+-(void)chatWebView:(ChatSDKWebView *)webView didFailLoadWithError:(NSError *)error;
+@end
+
+// Container view of the chat, laid out & animated here whatever the engine is
+@interface ChatSDKWebView : UIView
+
+@property (nonatomic, readonly) ChatSDKWebEngine engine;
+@property (nonatomic, weak) id<ChatSDKWebViewDelegate> delegate;
+// Executes chat_exec actions posted by the WKWebView engine, unused by UIWebView
+@property (nonatomic, weak) id<ChatSDKJSBridgeDelegate> bridgeDelegate;
+@property (nonatomic, readonly) UIScrollView *scrollView;
+// Queues the chat app's asynchronous chat_exec calls and sends each run loop turn's calls as one batch
+@property (nonatomic, assign) BOOL batchesBridgeCalls;
+// Unique to this view, sent by the UIWebView engine with its chat_exec calls so that ChatSDKURLProtocol
+// finds their bridge whatever page the view shows
+@property (nonatomic, readonly) NSString *identityToken;
+// URL of the page shown, nil when there is none
+@property (nonatomic, readonly) NSURL *currentURL;
+
+// Falls back to ChatSDKWebEngineUIWebView where WKWebView is not available
+-(id)initWithEngine:(ChatSDKWebEngine)engine;
+
+-(void)loadRequest:(NSURLRequest *)request;
+-(void)loadHTMLString:(NSString *)string baseURL:(NSURL *)baseURL;
+-(void)stopLoading;
+// Stops the chat & leaves the view blank, detached & without delegates for the next chat. The delegate never
+// hears of the blank page, even when it finishes after the next chat started loading
+-(void)prepareForReuse;
+// Asynchronous on WKWebView, the result is dropped
+-(void)evaluateJavaScript:(NSString *)script;
+// Hands the envelope of an asynchronously answered chat_exec call to window.NativeBridge._complete
+// Returns the length of the script evaluated
+-(NSUInteger)completeNativeCall:(NSDictionary *)envelope;
++(NSString *)scriptCompletingNativeCall:(NSDictionary *)envelope;
+
 -(void)resetWebView;
 -(void)resetWebViewWithFrame;
 -(void)resetWebViewForIpad;
@@ -8,7 +8,14 @@
 
 #import "ChatSDKWebView.h"
 #import "ChatSDK.h"
-#import "ChatSDKResources.h"
+#import "ChatSDKConfiguration.h"
+#import "ChatSDKLayoutEngine.h"
+#import "ChatSDKAnimationMetrics.h"
+#import "ChatSDKJSBridge.h"
+#import "ChatSDKBridgeAction.h"
+#import "ChatSDKBridgeActionRegistry.h"
+#import "ChatSDKBridgeMetrics.h"
+#import "ChatSDKURLProtocol.h"
 #import <QuartzCore/QuartzCore.h>
 
 
@@ -20,43 +27,153 @@ int COMPILED_WITH_VERSION =7;
 int COMPILED_WITH_VERSION =6;
 #endif
 
+/*
+ Queues the asynchronous GET /!chat_exec/ XHRs of one run loop turn and sends them as one
+ /!chat_exec_batch/?<[{action, id, params}]> request. Each queued XHR is answered at once with the
+ "ignore" envelope and its result is handed to window.NativeBridge._complete when the batch returns.
+ */
+static NSString *const kChatSDKBatchBridgeScript =
+@"(function(){"
+@"if(window.ChatSDKBatch)return;"
+@"var proto=XMLHttpRequest.prototype,open=proto.open,send=proto.send,setHeader=proto.setRequestHeader,queue=[],base='';"
+@"var answer=function(xhr,text){"
+@"Object.defineProperty(xhr,'readyState',{value:4});Object.defineProperty(xhr,'status',{value:200});"
+@"Object.defineProperty(xhr,'responseText',{value:text});Object.defineProperty(xhr,'response',{value:text});"
+@"setTimeout(function(){xhr.dispatchEvent(new Event('readystatechange'));xhr.dispatchEvent(new Event('load'));},0);};"
+@"var flush=function(){"
+@"if(!queue.length)return;var calls=queue;queue=[];var req=new XMLHttpRequest();"
+@"open.call(req,'GET',base+'/!chat_exec_batch/?'+encodeURIComponent(JSON.stringify(calls)),true);"
+@"req.onload=function(){var results=[];try{results=JSON.parse(req.responseText);}catch(e){}"
+@"for(var i=0;i<results.length;i++){var r=results[i];if(r&&!(r.data&&r.data.ignore))window.NativeBridge._complete(JSON.stringify(r));}};"
+@"send.call(req);};"
+@"proto.open=function(method,url,async){"
+@"var u=String(url),i=u.indexOf('/!chat_exec/');"
+@"this._chatBatch=(i!=-1&&async!==false&&String(method).toUpperCase()=='GET')?u:null;"
+@"if(!this._chatBatch)return open.apply(this,arguments);base=u.substring(0,i);};"
+@"proto.setRequestHeader=function(){if(!this._chatBatch)return setHeader.apply(this,arguments);};"
+@"proto.send=function(){"
+@"if(!this._chatBatch)return send.apply(this,arguments);"
+@"var u=this._chatBatch,q=u.indexOf('?'),path=q<0?u:u.substring(0,q),params={};"
+@"try{if(q>=0)params=JSON.parse(decodeURIComponent(u.substring(q+1)));}catch(e){}"
+@"queue.push({action:path.substring(path.lastIndexOf('/')+1),id:params&&params.id,params:params});"
+@"answer(this,'{\"result\":true,\"action\":true,\"data\":{\"ignore\":true}}');"
+@"if(queue.length==1)setTimeout(flush,0);};"
+@"window.ChatSDKBatch={flush:flush};"
+@"})();";
+
+// Loaded by prepareForReuse, keeps the engine of a pooled view running without a page
+static NSString *const kChatSDKBlankPage = @"<html><body></body></html>";
+// Base URL of kChatSDKBlankPage, tells its callbacks from those of the chat app & the error page
+static NSString *const kChatSDKBlankPageURL = @"chatsdk-blank://pool/";
+
+/*
+ Sends the view's identity token with every /!chat_exec/ & /!chat_exec_batch/ XHR of the UIWebView engine, so
+ that ChatSDKURLProtocol routes them by web view even after a redirect or pushState changed the page URL.
+ Injected before kChatSDKBatchBridgeScript, whose batch requests go through it too.
+ */
+static NSString *const kChatSDKIdentityScriptFormat =
+@"(function(){"
+@"if(window.ChatSDKWebViewToken)return;window.ChatSDKWebViewToken='%@';"
+@"var proto=XMLHttpRequest.prototype,open=proto.open,send=proto.send;"
+@"proto.open=function(method,url){this._chatIdentity=String(url).indexOf('/!chat_exec')!=-1;return open.apply(this,arguments);};"
+@"proto.send=function(){if(this._chatIdentity)this.setRequestHeader('%@',window.ChatSDKWebViewToken);return send.apply(this,arguments);};"
+@"})();";
+
+#if __IPHONE_OS_VERSION_MAX_ALLOWED >= 80000
+// WebKit is weak linked, WKWebView is only used when the class exists at runtime
+#define CHATSDK_WKWEBVIEW 1
+#import <WebKit/WebKit.h>
+
+// Name of the script message handler, window.webkit.messageHandlers.chatsdk
+static NSString *const kChatSDKMessageHandler = @"chatsdk";
+
+/*
+ Injected at document start of the WKWebView engine. XHRs to /!chat_exec/ can not be intercepted
+ by ChatSDKJSBridge there, so they are posted as {action, query} script messages and answered at once
+ with the "ignore" envelope. The real result is delivered through window.NativeBridge._complete,
+ the way showdialog always did. A /!chat_exec_batch/ XHR is posted as {batch} and answered with [].
+ */
+static NSString *const kChatSDKWKBridgeScript =
+@"(function(){"
+@"var handler=window.webkit&&window.webkit.messageHandlers.chatsdk;if(!handler)return;"
+@"var proto=XMLHttpRequest.prototype,open=proto.open,send=proto.send,setHeader=proto.setRequestHeader;"
+@"proto.open=function(method,url,async){"
+@"var u=String(url);this._chatExecBatch=u.indexOf('/!chat_exec_batch/')!=-1;"
+@"this._chatExec=(this._chatExecBatch||u.indexOf('/!chat_exec/')!=-1)?u:null;this._chatExecAsync=async!==false;"
+@"if(!this._chatExec)return open.apply(this,arguments);};"
+@"proto.setRequestHeader=function(){if(!this._chatExec)return setHeader.apply(this,arguments);};"
+@"proto.send=function(){"
+@"if(!this._chatExec)return send.apply(this,arguments);"
+@"var url=this._chatExec,q=url.indexOf('?'),path=q<0?url:url.substring(0,q),query=q<0?'':url.substring(q+1);"
+@"var xhr=this,text='{\"result\":true,\"action\":true,\"data\":{\"ignore\":true}}';"
+@"if(xhr._chatExecBatch){handler.postMessage({batch:query});text='[]';}"
+@"else handler.postMessage({action:path.substring(path.lastIndexOf('/')+1),query:query});"
+@"Object.defineProperty(xhr,'readyState',{value:4});Object.defineProperty(xhr,'status',{value:200});"
+@"Object.defineProperty(xhr,'responseText',{value:text});Object.defineProperty(xhr,'response',{value:text});"
+@"var done=function(){xhr.dispatchEvent(new Event('readystatechange'));xhr.dispatchEvent(new Event('load'));};"
+@"if(xhr._chatExecAsync)setTimeout(done,0);else done();};"
+@"})();";
+
+// WKUserContentController retains its handlers, this keeps it from retaining the web view
+@interface ChatSDKScriptMessageProxy : NSObject <WKScriptMessageHandler>
+@property (nonatomic, weak) id<WKScriptMessageHandler> target;
+@end
+
+@implementation ChatSDKScriptMessageProxy
+-(void)userContentController:(WKUserContentController *)userContentController didReceiveScriptMessage:(WKScriptMessage *)message
+{
+    [_target userContentController:userContentController didReceiveScriptMessage:message];
+}
+@end
+
+@interface ChatSDKWebView ()<UIWebViewDelegate,WKNavigationDelegate,WKScriptMessageHandler>
+{
+    WKWebView *wkWebView;
+#else
+@interface ChatSDKWebView ()<UIWebViewDelegate>
+{
+#endif
+    BOOL batchScriptAdded;
+    UIWebView *uiWebView;
+#ifdef CHATSDK_WKWEBVIEW
+    // Navigation of the blank page of prepareForReuse
+    WKNavigation *blankNavigation;
+#endif
+    //Layouts of the current screen size & configuration
+    ChatSDKLayoutEngine *layoutEngine;
+    BOOL keyboardIsUp;
+    CGFloat keyboardHeight;
+    //Transform of the laid out view while hideWithAnimation moves it away
+    BOOL hiding;
+    CGAffineTransform restingTransform;
+}
+@end
+
 @implementation ChatSDKWebView
 
-bool keyboardIsUp=false;
-bool orientationPortrait=true;
-bool initialized=false;
-CGRect keyboardFrame;
-CGRect webViewInitialFramePortrait;
-CGRect webViewInitialFrameLandscape;
-float deviceHeight;
-float deviceWidth;
-float webViewWidthForIpadPortrait;
-float webViewHeightForIpadPortrait;
-float webViewWidthForIpadLandscape;
-float webViewHeightForIpadLandscape;
-
-float paddingTopPortrait;
-float paddingRightPortrait;
-float paddingBottomPortrait;
-float paddingLeftPortrait;
-
-float paddingTopLandscape;
-float paddingRightLandscape;
-float paddingBottomLandscape;
-float paddingLeftLandscape;
-
-ChatSDKResources* resources=nil;
+@synthesize engine = _engine;
+@synthesize delegate = _delegate;
+@synthesize bridgeDelegate = _bridgeDelegate;
+@synthesize batchesBridgeCalls = _batchesBridgeCalls;
+@synthesize identityToken = _identityToken;
 
 - (id)initWithFrame:(CGRect)frame
+{
+    return [self initWithFrame:frame engine:ChatSDKWebEngineUIWebView];
+}
+
+-(id)initWithEngine:(ChatSDKWebEngine)engine
+{
+    return [self initWithFrame:CGRectZero engine:engine];
+}
+
+- (id)initWithFrame:(CGRect)frame engine:(ChatSDKWebEngine)engine
 {
     self = [super initWithFrame:frame];
     if (self) {
-        // Initialization code
+        _identityToken = [[NSUUID UUID] UUIDString];
+        [self createContentViewWithEngine:engine];
     }
-    keyboardFrame= CGRectMake(0, 0, 0, 0);
-    webViewInitialFramePortrait= CGRectMake(0, 0, 0, 0);
-    webViewInitialFrameLandscape= CGRectMake(0, 0, 0, 0);
-    
     //Registering notifications for keyboard & orientation-change
     NSNotificationCenter* notifCenter = [NSNotificationCenter defaultCenter];
     [notifCenter addObserver:self
@@ -70,97 +187,311 @@ ChatSDKResources* resources=nil;
     
     [[NSNotificationCenter defaultCenter] addObserver:self  selector:@selector(orientationChanged)  name:UIDeviceOrientationDidChangeNotification  object:nil];
     
-    resources= [ChatSDKResources getSDKResourcesInstance];
-    [resources initializeValues];
-    
     [self checkBoundForSuperView];
     
     return self;
 }
 
--(void)checkBoundForSuperView
+-(void)createContentViewWithEngine:(ChatSDKWebEngine)engine
 {
-    //Determine height of device
-    CGSize result = [[UIScreen mainScreen] bounds].size;
-    
-    deviceHeight= result.height;
-    deviceWidth= result.width;
-    
-    /*
-     //if client need in % basis
-     paddingTopPortrait=floorf(([resources.paddingTopPortrait floatValue] / 100) * deviceHeight);
-     paddingRightPortrait=floorf(([resources.paddingRightPortrait floatValue] / 100) * deviceWidth);
-     paddingBottomPortrait=floorf(([resources.paddingBottonPortrait floatValue] / 100) * deviceHeight);
-     paddingLeftPortrait=floorf(([resources.paddingLeftPortrait floatValue] / 100) * deviceWidth);
-     
-     
-     paddingTopLandscape=floorf(([resources.paddingTopLandscape floatValue] / 100) * deviceWidth);
-     paddingRightLandscape=floorf(([resources.paddingRightLandscape floatValue] / 100) * deviceHeight);
-     paddingBottomLandscape=floorf(([resources.paddingBottonLandscape floatValue] / 100) * deviceWidth);
-     paddingLeftLandscape=floorf(([resources.paddingLeftLandscape floatValue] / 100) * deviceHeight);
-     */
-    
-    
-    
-    paddingTopPortrait=[resources.paddingTopPortrait floatValue];
-    paddingRightPortrait=[resources.paddingRightPortrait floatValue];
-    paddingBottomPortrait=[resources.paddingBottonPortrait floatValue];
-    paddingLeftPortrait=[resources.paddingLeftPortrait floatValue];
-    
-    paddingTopLandscape=[resources.paddingTopLandscape floatValue];
-    paddingRightLandscape=[resources.paddingRightLandscape floatValue];
-    paddingBottomLandscape=[resources.paddingBottonLandscape floatValue];
-    paddingLeftLandscape=[resources.paddingLeftLandscape floatValue];
-    
-    webViewWidthForIpadPortrait= floorf(([resources.widthPortrait floatValue] / 100) * deviceWidth);
-    webViewHeightForIpadPortrait= floorf(([resources.heightPortrait floatValue] /100) * deviceHeight);
-    
-    //reading height in width and width in height
-    
-    webViewWidthForIpadLandscape= floorf(([resources.widthLandscape floatValue] / 100) * deviceWidth);
-    webViewHeightForIpadLandscape= floorf(([resources.heightLandscape floatValue] /100) * deviceHeight);
+    UIView *contentView = nil;
+#ifdef CHATSDK_WKWEBVIEW
+    if(engine==ChatSDKWebEngineWKWebView && NSClassFromString(@"WKWebView")!=nil)
+    {
+        WKUserContentController *userContentController = [[WKUserContentController alloc] init];
+        WKUserScript *bridgeScript = [[WKUserScript alloc] initWithSource:kChatSDKWKBridgeScript injectionTime:WKUserScriptInjectionTimeAtDocumentStart forMainFrameOnly:NO];
+        [userContentController addUserScript:bridgeScript];
+        ChatSDKScriptMessageProxy *proxy = [[ChatSDKScriptMessageProxy alloc] init];
+        proxy.target = self;
+        [userContentController addScriptMessageHandler:proxy name:kChatSDKMessageHandler];
+        
+        WKWebViewConfiguration *configuration = [[WKWebViewConfiguration alloc] init];
+        configuration.userContentController = userContentController;
+        
+        wkWebView = [[WKWebView alloc] initWithFrame:self.bounds configuration:configuration];
+        wkWebView.navigationDelegate = self;
+        contentView = wkWebView;
+        _engine = ChatSDKWebEngineWKWebView;
+    }
+#endif
+    if(contentView==nil)
+    {
+        uiWebView = [[UIWebView alloc] initWithFrame:self.bounds];
+        uiWebView.delegate = self;
+        contentView = uiWebView;
+        _engine = ChatSDKWebEngineUIWebView;
+    }
+    contentView.autoresizingMask = (UIViewAutoresizingFlexibleHeight | UIViewAutoresizingFlexibleWidth);
+    [self addSubview:contentView];
+}
+
+-(void)setBatchesBridgeCalls:(BOOL)batchesBridgeCalls
+{
+    _batchesBridgeCalls = batchesBridgeCalls;
+#ifdef CHATSDK_WKWEBVIEW
+    // User scripts can not be removed one by one, the script is added once for the next loads
+    if(batchesBridgeCalls && wkWebView && !batchScriptAdded)
+    {
+        WKUserScript *batchScript = [[WKUserScript alloc] initWithSource:kChatSDKBatchBridgeScript injectionTime:WKUserScriptInjectionTimeAtDocumentStart forMainFrameOnly:NO];
+        [wkWebView.configuration.userContentController addUserScript:batchScript];
+        batchScriptAdded = YES;
+    }
+#endif
+}
+
+-(UIScrollView *)scrollView
+{
+#ifdef CHATSDK_WKWEBVIEW
+    if(wkWebView)
+    {
+        return wkWebView.scrollView;
+    }
+#endif
+    return uiWebView.scrollView;
+}
+
+-(NSURL *)currentURL
+{
+#ifdef CHATSDK_WKWEBVIEW
+    if(wkWebView)
+    {
+        return wkWebView.URL;
+    }
+#endif
+    return uiWebView.request.URL;
+}
+
++(BOOL)isBlankPageURL:(NSURL *)url
+{
+    return url!=nil && [[url absoluteString] hasPrefix:kChatSDKBlankPageURL];
+}
+
+-(void)loadRequest:(NSURLRequest *)request
+{
+#ifdef CHATSDK_WKWEBVIEW
+    [wkWebView loadRequest:request];
+#endif
+    [uiWebView loadRequest:request];
+}
+
+-(void)loadHTMLString:(NSString *)string baseURL:(NSURL *)baseURL
+{
+#ifdef CHATSDK_WKWEBVIEW
+    [wkWebView loadHTMLString:string baseURL:baseURL];
+#endif
+    [uiWebView loadHTMLString:string baseURL:baseURL];
+}
+
+-(void)stopLoading
+{
+#ifdef CHATSDK_WKWEBVIEW
+    [wkWebView stopLoading];
+#endif
+    [uiWebView stopLoading];
+}
+
+-(void)prepareForReuse
+{
+    _delegate = nil;
+    _bridgeDelegate = nil;
+    [self stopLoading];
+    //Ends a running show or hide, hiding is cleared so that its completion leaves the view alone
+    [self.layer removeAllAnimations];
+    hiding = NO;
+    [self setRasterized:NO];
+    self.hidden = NO;
+    [self removeFromSuperview];
+#ifdef CHATSDK_WKWEBVIEW
+    if(wkWebView)
+    {
+        blankNavigation = [wkWebView loadHTMLString:kChatSDKBlankPage baseURL:[NSURL URLWithString:kChatSDKBlankPageURL]];
+        return;
+    }
+#endif
+    [uiWebView loadHTMLString:kChatSDKBlankPage baseURL:[NSURL URLWithString:kChatSDKBlankPageURL]];
+}
+
+-(void)evaluateJavaScript:(NSString *)script
+{
+#ifdef CHATSDK_WKWEBVIEW
+    [wkWebView evaluateJavaScript:script completionHandler:nil];
+#endif
+    [uiWebView stringByEvaluatingJavaScriptFromString:script];
+}
+
+#pragma mark UIWebView Delegate
+-(BOOL)webView:(UIWebView *)webView shouldStartLoadWithRequest:(NSURLRequest *)request navigationType:(UIWebViewNavigationType)navigationType
+{
+    // The blank page is the view's own business
+    if([ChatSDKWebView isBlankPageURL:[request URL]])
+    {
+        return YES;
+    }
+    return [_delegate chatWebView:self shouldStartLoadWithRequest:request];
+}
+
+-(void)webViewDidFinishLoad:(UIWebView *)webView
+{
+    // The blank page may finish after the next chat started loading
+    if([ChatSDKWebView isBlankPageURL:webView.request.URL])
+    {
+        return;
+    }
+    [uiWebView stringByEvaluatingJavaScriptFromString:[NSString stringWithFormat:kChatSDKIdentityScriptFormat,_identityToken,ChatSDKWebViewTokenHeader]];
+    // Calls made before the load finished went out one by one
+    if(_batchesBridgeCalls)
+    {
+        [uiWebView stringByEvaluatingJavaScriptFromString:kChatSDKBatchBridgeScript];
+    }
+    [_delegate chatWebViewDidFinishLoad:self];
+}
+
+-(void)webView:(UIWebView *)webView didFailLoadWithError:(NSError *)error
+{
+    if([ChatSDKWebView isBlankPageURL:[[error userInfo] objectForKey:NSURLErrorFailingURLErrorKey]])
+    {
+        return;
+    }
+    [_delegate chatWebView:self didFailLoadWithError:error];
+}
+
+#ifdef CHATSDK_WKWEBVIEW
+#pragma mark WKWebView Delegate
+-(void)webView:(WKWebView *)webView decidePolicyForNavigationAction:(WKNavigationAction *)navigationAction decisionHandler:(void (^)(WKNavigationActionPolicy))decisionHandler
+{
+    if([ChatSDKWebView isBlankPageURL:navigationAction.request.URL])
+    {
+        decisionHandler(WKNavigationActionPolicyAllow);
+        return;
+    }
+    BOOL allow = [_delegate chatWebView:self shouldStartLoadWithRequest:navigationAction.request];
+    decisionHandler(allow ? WKNavigationActionPolicyAllow : WKNavigationActionPolicyCancel);
+}
+
+-(void)webView:(WKWebView *)webView didFinishNavigation:(WKNavigation *)navigation
+{
+    if(navigation!=nil && navigation==blankNavigation)
+    {
+        blankNavigation = nil;
+        return;
+    }
+    [_delegate chatWebViewDidFinishLoad:self];
+}
+
+-(void)webView:(WKWebView *)webView didFailNavigation:(WKNavigation *)navigation withError:(NSError *)error
+{
+    if(navigation!=nil && navigation==blankNavigation)
+    {
+        blankNavigation = nil;
+        return;
+    }
+    [_delegate chatWebView:self didFailLoadWithError:error];
+}
+
+-(void)webView:(WKWebView *)webView didFailProvisionalNavigation:(WKNavigation *)navigation withError:(NSError *)error
+{
+    if(navigation!=nil && navigation==blankNavigation)
+    {
+        blankNavigation = nil;
+        return;
+    }
+    [_delegate chatWebView:self didFailLoadWithError:error];
+}
+
+// chat_exec call posted by kChatSDKWKBridgeScript
+-(void)userContentController:(WKUserContentController *)userContentController didReceiveScriptMessage:(WKScriptMessage *)message
+{
+    NSDictionary *body = message.body;
+    if(![body isKindOfClass:[NSDictionary class]])
+    {
+        return;
+    }
     
-    NSLog(@"called");
+    NSTimeInterval startTime = [NSDate timeIntervalSinceReferenceDate];
+    NSString *batch = [body objectForKey:@"batch"];
+    if(batch)
+    {
+        NSUInteger responseBytes = 0;
+        for(id result in [ChatSDKJSBridge resultsOfBatch:batch withDelegate:_bridgeDelegate])
+        {
+            if([result isKindOfClass:[NSDictionary class]] && ![ChatSDKBridgeActionRegistry isIgnoreEnvelope:result])
+            {
+                responseBytes += [self completeNativeCall:result];
+            }
+        }
+        [[ChatSDKBridgeMetrics sharedMetrics] recordAction:@"!batch" bridgeTime:[NSDate timeIntervalSinceReferenceDate] - startTime requestBytes:[batch length] responseBytes:responseBytes];
+        return;
+    }
     
-    //    //If keyboard overlaps then resize the webview height
-    //    //Assuming iPad's keyboard height is 308 in Portrait mode & 396 in Landscape mode
-    //    float keyboardHeightPortrait=308.0f;
-    //    float keyboardHeightLandscape=396.0f;
-    //
-    //    if((webViewHeightForIpadPortrait+paddingTopPortrait) > (deviceHeight-keyboardHeightPortrait))
-    //    {
-    //        float diff= (webViewHeightForIpadPortrait+paddingTopPortrait) - (deviceHeight-keyboardHeightPortrait);
-    //        webViewHeightForIpadPortrait-=diff;
-    //    }
-    //    if((webViewHeightForIpadLandscape+paddingTopLandscape) > (deviceWidth-keyboardHeightLandscape))
-    //    {
-    //        float diff= (webViewHeightForIpadLandscape+paddingTopLandscape) - (deviceWidth-keyboardHeightLandscape);
-    //        webViewHeightForIpadLandscape-=diff;
-    //    }
+    NSString *query = [body objectForKey:@"query"];
+    ChatSDKBridgeAction *bridgeAction = [ChatSDKJSBridge bridgeActionWithName:[body objectForKey:@"action"] query:query];
+    NSDictionary *nativeResult = [ChatSDKJSBridge resultOfAction:bridgeAction withDelegate:_bridgeDelegate];
     
-    NSLog(@"#### Device Height: %f    , Device Width: %f",deviceHeight, deviceWidth);
-    NSLog(@"#### WebView Height Portrait: %f    , WebView Width Portrait: %f",webViewHeightForIpadPortrait, webViewWidthForIpadPortrait);
-    NSLog(@"#### WebView Height Landscape: %f    , WebView Width Landscape: %f",webViewHeightForIpadLandscape, webViewWidthForIpadLandscape);
+    // Actions answering "ignore" (showdialog) complete by themselves & are recorded then
+    if(nativeResult==nil || [ChatSDKBridgeActionRegistry isIgnoreEnvelope:nativeResult])
+    {
+        return;
+    }
+    NSUInteger responseBytes = [self completeNativeCall:nativeResult];
+    [[ChatSDKBridgeMetrics sharedMetrics] recordAction:bridgeAction.action bridgeTime:[NSDate timeIntervalSinceReferenceDate] - startTime requestBytes:[query length] responseBytes:responseBytes];
+}
+#endif
+
+-(NSUInteger)completeNativeCall:(NSDictionary *)envelope
+{
+    NSString *script = [ChatSDKWebView scriptCompletingNativeCall:envelope];
+    if(script)
+    {
+        [self evaluateJavaScript:script];
+    }
+    return [script length];
+}
+
++(NSString *)scriptCompletingNativeCall:(NSDictionary *)envelope
+{
+    NSData *jsonData = envelope ? [NSJSONSerialization dataWithJSONObject:envelope options:0 error:NULL] : nil;
+    if(jsonData==nil)
+    {
+        return nil;
+    }
+    NSString *json = [[NSString alloc] initWithData:jsonData encoding:NSUTF8StringEncoding];
+    return [NSString stringWithFormat:@"window.NativeBridge._complete(JSON.stringify(%@))",json];
+}
+
+-(void)checkBoundForSuperView
+{
+    //Same engine, and so the same precomputed layouts, unless the screen size or configuration changed
+    layoutEngine= [ChatSDKLayoutEngine currentEngine];
     
     //Keyboard Up Event Fix on iOS7, compiled with iOS7
     if([[[UIDevice currentDevice] systemVersion] floatValue] >=7.0f && COMPILED_WITH_VERSION>=7)
     {
-        self.keyboardDisplayRequiresUserAction = NO;
+        uiWebView.keyboardDisplayRequiresUserAction = NO;
     }
 
 }
 
+-(void)applyLayout:(ChatSDKWebViewLayoutStyle)style
+{
+    ChatSDKViewLayout layout;
+    if([layoutEngine getWebViewLayout:&layout style:style orientation:[[UIApplication sharedApplication] statusBarOrientation] keyboardHeight:(keyboardIsUp ? keyboardHeight : 0)])
+    {
+        ChatSDKApplyViewLayout(self, layout);
+    }
+}
+
 
 - (void)keyboardWillShowOrHide:(NSNotification*)notif
 {
     
-    keyboardFrame = [notif.userInfo[UIKeyboardFrameEndUserInfoKey] CGRectValue];
+    CGRect keyboardFrame = [notif.userInfo[UIKeyboardFrameEndUserInfoKey] CGRectValue];
     keyboardFrame = [self convertRect:keyboardFrame fromView:nil];
+    keyboardHeight = keyboardFrame.size.height;
     
     if ([notif.name isEqualToString:UIKeyboardDidShowNotification]) {
-        keyboardIsUp=true;
+        keyboardIsUp=YES;
     }else{
-        keyboardIsUp=false;
+        keyboardIsUp=NO;
     }
     
     if(![self isHidden])
@@ -187,10 +518,8 @@ ChatSDKResources* resources=nil;
 {
     [self checkBoundForSuperView];
     
-    NSLog(@"called orientation for webview");
     if(![self isHidden])
     {
-        NSLog(@"2- called orientation for webview");
 
         if(UI_USER_INTERFACE_IDIOM() == UIUserInterfaceIdiomPhone){
             //Code for iPhone
@@ -218,302 +547,95 @@ ChatSDKResources* resources=nil;
 
 -(void)resetWebView
 {
-    NSLog(@"#### RESET WEBVIEW");
-    CGRect webViewBounds;
-    webViewBounds.origin= CGPointMake(0, 0);
     self.scrollView.contentInset = UIEdgeInsetsMake(0, 0, 0, 0);
-    webViewBounds.size.height= deviceHeight;
-    webViewBounds.size.width= 320.0f;
     self.scrollView.scrollEnabled=YES;
-    
-    UIInterfaceOrientation currentOrientation = [[UIApplication sharedApplication] statusBarOrientation];
-    if (currentOrientation == UIInterfaceOrientationPortrait || currentOrientation==
-        UIInterfaceOrientationPortraitUpsideDown){
-        webViewBounds.origin= CGPointMake(0, 20);
-        webViewBounds.size.height= deviceHeight -20;
-        if(keyboardIsUp){
-            webViewBounds.size.height -= keyboardFrame.size.height;
-        }else{
-        }
-        self.transform = CGAffineTransformIdentity;
-        
-    }else if(currentOrientation == UIInterfaceOrientationLandscapeLeft){
-        webViewBounds.origin= CGPointMake(20, 0);
-        webViewBounds.size.width= 300.0f;
-        if(keyboardIsUp){
-            webViewBounds.size.width-=keyboardFrame.size.height;
-        }else{
-        }
-        self.transform = CGAffineTransformMakeRotation(3*M_PI/2);
-        
-    }else if(currentOrientation == UIInterfaceOrientationLandscapeRight){
-        webViewBounds.origin= CGPointMake(0, 0);
-        webViewBounds.size.width= 300.0f;
-        if(keyboardIsUp){
-            webViewBounds.size.width -=keyboardFrame.size.height;
-            webViewBounds.origin= CGPointMake(keyboardFrame.size.height, 0);
-        }else{
-            
-        }
-        self.transform = CGAffineTransformMakeRotation(M_PI/2);
-        
-    }
-    self.frame = webViewBounds;
+    [self applyLayout:ChatSDKWebViewLayoutPhone];
 }
 
 
 -(void)resetWebViewWithFrame
 {
-    UIInterfaceOrientation currentOrientation = [[UIApplication sharedApplication] statusBarOrientation];
-    if (currentOrientation == UIInterfaceOrientationPortrait || currentOrientation==
-        UIInterfaceOrientationPortraitUpsideDown){
-        self.frame = CGRectMake(0,20,320,deviceHeight-20);
-        [self setBounds:CGRectMake(0, 0 ,320,deviceHeight-20)];
-        self.transform = CGAffineTransformIdentity;
-    }else if(currentOrientation == UIInterfaceOrientationLandscapeLeft){
-        self.frame = CGRectMake(20, 0,300,deviceHeight);
-        [self setBounds:CGRectMake(0, 0 ,deviceHeight,300)];
-        self.transform = CGAffineTransformMakeRotation(3*M_PI/2);
-    }else if(currentOrientation == UIInterfaceOrientationLandscapeRight){
-        self.frame = CGRectMake(0,0,300,deviceHeight);
-        [self setBounds:CGRectMake(0, 0 ,deviceHeight,300)];
-        self.transform = CGAffineTransformMakeRotation(M_PI/2);
-    }
+    [self applyLayout:ChatSDKWebViewLayoutPhoneFullHeight];
 }
 
 -(void)showWithAnimation
 {
-    CGRect currentFrame= self.frame;
-    CGRect frameAfterAnimation= self.frame;
+    //Slides in with the layer transform over a rasterized copy, the web view keeps its frame & does not relayout
+    CGAffineTransform finalTransform= hiding ? restingTransform : self.transform;
+    CGPoint offset= [layoutEngine webViewAnimationOffsetForOrientation:[[UIApplication sharedApplication] statusBarOrientation]];
     
-    UIInterfaceOrientation currentOrientation = [[UIApplication sharedApplication] statusBarOrientation];
-    
-    if(currentOrientation == UIInterfaceOrientationPortrait)
-    {
-        //Manipulating current frame
-        if([resources.animationStyle isEqualToString:@"top-bottom"])
-        {
-            currentFrame.origin.y-=deviceHeight;
-        }else if([resources.animationStyle isEqualToString:@"bottom-top"])
-        {
-            currentFrame.origin.y+=deviceHeight;
-        }else if([resources.animationStyle isEqualToString:@"left-right"])
-        {
-            currentFrame.origin.x-=deviceHeight;
-        }else if([resources.animationStyle isEqualToString:@"right-left"])
-        {
-            currentFrame.origin.x+=deviceHeight;
-        }
-    }else if(currentOrientation == UIInterfaceOrientationPortraitUpsideDown)
-    {
-        //Manipulating current frame
-        if([resources.animationStyle isEqualToString:@"top-bottom"])
-        {
-            currentFrame.origin.y+=deviceHeight;
-        }else if([resources.animationStyle isEqualToString:@"bottom-top"])
-        {
-            currentFrame.origin.y-=deviceHeight;
-        }else if([resources.animationStyle isEqualToString:@"left-right"])
-        {
-            currentFrame.origin.x+=deviceHeight;
-        }else if([resources.animationStyle isEqualToString:@"right-left"])
-        {
-            currentFrame.origin.x-=deviceHeight;
-        }
-    }else if(currentOrientation == UIInterfaceOrientationLandscapeLeft)
-    {
-        //Manipulating current frame
-        if([resources.animationStyle isEqualToString:@"top-bottom"])
-        {
-            currentFrame.origin.x-=deviceWidth;
-        }else if([resources.animationStyle isEqualToString:@"bottom-top"])
-        {
-            currentFrame.origin.x+=deviceWidth;
-        }else if([resources.animationStyle isEqualToString:@"left-right"])
-        {
-            currentFrame.origin.y+=deviceWidth;
-        }else if([resources.animationStyle isEqualToString:@"right-left"])
-        {
-            currentFrame.origin.y-=deviceWidth;
-        }
-        
-    }else if(currentOrientation == UIInterfaceOrientationLandscapeRight)
-    {
-        //Manipulating current frame
-        if([resources.animationStyle isEqualToString:@"top-bottom"])
-        {
-            currentFrame.origin.x+=deviceWidth;
-        }else if([resources.animationStyle isEqualToString:@"bottom-top"])
-        {
-            currentFrame.origin.x-=deviceWidth;
-        }else if([resources.animationStyle isEqualToString:@"left-right"])
-        {
-            currentFrame.origin.y-=deviceWidth;
-        }else if([resources.animationStyle isEqualToString:@"right-left"])
-        {
-            currentFrame.origin.y+=deviceWidth;
-        }
-    }
-    
-    self.frame=currentFrame;
+    hiding=NO;
+    self.transform= CGAffineTransformConcat(finalTransform, CGAffineTransformMakeTranslation(offset.x, offset.y));
     self.hidden=NO;
-    [UIView animateWithDuration:0.5 animations:^{
-        //Assigning new frame
-        self.frame= frameAfterAnimation;
-    }];
+    [self setRasterized:YES];
+    [[ChatSDKAnimationMetrics sharedMetrics] beginAnimation:@"chat.show"];
+    [UIView animateWithDuration:0.5
+                     animations:^{
+                         self.transform= finalTransform;
+                     }
+                     completion:^(BOOL finished){
+                         [self setRasterized:NO];
+                         [[ChatSDKAnimationMetrics sharedMetrics] endAnimation:@"chat.show"];
+                     }];
 }
 
 
 -(void)hideWithAnimation
 {
-    CGRect frameAfterAnimation= self.frame;
-    
-    UIInterfaceOrientation currentOrientation = [[UIApplication sharedApplication] statusBarOrientation];
-    
-    if(currentOrientation == UIInterfaceOrientationPortrait)
-    {
-        //Manipulating current frame
-        if([resources.animationStyle isEqualToString:@"top-bottom"])
-        {
-            frameAfterAnimation.origin.y-=deviceHeight;
-        }else if([resources.animationStyle isEqualToString:@"bottom-top"])
-        {
-            frameAfterAnimation.origin.y+=deviceHeight;
-        }else if([resources.animationStyle isEqualToString:@"left-right"])
-        {
-            frameAfterAnimation.origin.x-=deviceHeight;
-        }else if([resources.animationStyle isEqualToString:@"right-left"])
-        {
-            frameAfterAnimation.origin.x+=deviceHeight;
-        }
-    }else if(currentOrientation == UIInterfaceOrientationPortraitUpsideDown)
-    {
-        //Manipulating current frame
-        if([resources.animationStyle isEqualToString:@"top-bottom"])
-        {
-            frameAfterAnimation.origin.y+=deviceHeight;
-        }else if([resources.animationStyle isEqualToString:@"bottom-top"])
-        {
-            frameAfterAnimation.origin.y-=deviceHeight;
-        }else if([resources.animationStyle isEqualToString:@"left-right"])
-        {
-            frameAfterAnimation.origin.x+=deviceHeight;
-        }else if([resources.animationStyle isEqualToString:@"right-left"])
-        {
-            frameAfterAnimation.origin.x-=deviceHeight;
-        }
-    }else if(currentOrientation == UIInterfaceOrientationLandscapeLeft)
+    if(hiding)
     {
-        //Manipulating current frame
-        if([resources.animationStyle isEqualToString:@"top-bottom"])
-        {
-            frameAfterAnimation.origin.x-=deviceWidth;
-        }else if([resources.animationStyle isEqualToString:@"bottom-top"])
-        {
-            frameAfterAnimation.origin.x+=deviceWidth;
-        }else if([resources.animationStyle isEqualToString:@"left-right"])
-        {
-            frameAfterAnimation.origin.y+=deviceWidth;
-        }else if([resources.animationStyle isEqualToString:@"right-left"])
-        {
-            frameAfterAnimation.origin.y-=deviceWidth;
-        }
-        
-    }else if(currentOrientation == UIInterfaceOrientationLandscapeRight)
-    {
-        //Manipulating current frame
-        if([resources.animationStyle isEqualToString:@"top-bottom"])
-        {
-            frameAfterAnimation.origin.x+=deviceWidth;
-        }else if([resources.animationStyle isEqualToString:@"bottom-top"])
-        {
-            frameAfterAnimation.origin.x-=deviceWidth;
-        }else if([resources.animationStyle isEqualToString:@"left-right"])
-        {
-            frameAfterAnimation.origin.y-=deviceWidth;
-        }else if([resources.animationStyle isEqualToString:@"right-left"])
-        {
-            frameAfterAnimation.origin.y+=deviceWidth;
-        }
+        return;
     }
+    CGAffineTransform finalTransform= self.transform;
+    CGPoint offset= [layoutEngine webViewAnimationOffsetForOrientation:[[UIApplication sharedApplication] statusBarOrientation]];
     
+    hiding=YES;
+    restingTransform= finalTransform;
+    [self setRasterized:YES];
+    [[ChatSDKAnimationMetrics sharedMetrics] beginAnimation:@"chat.hide"];
     [UIView animateWithDuration:0.5
                           delay: 0.0
                         options: UIViewAnimationOptionCurveLinear
                      animations:^{
-                         //Assigning new frame
-                         self.frame= frameAfterAnimation;
+                         self.transform= CGAffineTransformConcat(finalTransform, CGAffineTransformMakeTranslation(offset.x, offset.y));
                      }
                      completion:^(BOOL finished){
-                         self.hidden=YES;
+                         [self setRasterized:NO];
+                         [[ChatSDKAnimationMetrics sharedMetrics] endAnimation:@"chat.hide"];
+                         //Not when showWithAnimation took over
+                         if(hiding)
+                         {
+                             hiding=NO;
+                             self.hidden=YES;
+                             self.transform= finalTransform;
+                         }
                      }];
 }
 
-
--(void)resetWebViewForIpad
+-(void)setRasterized:(BOOL)rasterized
 {
-    CGPoint margin= [self getMargins];
-    
-    NSLog(@"resetWebViewForIpad  %f  %f  %f  %f",margin.x,margin.y,webViewWidthForIpadLandscape,webViewHeightForIpadLandscape);
-
-    float boundWidth= floorf(([resources.widthLandscape floatValue] / 100) * deviceHeight);
-    float boundHeight= floorf(([resources.heightLandscape floatValue] /100) * deviceWidth);
-
-    UIInterfaceOrientation currentOrientation = [[UIApplication sharedApplication] statusBarOrientation];
-    if (currentOrientation == UIInterfaceOrientationPortrait || currentOrientation==
-        UIInterfaceOrientationPortraitUpsideDown){
-        
-        self.frame = CGRectMake(margin.x,margin.y,webViewWidthForIpadPortrait,webViewHeightForIpadPortrait-margin.y);
-        [self setBounds:CGRectMake(0, 0 ,webViewWidthForIpadPortrait,webViewHeightForIpadPortrait-margin.y)];
-        self.transform = CGAffineTransformIdentity;
-        
-    }else if(currentOrientation == UIInterfaceOrientationLandscapeLeft){
-        self.transform = CGAffineTransformMakeRotation(3*M_PI/2);
+    self.layer.rasterizationScale= [[UIScreen mainScreen] scale];
+    self.layer.shouldRasterize= rasterized;
+}
 
-        
-        self.frame = CGRectMake(margin.x,margin.y ,webViewHeightForIpadLandscape,webViewWidthForIpadLandscape);
-        [self setBounds:CGRectMake(0, 0 ,boundWidth,boundHeight)];
-        
-    }else if(currentOrientation == UIInterfaceOrientationLandscapeRight){
-        self.transform = CGAffineTransformMakeRotation(M_PI/2);
 
-        self.frame = CGRectMake(margin.x,margin.y,webViewHeightForIpadLandscape,webViewWidthForIpadLandscape);
-        [self setBounds:CGRectMake(0, 0 ,boundWidth,boundHeight)];
-    }
-    
+-(void)resetWebViewForIpad
+{
+    [self applyLayout:ChatSDKWebViewLayoutPad];
 }
 
 
 -(void)resetWebViewForIpadWithFrame
 {
-    CGPoint margin= [self getMargins];
-    float boundWidth= floorf(([resources.widthLandscape floatValue] / 100) * deviceHeight);
-    float boundHeight= floorf(([resources.heightLandscape floatValue] /100) * deviceWidth);
-
-    NSLog(@"resetWebViewForIpadWithFrame2  %f  %f",webViewWidthForIpadLandscape,webViewHeightForIpadLandscape);
-    
-    UIInterfaceOrientation currentOrientation = [[UIApplication sharedApplication] statusBarOrientation];
-    if (currentOrientation == UIInterfaceOrientationPortrait || currentOrientation==
-        UIInterfaceOrientationPortraitUpsideDown){
-        self.frame = CGRectMake(margin.x,margin.y,webViewWidthForIpadPortrait,webViewHeightForIpadPortrait-margin.y);
-        [self setBounds:CGRectMake(0, 0 ,webViewWidthForIpadPortrait,webViewHeightForIpadPortrait-margin.y)];
-        self.transform = CGAffineTransformIdentity;
-    }else if(currentOrientation == UIInterfaceOrientationLandscapeLeft){
-        self.transform = CGAffineTransformMakeRotation(3*M_PI/2);
-
-        self.frame = CGRectMake(margin.x,margin.y,webViewHeightForIpadLandscape,webViewWidthForIpadLandscape );
-        [self setBounds:CGRectMake(0, 0 ,boundWidth,boundHeight)];
-    }else if(currentOrientation == UIInterfaceOrientationLandscapeRight){
-        self.transform = CGAffineTransformMakeRotation(M_PI/2);
-
-        self.frame = CGRectMake(margin.x,margin.y,webViewHeightForIpadLandscape,webViewWidthForIpadLandscape);
-        [self setBounds:CGRectMake(0, 0 ,boundWidth,boundHeight)];
-    }
-    
-
+    [self applyLayout:ChatSDKWebViewLayoutPad];
 }
 
 -(void)dealloc{
+    uiWebView.delegate=nil;
+#ifdef CHATSDK_WKWEBVIEW
+    wkWebView.navigationDelegate=nil;
+    [wkWebView.configuration.userContentController removeScriptMessageHandlerForName:kChatSDKMessageHandler];
+#endif
     [[NSNotificationCenter defaultCenter]removeObserver:self name:UIDeviceOrientationDidChangeNotification object:nil];
     [[NSNotificationCenter defaultCenter]removeObserver:self name:UIKeyboardDidShowNotification object:nil];
     [[NSNotificationCenter defaultCenter]removeObserver:self name:UIKeyboardWillHideNotification object:nil];
@@ -531,181 +653,6 @@ ChatSDKResources* resources=nil;
 
 
 
--(CGPoint)getMargins{
-    
-    float screenWidth=deviceWidth;
-    float screenHeight=deviceHeight;
-    
-    NSLog(@"$$$$ deviceHeight: %f , deviceWidth: %f , webViewHeight: %f , webViewWidth: %f , webViewLandHeight: %f , webViewLandWidth: %f",deviceHeight, deviceWidth, webViewHeightForIpadPortrait, webViewWidthForIpadPortrait, webViewHeightForIpadLandscape, webViewWidthForIpadLandscape);
-    
-    float statusBarHeight=20;
-    
-    NSString* verticleAlign= [[NSString alloc]initWithFormat:@"%@",resources.valignPortrait]; //top, middle, bottom
-    NSString* horizontalAlign= [[NSString alloc]initWithFormat:@"%@", resources.halignPortrait]; //center, left, right
-    
-    float marginLeft=0;
-    float marginTop=0;
-    
-    UIInterfaceOrientation currentOrientation = [[UIApplication sharedApplication] statusBarOrientation];
-    if (currentOrientation == UIInterfaceOrientationPortrait || currentOrientation== UIInterfaceOrientationPortraitUpsideDown){
-        
-        if([verticleAlign isEqualToString:@"top"])
-        {
-            marginTop=0;
-            
-            //Padding Adjustment
-            marginTop+=paddingTopPortrait;
-        }
-        else if([verticleAlign isEqualToString:@"middle"])
-        {
-            marginTop=(screenHeight-webViewHeightForIpadPortrait)/2;
-        }
-        else if([verticleAlign isEqualToString:@"bottom"])
-        {
-            marginTop=(screenHeight-webViewHeightForIpadPortrait);
-        }
-        
-        if([horizontalAlign isEqualToString:@"left"])
-        {
-            marginLeft=0;
-            
-            //Padding Adjustment
-            marginLeft+=paddingLeftPortrait;
-        }
-        else if([horizontalAlign isEqualToString:@"center"])
-        {
-            marginLeft=(screenWidth-webViewWidthForIpadPortrait)/2;
-            
-            //Padding Adjustment
-            marginLeft+=paddingLeftPortrait;
-        }
-        else if([horizontalAlign isEqualToString:@"right"])
-        {
-            marginLeft=(screenWidth-webViewWidthForIpadPortrait);
-            
-            //Padding Adjustment
-            marginLeft-=paddingRightPortrait;
-        }
-        
-        //Status bar adjustment
-        marginTop+=statusBarHeight;
-        
-        NSLog(@"$$$$ Portrait Orientation-> MarginLeft: %f, MarginTop: %f ",marginLeft, marginTop);
-        
-        return CGPointMake(marginLeft, marginTop);
-        
-    }else if(currentOrientation == UIInterfaceOrientationLandscapeLeft){
-        
-        if([verticleAlign isEqualToString:@"top"])
-        {
-            marginTop=0;
-            
-            //Padding Adjustment
-            marginTop+=paddingTopLandscape;
-        }
-        else if([verticleAlign isEqualToString:@"middle"])
-        {
-            marginTop=(screenWidth-webViewHeightForIpadLandscape)/2;
-        }
-        else if([verticleAlign isEqualToString:@"bottom"])
-        {
-            marginTop=(screenWidth-webViewHeightForIpadLandscape);
-        }
-        
-        if([horizontalAlign isEqualToString:@"left"])
-        {
-            marginLeft=deviceHeight-webViewWidthForIpadLandscape;
-            
-            //Padding Adjustment
-            marginLeft-=paddingLeftLandscape;
-            
-            //Clipping Fix
-            float diff= webViewHeightForIpadLandscape- webViewWidthForIpadLandscape;
-            if(!diff==0){ marginLeft-= diff/2; marginTop-=diff/2;}
-            
-        }
-        else if([horizontalAlign isEqualToString:@"center"])
-        {
-            marginLeft=(screenHeight-webViewWidthForIpadLandscape)/2;
-            
-            //Padding Adjustment
-            marginLeft-=paddingLeftLandscape;
-        }
-        else if([horizontalAlign isEqualToString:@"right"])
-        {
-            marginLeft=0;
-            
-            //Padding Adjustment
-            marginLeft+=paddingRightLandscape;
-            
-            //Clipping Fix
-            float diff= webViewHeightForIpadLandscape- webViewWidthForIpadLandscape;
-            if(!diff==0){ marginLeft+= diff/2; marginTop-=diff/2;}
-        }
-        
-        //Status bar adjustment
-        marginTop+=statusBarHeight;
-        NSLog(@"$$$$ Landscape Left Orientation-> MarginLeft: %f, MarginTop: %f ",marginLeft, marginTop);
-        
-        return CGPointMake(marginTop, marginLeft);
-        
-    }else if(currentOrientation == UIInterfaceOrientationLandscapeRight){
-        if([verticleAlign isEqualToString:@"top"])
-        {
-            marginTop=deviceWidth-webViewHeightForIpadLandscape;
-            
-            //Padding Adjustment
-            marginTop-=paddingTopLandscape;
-        }
-        else if([verticleAlign isEqualToString:@"middle"])
-        {
-            marginTop=(screenWidth-webViewHeightForIpadLandscape)/2;
-        }
-        else if([verticleAlign isEqualToString:@"bottom"])
-        {
-            marginTop=(screenWidth-webViewHeightForIpadLandscape);
-        }
-        
-        if([horizontalAlign isEqualToString:@"left"])
-        {
-            marginLeft=0;
-            
-            //Padding Adjustment
-            marginLeft+=paddingLeftLandscape;
-            
-            //Clipping Fix
-            float diff= webViewHeightForIpadLandscape- webViewWidthForIpadLandscape;
-            if(!diff==0){ marginLeft+= diff/2; marginTop+=diff/2;}
-        }
-        else if([horizontalAlign isEqualToString:@"center"])
-        {
-            marginLeft=(screenHeight-webViewWidthForIpadLandscape)/2;
-            
-            //Padding Adjustment
-            marginLeft+=paddingLeftLandscape;
-        }
-        else if([horizontalAlign isEqualToString:@"right"])
-        {
-            marginLeft=screenHeight-webViewWidthForIpadLandscape;
-            
-            //Padding Adjustment
-            marginLeft-=paddingRightLandscape;
-            
-            //Clipping Fix
-            float diff= webViewHeightForIpadLandscape- webViewWidthForIpadLandscape;
-            if(!diff==0){ marginLeft-= diff/2; marginTop+=diff/2;}
-        }
-        
-        //Status bar adjustment
-        marginTop-=statusBarHeight;
-        NSLog(@"$$$$ Landscape Right Orientation-> MarginLeft: %f, MarginTop: %f ",marginLeft, marginTop);
-        
-        return CGPointMake(marginTop, marginLeft);
-    }
-    
-    return CGPointMake(0, 0);
-}
-
 /*
  // Only override drawRect: if you perform custom drawing.
  // An empty implementation adversely affects performance during animation.
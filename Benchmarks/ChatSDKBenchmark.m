@@ -0,0 +1,507 @@
+//
+//  ChatSDKBenchmark.m
+//  247ChatSDK
+//
+//  Copyright (c) 2014 . All rights reserved.
+//
+//  Microbenchmarks of the Foundation-only core of the SDK, see GNUmakefile.
+//
+//  chatsdk-bench [-d <seconds per benchmark>] [-f <name filter>] [-json] [-v]
+//
+
+#import <Foundation/Foundation.h>
+#import <stdatomic.h>
+#import <time.h>
+#import <fcntl.h>
+#import <unistd.h>
+#import "ChatSDKBridgeAction.h"
+#import "ChatSDKBridgeActionRegistry.h"
+#import "ChatSDKBridgeCodec.h"
+#import "ChatSDKJSBridge.h"
+#import "ChatSDKCAServerDetailParsing.h"
+#import "ChatSDKConfiguration.h"
+#import "ChatSDKTranscriptStore.h"
+
+#pragma mark Allocation counting
+
+#if defined(__GLIBC__)
+// Every heap allocation of the process goes through these, objects included
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *pointer, size_t size);
+
+static _Atomic(unsigned long long) allocations;
+
+void *malloc(size_t size)
+{
+    atomic_fetch_add_explicit(&allocations, 1, memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    atomic_fetch_add_explicit(&allocations, 1, memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size)
+{
+    atomic_fetch_add_explicit(&allocations, 1, memory_order_relaxed);
+    return __libc_realloc(pointer, size);
+}
+
+static BOOL allocationCountAvailable(void)
+{
+    return YES;
+}
+
+static unsigned long long allocationCount(void)
+{
+    return atomic_load_explicit(&allocations, memory_order_relaxed);
+}
+#else
+static BOOL allocationCountAvailable(void)
+{
+    return NO;
+}
+
+static unsigned long long allocationCount(void)
+{
+    return 0;
+}
+#endif
+
+#pragma mark Runner
+
+typedef void (^ChatSDKBenchmarkBody)(void);
+
+static double minimumDuration = 1.0;
+static NSString *nameFilter = nil;
+static NSMutableArray *results = nil;
+
+static double monotonicTime(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+// Runs body in doubling batches until minimumDuration has passed
+static void runBenchmark(NSString *name, ChatSDKBenchmarkBody body)
+{
+    if (nameFilter && [name rangeOfString:nameFilter].location == NSNotFound) {
+        return;
+    }
+    @autoreleasepool {
+        body();
+    }
+
+    unsigned long long iterations = 0;
+    unsigned long long allocated = 0;
+    unsigned long long batch = 1;
+    double elapsed = 0;
+    while (elapsed < minimumDuration) {
+        unsigned long long allocationsBefore = allocationCount();
+        double start = monotonicTime();
+        @autoreleasepool {
+            for (unsigned long long i = 0; i < batch; i++) {
+                body();
+            }
+        }
+        elapsed += monotonicTime() - start;
+        allocated += allocationCount() - allocationsBefore;
+        iterations += batch;
+        if (batch < (1 << 20)) {
+            batch *= 2;
+        }
+    }
+
+    NSMutableDictionary *result = [NSMutableDictionary dictionary];
+    [result setObject:name forKey:@"name"];
+    [result setObject:[NSNumber numberWithUnsignedLongLong:iterations] forKey:@"iterations"];
+    [result setObject:[NSNumber numberWithDouble:iterations / elapsed] forKey:@"opsPerSec"];
+    [result setObject:[NSNumber numberWithDouble:elapsed * 1e9 / iterations] forKey:@"nsPerOp"];
+    if (allocationCountAvailable()) {
+        [result setObject:[NSNumber numberWithDouble:(double)allocated / iterations] forKey:@"allocsPerOp"];
+    }
+    [results addObject:result];
+}
+
+#pragma mark Inputs
+
+// What encodeURIComponent leaves alone
+static NSString *percentEncoded(NSString *string)
+{
+    NSCharacterSet *unreserved = [NSCharacterSet characterSetWithCharactersInString:@"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_.!~*'()"];
+    return [string stringByAddingPercentEncodingWithAllowedCharacters:unreserved];
+}
+
+static NSString *JSONString(id object)
+{
+    return [[NSString alloc] initWithData:[NSJSONSerialization dataWithJSONObject:object options:0 error:NULL] encoding:NSUTF8StringEncoding];
+}
+
+// Params of a bridge call whose data has fieldCount string fields of text
+static NSDictionary *bridgeParamsWithText(NSUInteger fieldCount, NSString *text)
+{
+    NSMutableDictionary *data = [NSMutableDictionary dictionaryWithCapacity:fieldCount];
+    for (NSUInteger i = 0; i < fieldCount; i++) {
+        [data setObject:[NSString stringWithFormat:@"Agent message %lu, %@", (unsigned long)i, text] forKey:[NSString stringWithFormat:@"field%lu", (unsigned long)i]];
+    }
+    return @{ @"id" : @"cb_1024", @"data" : data };
+}
+
+static NSDictionary *bridgeParams(NSUInteger fieldCount)
+{
+    return bridgeParamsWithText(fieldCount, @"\"quoted\" & späcial");
+}
+
+#pragma mark Baseline
+
+// How the bridge decoded a query before ChatSDKBridgeCodec, only right for ASCII queries
+static id baselineJSONObjectWithPercentEncodedQuery(NSString *query)
+{
+    NSString *decodedQuery = [query stringByReplacingPercentEscapesUsingEncoding:NSASCIIStringEncoding];
+    return [NSJSONSerialization JSONObjectWithData:[decodedQuery dataUsingEncoding:NSUTF8StringEncoding] options:kNilOptions error:NULL];
+}
+
+// How the bridge encoded a response before ChatSDKBridgeCodec
+static NSData *baselineDataWithJSONObject(id object)
+{
+    return [NSJSONSerialization dataWithJSONObject:object options:NSJSONWritingPrettyPrinted error:NULL];
+}
+
+// How the bridge told a bridge call from a page request before ChatSDKBridgeCodec
+static BOOL baselineIsBridgeURL(NSURL *url)
+{
+    NSString *absoluteString = [url absoluteString];
+    return [absoluteString rangeOfString:@"/!chat_exec/"].location != NSNotFound || [absoluteString rangeOfString:@"/!chat_exec_batch/"].location != NSNotFound;
+}
+
+// config XML with queueCount CheckAvailability entries
+static NSData *configXML(NSUInteger queueCount)
+{
+    NSMutableString *xml = [NSMutableString stringWithString:@"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<config>\n<CheckAvailability>\n"];
+    for (NSUInteger i = 0; i < queueCount; i++) {
+        [xml appendFormat:@"<queue>queue-%lu</queue><url>https://ca%lu.example.com/checkAvailability?queueId=queue-%lu</url>\n", (unsigned long)i, (unsigned long)(i % 4), (unsigned long)i];
+    }
+    [xml appendString:@"</CheckAvailability>\n</config>\n"];
+    return [xml dataUsingEncoding:NSUTF8StringEncoding];
+}
+
+static NSString *writePlist(NSDictionary *plist, NSString *name)
+{
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSString stringWithFormat:@"chatsdk-bench-%d-%@.plist", (int)getpid(), name]];
+    [plist writeToFile:path atomically:YES];
+    return path;
+}
+
+static NSDictionary *defaultsPlist(void)
+{
+    NSDictionary *orientations = @{ @"Portrait" : @"100%", @"Landscape" : @"100%" };
+    return @{ @"custom minimize state" : @NO,
+              @"Mimimized button position" : @{ @"Portrait" : @"middle-right", @"Landscape" : @"middle-left", @"backgroundColor" : @"#586572", @"textColor" : @"#FFFFFF" },
+              @"Animation style" : @"bottom-top",
+              @"halign" : @{ @"Portrait" : @"center", @"Landscape" : @"center" },
+              @"valign" : @{ @"Portrait" : @"bottom", @"Landscape" : @"bottom" },
+              @"height" : orientations,
+              @"width" : orientations,
+              @"padding-top" : @{ @"Portrait" : @"10", @"Landscape" : @"10" },
+              @"padding-bottom" : @{ @"Portrait" : @"0", @"Landscape" : @"0" },
+              @"padding-left" : @{ @"Portrait" : @"0", @"Landscape" : @"0" },
+              @"padding-right" : @{ @"Portrait" : @"0", @"Landscape" : @"0" },
+              @"customURLScheme" : @"chatsdk" };
+}
+
+static NSDictionary *configPlist(void)
+{
+    return @{ @"chatsdk_url" : @"https://chat.example.com/mobile/index.html",
+              @"chatsdk_agentavailability_url" : @"https://ca.example.com/checkAvailability",
+              @"chatsdk_accountId" : @"account-1",
+              @"chatsdk_queueId" : @"queue-1",
+              @"chatsdk_config_url" : @"https://config.example.com/config.xml",
+              @"chatsdk_web_engine" : @"wkwebview",
+              @"chatsdk_batch_bridge" : @YES };
+}
+
+#pragma mark Bridge delegate
+
+// Answers like ChatSDK does, through a registry of sync handlers
+@interface ChatSDKBenchmarkDelegate : NSObject <ChatSDKJSBridgeDelegate>
+{
+    ChatSDKBridgeActionRegistry *registry;
+}
+@end
+
+@implementation ChatSDKBenchmarkDelegate
+
+-(id)init
+{
+    self = [super init];
+    if (self) {
+        registry = [[ChatSDKBridgeActionRegistry alloc] init];
+        NSDictionary *context = @{ @"customerId" : @"c-42", @"cart" : @{ @"items" : @3, @"total" : @"129.90" } };
+        [registry registerAction:@"getcontext" handler:^NSDictionary *(ChatSDKBridgeAction *action, NSError **error) {
+            return context;
+        }];
+        [registry registerAction:@"getqueueid" handler:^NSDictionary *(ChatSDKBridgeAction *action, NSError **error) {
+            return @{ @"QueueId" : @"queue-1" };
+        }];
+        [registry registerAction:@"onagentmessage" handler:^NSDictionary *(ChatSDKBridgeAction *action, NSError **error) {
+            return [[NSDictionary alloc] init];
+        }];
+    }
+    return self;
+}
+
+-(NSDictionary *)executeNative:(ChatSDKBridgeAction *)action error:(NSError **)error
+{
+    return [registry executeAction:action error:error];
+}
+
+@end
+
+#pragma mark Benchmarks
+
+// Each codec benchmark is paired with a .baseline one running the code it replaced on the same input. The
+// input is ASCII, which the baseline decode needs
+static void benchmarkCodec(void)
+{
+    NSUInteger sizes[] = { 1, 16, 256 };
+    for (int s = 0; s < 3; s++) {
+        NSDictionary *params = bridgeParamsWithText(sizes[s], @"\"quoted\" & special");
+        NSString *query = percentEncoded(JSONString(params));
+        NSString *suffix = [NSString stringWithFormat:@"%lufields/%luB", (unsigned long)sizes[s], (unsigned long)[query length]];
+
+        if (![baselineJSONObjectWithPercentEncodedQuery(query) isEqual:[ChatSDKBridgeCodec JSONObjectWithPercentEncodedQuery:query]]) {
+            fprintf(stdout, "warning: codec & baseline decode %s differently\n", [suffix UTF8String]);
+        }
+        runBenchmark([@"codec.decodeQuery/" stringByAppendingString:suffix], ^{
+            [ChatSDKBridgeCodec JSONObjectWithPercentEncodedQuery:query];
+        });
+        runBenchmark([@"codec.decodeQuery.baseline/" stringByAppendingString:suffix], ^{
+            baselineJSONObjectWithPercentEncodedQuery(query);
+        });
+        NSDictionary *envelope = [ChatSDKBridgeActionRegistry envelopeForCallId:@"cb_1024" data:[params objectForKey:@"data"]];
+        runBenchmark([@"codec.encodeResponse/" stringByAppendingString:suffix], ^{
+            [ChatSDKBridgeCodec dataWithJSONObject:envelope];
+        });
+        runBenchmark([@"codec.encodeResponse.baseline/" stringByAppendingString:suffix], ^{
+            baselineDataWithJSONObject(envelope);
+        });
+    }
+
+    // Non ASCII text, which the baseline could not decode
+    NSDictionary *params = bridgeParams(16);
+    NSString *query = percentEncoded(JSONString(params));
+    runBenchmark([NSString stringWithFormat:@"codec.decodeQuery/16fields/%luB/utf8", (unsigned long)[query length]], ^{
+        [ChatSDKBridgeCodec JSONObjectWithPercentEncodedQuery:query];
+    });
+
+    NSURL *callURL = [NSURL URLWithString:@"https://chat.example.com/!chat_exec/getcontext?%7B%22id%22%3A%22cb_1%22%7D"];
+    NSURL *pageURL = [NSURL URLWithString:@"https://chat.example.com/mobile/app.js"];
+    runBenchmark(@"codec.kindOfURL/call", ^{
+        [ChatSDKBridgeCodec kindOfURL:callURL];
+    });
+    runBenchmark(@"codec.kindOfURL.baseline/call", ^{
+        baselineIsBridgeURL(callURL);
+    });
+    runBenchmark(@"codec.kindOfURL/none", ^{
+        [ChatSDKBridgeCodec kindOfURL:pageURL];
+    });
+    runBenchmark(@"codec.kindOfURL.baseline/none", ^{
+        baselineIsBridgeURL(pageURL);
+    });
+}
+
+static void benchmarkBridge(void)
+{
+    ChatSDKBenchmarkDelegate *delegate = [[ChatSDKBenchmarkDelegate alloc] init];
+    NSString *smallQuery = percentEncoded(JSONString(bridgeParams(1)));
+    NSString *largeQuery = percentEncoded(JSONString(bridgeParams(16)));
+
+    runBenchmark(@"bridge.actionWithName/1fields", ^{
+        [ChatSDKJSBridge bridgeActionWithName:@"onAgentMessage" query:smallQuery];
+    });
+    runBenchmark(@"bridge.actionWithName/16fields", ^{
+        [ChatSDKJSBridge bridgeActionWithName:@"onAgentMessage" query:largeQuery];
+    });
+
+    ChatSDKBridgeAction *action = [[ChatSDKBridgeAction alloc] initWithAction:@"getcontext" andParams:@{ @"id" : @"cb_7" }];
+    runBenchmark(@"bridge.resultOfAction/getcontext", ^{
+        [ChatSDKJSBridge resultOfAction:action withDelegate:delegate];
+    });
+    runBenchmark(@"registry.envelope", ^{
+        [ChatSDKBridgeActionRegistry envelopeForCallId:@"cb_7" data:@{ @"QueueId" : @"queue-1" }];
+    });
+
+    NSMutableArray *calls = [NSMutableArray array];
+    for (int i = 0; i < 8; i++) {
+        [calls addObject:@{ @"action" : (i % 2 ? @"getqueueid" : @"getcontext"), @"id" : [NSString stringWithFormat:@"cb_%d", i], @"params" : @{} }];
+    }
+    NSString *batchQuery = percentEncoded(JSONString(calls));
+    runBenchmark(@"bridge.resultsOfBatch/8calls", ^{
+        [ChatSDKJSBridge resultsOfBatch:batchQuery withDelegate:delegate];
+    });
+
+    // Whole interception as the web view sees it, response headers included
+    ChatSDKJSBridge *cache = [[ChatSDKJSBridge alloc] initWithMemoryCapacity:0 diskCapacity:0 diskPath:nil];
+    cache.delegate = delegate;
+    NSURLRequest *request = [NSURLRequest requestWithURL:[NSURL URLWithString:[@"https://chat.example.com/!chat_exec/getcontext?" stringByAppendingString:percentEncoded(@"{\"id\":\"cb_9\"}")]]];
+    runBenchmark(@"bridge.cachedResponseForRequest/getcontext", ^{
+        [cache cachedResponseForRequest:request];
+    });
+}
+
+static void benchmarkConfigXML(void)
+{
+    NSUInteger sizes[] = { 10, 100, 1000 };
+    for (int s = 0; s < 3; s++) {
+        NSData *xml = configXML(sizes[s]);
+        runBenchmark([NSString stringWithFormat:@"caxml.parse/%luqueues/%luB", (unsigned long)sizes[s], (unsigned long)[xml length]], ^{
+            ChatSDKCAServerDetailParsing *parser = [[ChatSDKCAServerDetailParsing alloc] initWithXMLData:xml];
+            [parser caXmlResponse];
+        });
+    }
+}
+
+static void benchmarkConfiguration(void)
+{
+    NSString *defaultsPath = writePlist(defaultsPlist(), @"chatsdkdefaults");
+    NSString *configPath = writePlist(configPlist(), @"chatsdkconfig");
+
+    runBenchmark(@"configuration.load", ^{
+        [ChatSDKConfiguration configurationWithDefaultsFile:defaultsPath configFile:configPath];
+    });
+    ChatSDKConfiguration *configuration = [ChatSDKConfiguration configurationWithDefaultsFile:defaultsPath configFile:configPath];
+    if (![configuration isValid]) {
+        fprintf(stdout, "warning: benchmark plists did not validate\n");
+    }
+
+    // What every layout pays now that the plists are parsed once
+    [ChatSDKConfiguration setSharedConfiguration:configuration];
+    runBenchmark(@"configuration.shared", ^{
+        [[ChatSDKConfiguration sharedConfiguration] paddingTop];
+    });
+
+    [[NSFileManager defaultManager] removeItemAtPath:defaultsPath error:NULL];
+    [[NSFileManager defaultManager] removeItemAtPath:configPath error:NULL];
+}
+
+static void benchmarkTranscript(void)
+{
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSString stringWithFormat:@"chatsdk-bench-%d-transcript.sqlite", (int)getpid()]];
+    ChatSDKTranscriptStore *store = [[ChatSDKTranscriptStore alloc] initWithPath:path];
+    NSDictionary *message = [bridgeParams(4) objectForKey:@"data"];
+
+    // Append & read back, what onagentmessage followed by gettranscript of the reopened chat pays
+    for (NSUInteger i = 0; i < 200; i++) {
+        [store appendEntryOfType:@"agentmessage" data:message toTranscript:@"queue-1"];
+    }
+    runBenchmark(@"transcript.read/200entries", ^{
+        [store entriesOfTranscript:@"queue-1" afterSequence:0 limit:200];
+    });
+    __block long long sequence = 0;
+    runBenchmark(@"transcript.append+read", ^{
+        [store appendEntryOfType:@"agentmessage" data:message toTranscript:@"queue-2"];
+        NSArray *entries = [store entriesOfTranscript:@"queue-2" afterSequence:sequence limit:0];
+        sequence = [[[entries lastObject] objectForKey:@"seq"] longLongValue];
+    });
+
+    store = nil;
+    [[NSFileManager defaultManager] removeItemAtPath:path error:NULL];
+    [[NSFileManager defaultManager] removeItemAtPath:[path stringByAppendingString:@"-wal"] error:NULL];
+    [[NSFileManager defaultManager] removeItemAtPath:[path stringByAppendingString:@"-shm"] error:NULL];
+}
+
+#pragma mark Report
+
+// Each x.baseline/y result against its x/y counterpart
+static void printBaselineComparison(void)
+{
+    NSMutableDictionary *resultsByName = [NSMutableDictionary dictionary];
+    for (NSDictionary *result in results) {
+        [resultsByName setObject:result forKey:[result objectForKey:@"name"]];
+    }
+    BOOL header = NO;
+    for (NSDictionary *baseline in results) {
+        NSString *name = [baseline objectForKey:@"name"];
+        if ([name rangeOfString:@".baseline/"].location == NSNotFound) {
+            continue;
+        }
+        NSDictionary *result = [resultsByName objectForKey:[name stringByReplacingOccurrencesOfString:@".baseline/" withString:@"/"]];
+        if (result == nil) {
+            continue;
+        }
+        if (!header) {
+            fprintf(stdout, "\n%-52s %14s %12s\n", "against baseline", "speedup", "allocs/op");
+            header = YES;
+        }
+        NSNumber *allocsPerOp = [result objectForKey:@"allocsPerOp"];
+        NSNumber *baselineAllocsPerOp = [baseline objectForKey:@"allocsPerOp"];
+        fprintf(stdout, "%-52s %13.2fx %12s\n",
+                [[result objectForKey:@"name"] UTF8String],
+                [[baseline objectForKey:@"nsPerOp"] doubleValue] / [[result objectForKey:@"nsPerOp"] doubleValue],
+                allocsPerOp ? [[NSString stringWithFormat:@"%.1f -> %.1f", [baselineAllocsPerOp doubleValue], [allocsPerOp doubleValue]] UTF8String] : "n/a");
+    }
+}
+
+static void printResults(BOOL json)
+{
+    if (json) {
+        NSData *data = [NSJSONSerialization dataWithJSONObject:results options:NSJSONWritingPrettyPrinted error:NULL];
+        fwrite([data bytes], 1, [data length], stdout);
+        fputc('\n', stdout);
+        return;
+    }
+    fprintf(stdout, "%-52s %14s %12s %12s\n", "benchmark", "ops/sec", "ns/op", "allocs/op");
+    for (NSDictionary *result in results) {
+        NSNumber *allocsPerOp = [result objectForKey:@"allocsPerOp"];
+        fprintf(stdout, "%-52s %14.0f %12.1f %12s\n",
+                [[result objectForKey:@"name"] UTF8String],
+                [[result objectForKey:@"opsPerSec"] doubleValue],
+                [[result objectForKey:@"nsPerOp"] doubleValue],
+                allocsPerOp ? [[NSString stringWithFormat:@"%.1f", [allocsPerOp doubleValue]] UTF8String] : "n/a");
+    }
+    printBaselineComparison();
+}
+
+int main(int argc, const char *argv[])
+{
+    @autoreleasepool {
+        BOOL json = NO;
+        BOOL verbose = NO;
+        for (int i = 1; i < argc; i++) {
+            if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+                minimumDuration = atof(argv[++i]);
+            } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+                nameFilter = [NSString stringWithUTF8String:argv[++i]];
+            } else if (strcmp(argv[i], "-json") == 0) {
+                json = YES;
+            } else if (strcmp(argv[i], "-v") == 0) {
+                verbose = YES;
+            } else {
+                fprintf(stderr, "usage: %s [-d <seconds per benchmark>] [-f <name filter>] [-json] [-v]\n", argv[0]);
+                return 1;
+            }
+        }
+
+        // NSLog output of the SDK, e.g. of the configuration check, is not shown
+        if (!verbose) {
+            int devNull = open("/dev/null", O_WRONLY);
+            if (devNull >= 0) {
+                dup2(devNull, STDERR_FILENO);
+                close(devNull);
+            }
+        }
+
+        results = [NSMutableArray array];
+        benchmarkCodec();
+        benchmarkBridge();
+        benchmarkConfigXML();
+        benchmarkConfiguration();
+        benchmarkTranscript();
+        printResults(json);
+    }
+    return 0;
+}
@@ -0,0 +1,575 @@
+//
+//  ChatSDKTests.m
+//  247ChatSDK
+//
+//  Copyright (c) 2014 . All rights reserved.
+//
+//  Tests of the Foundation-only core of the SDK, see GNUmakefile. Network requests are answered by
+//  ChatSDKTestServer, a stand-in NSURLProtocol, nothing leaves the machine.
+//
+//  chatsdk-test [-f <name filter>] [-v]
+//
+
+#import <Foundation/Foundation.h>
+#import <unistd.h>
+#import "ChatSDKAvailabilitySubscriber.h"
+#import "ChatSDKRequestScheduler.h"
+#import "ChatSDKTranscriptStore.h"
+
+#pragma mark Runner
+
+typedef void (^ChatSDKTestBody)(void);
+
+static NSString *nameFilter = nil;
+static BOOL verbose = NO;
+static NSUInteger testsRun = 0;
+static NSUInteger testsFailed = 0;
+static BOOL currentTestFailed = NO;
+
+#define CHATSDK_CHECK(condition, ...) \
+    do { \
+        if (!(condition)) { \
+            currentTestFailed = YES; \
+            fprintf(stderr, "  %s:%d: %s\n", __FILE__, __LINE__, [[NSString stringWithFormat:__VA_ARGS__] UTF8String]); \
+        } \
+    } while (0)
+
+static void runTest(NSString *name, ChatSDKTestBody body)
+{
+    if (nameFilter && [name rangeOfString:nameFilter].location == NSNotFound) {
+        return;
+    }
+    testsRun++;
+    currentTestFailed = NO;
+    @autoreleasepool {
+        body();
+    }
+    if (currentTestFailed) {
+        testsFailed++;
+    }
+    if (currentTestFailed || verbose) {
+        printf("%s %s\n", currentTestFailed ? "FAIL" : "ok  ", [name UTF8String]);
+    }
+}
+
+// Runs the main run loop, which also drains the main queue, until condition holds or timeout passed
+static BOOL waitUntil(NSTimeInterval timeout, BOOL (^condition)(void))
+{
+    NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:timeout];
+    while (!condition()) {
+        if ([deadline timeIntervalSinceNow] <= 0) {
+            return NO;
+        }
+        [[NSRunLoop currentRunLoop] runMode:NSDefaultRunLoopMode beforeDate:[NSDate dateWithTimeIntervalSinceNow:0.01]];
+    }
+    return YES;
+}
+
+// Runs the main run loop for duration
+static void spin(NSTimeInterval duration)
+{
+    waitUntil(duration, ^BOOL(void) {
+        return NO;
+    });
+}
+
+#pragma mark Stand-in server
+
+// What ChatSDKTestServer answers to a request, after delay
+@interface ChatSDKTestResponse : NSObject
+@property (nonatomic, assign) NSInteger statusCode;
+@property (nonatomic, strong) NSData *body;
+@property (nonatomic, strong) NSError *error;
+@property (nonatomic, assign) NSTimeInterval delay;
+@end
+
+@implementation ChatSDKTestResponse
+
++(ChatSDKTestResponse *)availability:(BOOL)available
+{
+    ChatSDKTestResponse *response = [[ChatSDKTestResponse alloc] init];
+    response.statusCode = 200;
+    response.body = [[NSString stringWithFormat:@"{\"data\":{\"caStatus\":%@}}", available ? @"true" : @"false"] dataUsingEncoding:NSUTF8StringEncoding];
+    return response;
+}
+
++(ChatSDKTestResponse *)serverError
+{
+    ChatSDKTestResponse *response = [[ChatSDKTestResponse alloc] init];
+    response.statusCode = 500;
+    response.body = [@"Internal Server Error" dataUsingEncoding:NSUTF8StringEncoding];
+    return response;
+}
+
++(ChatSDKTestResponse *)failure:(NSInteger)code
+{
+    ChatSDKTestResponse *response = [[ChatSDKTestResponse alloc] init];
+    response.error = [NSError errorWithDomain:NSURLErrorDomain code:code userInfo:nil];
+    return response;
+}
+
+@end
+
+typedef ChatSDKTestResponse *(^ChatSDKTestResponder)(NSURLRequest *request, NSUInteger index);
+
+// Answers every request of a session configured with it through its responder & keeps what it was asked
+@interface ChatSDKTestServer : NSURLProtocol
++(void)setResponder:(ChatSDKTestResponder)responder;
+// NSURL of each request, oldest first
++(NSArray *)requestURLs;
+// NSDate each request came in, oldest first
++(NSArray *)requestDates;
++(NSURLSessionConfiguration *)sessionConfiguration;
+@end
+
+static ChatSDKTestResponder serverResponder = nil;
+static NSMutableArray *serverRequestURLs = nil;
+static NSMutableArray *serverRequestDates = nil;
+
+@implementation ChatSDKTestServer
+{
+    // Set by stopLoading, a cancelled request is not answered
+    BOOL stopped;
+}
+
++(void)setResponder:(ChatSDKTestResponder)responder
+{
+    @synchronized(self) {
+        serverResponder = [responder copy];
+        serverRequestURLs = [[NSMutableArray alloc] init];
+        serverRequestDates = [[NSMutableArray alloc] init];
+    }
+}
+
++(NSArray *)requestURLs
+{
+    @synchronized(self) {
+        return [serverRequestURLs copy];
+    }
+}
+
++(NSArray *)requestDates
+{
+    @synchronized(self) {
+        return [serverRequestDates copy];
+    }
+}
+
++(NSURLSessionConfiguration *)sessionConfiguration
+{
+    NSURLSessionConfiguration *configuration = [NSURLSessionConfiguration ephemeralSessionConfiguration];
+    configuration.protocolClasses = [NSArray arrayWithObject:self];
+    return configuration;
+}
+
++(BOOL)canInitWithRequest:(NSURLRequest *)request
+{
+    return YES;
+}
+
++(NSURLRequest *)canonicalRequestForRequest:(NSURLRequest *)request
+{
+    return request;
+}
+
+-(void)startLoading
+{
+    ChatSDKTestResponder responder = nil;
+    NSUInteger index = 0;
+    @synchronized([self class]) {
+        responder = serverResponder;
+        index = [serverRequestURLs count];
+        [serverRequestURLs addObject:[[self request] URL]];
+        [serverRequestDates addObject:[NSDate date]];
+    }
+    ChatSDKTestResponse *response = responder ? responder([self request], index) : [ChatSDKTestResponse serverError];
+
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(response.delay * NSEC_PER_SEC)), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(void) {
+        @synchronized(self) {
+            if (stopped) {
+                return;
+            }
+        }
+        if (response.error) {
+            [[self client] URLProtocol:self didFailWithError:response.error];
+            return;
+        }
+        NSHTTPURLResponse *httpResponse = [[NSHTTPURLResponse alloc] initWithURL:[[self request] URL] statusCode:response.statusCode HTTPVersion:@"HTTP/1.1" headerFields:@{ @"Content-Type" : @"application/json" }];
+        [[self client] URLProtocol:self didReceiveResponse:httpResponse cacheStoragePolicy:NSURLCacheStorageNotAllowed];
+        [[self client] URLProtocol:self didLoadData:response.body];
+        [[self client] URLProtocolDidFinishLoading:self];
+    });
+}
+
+-(void)stopLoading
+{
+    @synchronized(self) {
+        stopped = YES;
+    }
+}
+
+@end
+
+#pragma mark Availability subscriber
+
+static NSString *const kTestAvailabilityURL = @"https://ca.test/checkAvailability?queueId=queue-1&accountId=account-1";
+
+static ChatSDKAvailabilitySubscriber *testSubscriber(NSMutableArray *updates)
+{
+    ChatSDKAvailabilitySubscriber *subscriber = [[ChatSDKAvailabilitySubscriber alloc] initWithURLProvider:^NSArray *(NSString *queueId) {
+        return [NSArray arrayWithObject:kTestAvailabilityURL];
+    } sessionConfiguration:[ChatSDKTestServer sessionConfiguration]];
+    subscriber.longPollTimeout = 1;
+    subscriber.minimumInterval = 0.05;
+    subscriber.initialRetryDelay = 0.05;
+    subscriber.updateHandler = ^(NSString *queueId, BOOL available) {
+        [updates addObject:[NSNumber numberWithBool:available]];
+    };
+    return subscriber;
+}
+
+static BOOL URLHasParameter(NSURL *url, NSString *parameter)
+{
+    return [[url query] rangeOfString:parameter].location != NSNotFound;
+}
+
+static void testAvailabilitySubscriber(void)
+{
+    runTest(@"AvailabilitySubscriber/deliversOnlyChanges", ^{
+        NSArray *answers = @[ @YES, @YES, @YES, @NO, @NO ];
+        [ChatSDKTestServer setResponder:^ChatSDKTestResponse *(NSURLRequest *request, NSUInteger index) {
+            return [ChatSDKTestResponse availability:[[answers objectAtIndex:MIN(index, [answers count] - 1)] boolValue]];
+        }];
+        NSMutableArray *updates = [NSMutableArray array];
+        ChatSDKAvailabilitySubscriber *subscriber = testSubscriber(updates);
+        [subscriber subscribeToQueue:@"queue-1"];
+        CHATSDK_CHECK(waitUntil(5, ^BOOL(void) { return [[ChatSDKTestServer requestURLs] count] >= [answers count] + 1; }), @"subscriber stopped polling");
+        [subscriber unsubscribeAll];
+
+        CHATSDK_CHECK([updates isEqualToArray:(@[ @YES, @NO ])], @"updates %@, expected the first answer & the change only", updates);
+        NSArray *urls = [ChatSDKTestServer requestURLs];
+        CHATSDK_CHECK(URLHasParameter([urls objectAtIndex:0], @"longPoll=1") && !URLHasParameter([urls objectAtIndex:0], @"caStatus="), @"first request %@", [urls objectAtIndex:0]);
+        CHATSDK_CHECK(URLHasParameter([urls objectAtIndex:1], @"caStatus=true"), @"second request %@ does not carry the last answer", [urls objectAtIndex:1]);
+        CHATSDK_CHECK(URLHasParameter([urls lastObject], @"caStatus=false"), @"last request %@ does not carry the changed answer", [urls lastObject]);
+    });
+
+    runTest(@"AvailabilitySubscriber/resubscribesAfterTimeout", ^{
+        [ChatSDKTestServer setResponder:^ChatSDKTestResponse *(NSURLRequest *request, NSUInteger index) {
+            switch (index) {
+                case 0:
+                    return [ChatSDKTestResponse availability:YES];
+                case 1: {
+                    // Held by the server for the whole long poll without a change
+                    ChatSDKTestResponse *response = [ChatSDKTestResponse availability:YES];
+                    response.delay = 0.3;
+                    return response;
+                }
+                case 2: {
+                    ChatSDKTestResponse *response = [ChatSDKTestResponse failure:NSURLErrorTimedOut];
+                    response.delay = 0.3;
+                    return response;
+                }
+                default: {
+                    ChatSDKTestResponse *response = [ChatSDKTestResponse availability:NO];
+                    response.delay = 0.3;
+                    return response;
+                }
+            }
+        }];
+        NSMutableArray *updates = [NSMutableArray array];
+        ChatSDKAvailabilitySubscriber *subscriber = testSubscriber(updates);
+        [subscriber subscribeToQueue:@"queue-1"];
+        CHATSDK_CHECK(waitUntil(5, ^BOOL(void) { return [updates count] >= 2; }), @"no update after the timed out requests, updates %@", updates);
+        [subscriber unsubscribeAll];
+
+        CHATSDK_CHECK([updates isEqualToArray:(@[ @YES, @NO ])], @"updates %@", updates);
+        NSArray *urls = [ChatSDKTestServer requestURLs];
+        CHATSDK_CHECK([urls count] >= 4, @"%lu requests, expected a new one after each timeout", (unsigned long)[urls count]);
+        for (NSUInteger i = 1; i < MIN([urls count], (NSUInteger)4); i++) {
+            CHATSDK_CHECK(URLHasParameter([urls objectAtIndex:i], @"caStatus=true"), @"request %lu %@ lost the last answer", (unsigned long)i, [urls objectAtIndex:i]);
+        }
+    });
+
+    runTest(@"AvailabilitySubscriber/backsOffOnError", ^{
+        [ChatSDKTestServer setResponder:^ChatSDKTestResponse *(NSURLRequest *request, NSUInteger index) {
+            return index % 2 ? [ChatSDKTestResponse failure:NSURLErrorCannotConnectToHost] : [ChatSDKTestResponse serverError];
+        }];
+        NSMutableArray *updates = [NSMutableArray array];
+        ChatSDKAvailabilitySubscriber *subscriber = testSubscriber(updates);
+        [subscriber subscribeToQueue:@"queue-1"];
+        CHATSDK_CHECK(waitUntil(5, ^BOOL(void) { return [[ChatSDKTestServer requestDates] count] >= 5; }), @"subscriber stopped retrying");
+        [subscriber unsubscribeAll];
+
+        CHATSDK_CHECK([updates count] == 0, @"updates %@ from failed requests", updates);
+        // 0.05, 0.1, 0.2, 0.4 seconds between the attempts
+        NSArray *dates = [ChatSDKTestServer requestDates];
+        NSTimeInterval expected = subscriber.initialRetryDelay;
+        for (NSUInteger i = 1; i < 5; i++) {
+            NSTimeInterval gap = [[dates objectAtIndex:i] timeIntervalSinceDate:[dates objectAtIndex:i - 1]];
+            CHATSDK_CHECK(gap >= expected * 0.9, @"retry %lu after %.3fs, expected at least %.3fs", (unsigned long)i, gap, expected);
+            // The next step of the backoff, with room for a busy machine
+            CHATSDK_CHECK(gap < expected * 2 + 0.05, @"retry %lu after %.3fs, expected less than %.3fs", (unsigned long)i, gap, expected * 2 + 0.05);
+            expected *= 2;
+        }
+    });
+
+    runTest(@"AvailabilitySubscriber/pauseStopsPolling", ^{
+        [ChatSDKTestServer setResponder:^ChatSDKTestResponse *(NSURLRequest *request, NSUInteger index) {
+            ChatSDKTestResponse *response = [ChatSDKTestResponse availability:index == 0];
+            response.delay = index == 0 ? 0 : 0.2;
+            return response;
+        }];
+        NSMutableArray *updates = [NSMutableArray array];
+        ChatSDKAvailabilitySubscriber *subscriber = testSubscriber(updates);
+        [subscriber subscribeToQueue:@"queue-1"];
+        CHATSDK_CHECK(waitUntil(5, ^BOOL(void) { return [[ChatSDKTestServer requestURLs] count] >= 2; }), @"no long poll after the first answer");
+        [subscriber pause];
+        NSUInteger requests = [[ChatSDKTestServer requestURLs] count];
+        spin(0.5);
+
+        CHATSDK_CHECK([[ChatSDKTestServer requestURLs] count] == requests, @"%lu requests while paused", (unsigned long)([[ChatSDKTestServer requestURLs] count] - requests));
+        CHATSDK_CHECK([updates isEqualToArray:(@[ @YES ])], @"updates %@, the answer of the cancelled request must be dropped", updates);
+        [subscriber unsubscribeAll];
+    });
+}
+
+#pragma mark Request scheduler
+
+static NSUInteger metric(ChatSDKRequestScheduler *scheduler, NSString *name)
+{
+    return [[[scheduler metrics] objectForKey:name] unsignedIntegerValue];
+}
+
+static void testRequestScheduler(void)
+{
+    runTest(@"RequestScheduler/dedupesByKey", ^{
+        ChatSDKRequestScheduler *scheduler = [[ChatSDKRequestScheduler alloc] init];
+        scheduler.reachable = NO;
+        NSMutableArray *ran = [NSMutableArray array];
+        ChatSDKScheduledRequest (^request)(NSString *) = ^ChatSDKScheduledRequest(NSString *name) {
+            return ^(NSUInteger attempt, BOOL lastAttempt, ChatSDKRequestDone done) {
+                [ran addObject:name];
+                done(ChatSDKRequestSucceeded);
+            };
+        };
+        [scheduler scheduleRequest:request(@"a1") withKey:@"a"];
+        [scheduler scheduleRequest:request(@"a2") withKey:@"a"];
+        [scheduler scheduleRequest:request(@"n1") withKey:nil];
+        [scheduler scheduleRequest:request(@"n2") withKey:nil];
+        CHATSDK_CHECK(scheduler.queueDepth == 3, @"queueDepth %lu, expected a1, n1 & n2", (unsigned long)scheduler.queueDepth);
+        CHATSDK_CHECK(metric(scheduler, @"coalesced") == 1, @"coalesced %lu", (unsigned long)metric(scheduler, @"coalesced"));
+
+        scheduler.flushSpread = 0;
+        scheduler.reachable = YES;
+        CHATSDK_CHECK(waitUntil(2, ^BOOL(void) { return metric(scheduler, @"succeeded") == 3; }), @"ran %@", ran);
+        CHATSDK_CHECK([[ran sortedArrayUsingSelector:@selector(compare:)] isEqualToArray:(@[ @"a1", @"n1", @"n2" ])], @"ran %@", ran);
+
+        // A running request of the key does the work too
+        __block NSUInteger running = 0;
+        __block ChatSDKRequestDone pendingDone = nil;
+        ChatSDKScheduledRequest held = ^(NSUInteger attempt, BOOL lastAttempt, ChatSDKRequestDone done) {
+            running++;
+            pendingDone = done;
+        };
+        [scheduler scheduleRequest:held withKey:@"b"];
+        [scheduler scheduleRequest:held withKey:@"b"];
+        CHATSDK_CHECK(running == 1, @"%lu runs of key b while one was running", (unsigned long)running);
+        pendingDone(ChatSDKRequestSucceeded);
+        CHATSDK_CHECK(waitUntil(2, ^BOOL(void) { return metric(scheduler, @"succeeded") == 4; }), @"key b did not finish");
+        [scheduler scheduleRequest:held withKey:@"b"];
+        CHATSDK_CHECK(running == 2, @"key b not run again once the first one finished");
+    });
+
+    runTest(@"RequestScheduler/dropsOldestBeyondMaximumQueueDepth", ^{
+        ChatSDKRequestScheduler *scheduler = [[ChatSDKRequestScheduler alloc] init];
+        scheduler.reachable = NO;
+        scheduler.maximumQueueDepth = 3;
+        scheduler.flushSpread = 0;
+        NSMutableArray *ran = [NSMutableArray array];
+        for (int i = 0; i < 5; i++) {
+            NSString *name = [NSString stringWithFormat:@"r%d", i];
+            [scheduler scheduleRequest:^(NSUInteger attempt, BOOL lastAttempt, ChatSDKRequestDone done) {
+                [ran addObject:name];
+                done(ChatSDKRequestSucceeded);
+            } withKey:name];
+        }
+        CHATSDK_CHECK(scheduler.queueDepth == 3, @"queueDepth %lu", (unsigned long)scheduler.queueDepth);
+        CHATSDK_CHECK(metric(scheduler, @"dropped") == 2, @"dropped %lu", (unsigned long)metric(scheduler, @"dropped"));
+
+        scheduler.reachable = YES;
+        CHATSDK_CHECK(waitUntil(2, ^BOOL(void) { return [ran count] == 3; }), @"ran %@", ran);
+        spin(0.1);
+        CHATSDK_CHECK([[ran sortedArrayUsingSelector:@selector(compare:)] isEqualToArray:(@[ @"r2", @"r3", @"r4" ])], @"ran %@, expected the 3 newest", ran);
+    });
+
+    runTest(@"RequestScheduler/backoffBounds", ^{
+        ChatSDKRequestScheduler *scheduler = [[ChatSDKRequestScheduler alloc] init];
+        scheduler.initialBackoff = 0.1;
+        scheduler.maximumBackoff = 0.4;
+        scheduler.maximumAttempts = 5;
+        NSMutableArray *starts = [NSMutableArray array];
+        NSMutableArray *lastAttempts = [NSMutableArray array];
+        [scheduler scheduleRequest:^(NSUInteger attempt, BOOL lastAttempt, ChatSDKRequestDone done) {
+            [starts addObject:[NSDate date]];
+            [lastAttempts addObject:[NSNumber numberWithBool:lastAttempt]];
+            done(ChatSDKRequestRetry);
+        } withKey:@"retry"];
+        CHATSDK_CHECK(waitUntil(5, ^BOOL(void) { return metric(scheduler, @"failed") == 1; }), @"%lu attempts, the request did not give up", (unsigned long)[starts count]);
+        spin(0.5);
+
+        CHATSDK_CHECK([starts count] == 5, @"%lu attempts, maximumAttempts is 5", (unsigned long)[starts count]);
+        CHATSDK_CHECK([lastAttempts isEqualToArray:(@[ @NO, @NO, @NO, @NO, @YES ])], @"lastAttempt %@", lastAttempts);
+        CHATSDK_CHECK(metric(scheduler, @"retries") == 4, @"retries %lu", (unsigned long)metric(scheduler, @"retries"));
+        // initialBackoff doubled per attempt & capped, of which a random second half is waited
+        NSTimeInterval backoffs[] = { 0.1, 0.2, 0.4, 0.4 };
+        for (NSUInteger i = 1; i < MIN([starts count], (NSUInteger)5); i++) {
+            NSTimeInterval gap = [[starts objectAtIndex:i] timeIntervalSinceDate:[starts objectAtIndex:i - 1]];
+            CHATSDK_CHECK(gap >= backoffs[i - 1] / 2 * 0.9, @"attempt %lu after %.3fs, expected at least %.3fs", (unsigned long)i + 1, gap, backoffs[i - 1] / 2);
+            CHATSDK_CHECK(gap <= backoffs[i - 1] + 0.05, @"attempt %lu after %.3fs, expected at most %.3fs", (unsigned long)i + 1, gap, backoffs[i - 1]);
+        }
+    });
+
+    runTest(@"RequestScheduler/flushesWhenReachable", ^{
+        ChatSDKRequestScheduler *scheduler = [[ChatSDKRequestScheduler alloc] init];
+        scheduler.reachable = NO;
+        scheduler.flushSpread = 0.2;
+        NSMutableArray *starts = [NSMutableArray array];
+        for (int i = 0; i < 4; i++) {
+            [scheduler scheduleRequest:^(NSUInteger attempt, BOOL lastAttempt, ChatSDKRequestDone done) {
+                [starts addObject:[NSDate date]];
+                done(ChatSDKRequestSucceeded);
+            } withKey:[NSString stringWithFormat:@"flush%d", i]];
+        }
+        spin(0.2);
+        CHATSDK_CHECK([starts count] == 0, @"%lu requests ran while offline", (unsigned long)[starts count]);
+
+        NSDate *reachableDate = [NSDate date];
+        scheduler.reachable = YES;
+        CHATSDK_CHECK(waitUntil(2, ^BOOL(void) { return metric(scheduler, @"succeeded") == 4; }), @"%lu of 4 requests ran", (unsigned long)[starts count]);
+        CHATSDK_CHECK(metric(scheduler, @"flushes") == 1, @"flushes %lu", (unsigned long)metric(scheduler, @"flushes"));
+        CHATSDK_CHECK(scheduler.queueDepth == 0, @"queueDepth %lu", (unsigned long)scheduler.queueDepth);
+        for (NSDate *start in starts) {
+            CHATSDK_CHECK([start timeIntervalSinceDate:reachableDate] <= scheduler.flushSpread + 0.05, @"request ran %.3fs after the network came back", [start timeIntervalSinceDate:reachableDate]);
+        }
+    });
+}
+
+#pragma mark Transcript store
+
+static NSString *transcriptPath(NSString *name)
+{
+    return [NSTemporaryDirectory() stringByAppendingPathComponent:[NSString stringWithFormat:@"chatsdk-test-%d-%@.sqlite", (int)getpid(), name]];
+}
+
+static void removeTranscriptFiles(NSString *path)
+{
+    [[NSFileManager defaultManager] removeItemAtPath:path error:NULL];
+    [[NSFileManager defaultManager] removeItemAtPath:[path stringByAppendingString:@"-wal"] error:NULL];
+    [[NSFileManager defaultManager] removeItemAtPath:[path stringByAppendingString:@"-shm"] error:NULL];
+}
+
+// What is left in the file, read by a second store that trims nothing & does not hide old entries
+static NSArray *storedEntries(NSString *path, NSString *transcript)
+{
+    ChatSDKTranscriptStore *reader = [[ChatSDKTranscriptStore alloc] initWithPath:path];
+    reader.maximumAge = 0;
+    reader.maximumSize = 0;
+    return [reader entriesOfTranscript:transcript afterSequence:0 limit:0];
+}
+
+// Bytes the store counts for the data of an entry
+static unsigned long long entryBytes(NSDictionary *entry)
+{
+    return [[NSJSONSerialization dataWithJSONObject:[NSArray arrayWithObject:[entry objectForKey:@"data"]] options:0 error:NULL] length];
+}
+
+static void testTranscriptStore(void)
+{
+    runTest(@"TranscriptStore/trimsByAge", ^{
+        NSString *path = transcriptPath(@"age");
+        removeTranscriptFiles(path);
+        ChatSDKTranscriptStore *store = [[ChatSDKTranscriptStore alloc] initWithPath:path];
+        store.maximumAge = 0.3;
+        store.maximumSize = 0;
+        for (int i = 0; i < 3; i++) {
+            [store appendEntryOfType:@"old" data:[NSNumber numberWithInt:i] toTranscript:@"queue-1"];
+        }
+        [store entriesOfTranscript:@"queue-1" afterSequence:0 limit:0];
+        usleep(400000);
+        // Enough appends for the next check of maximumAge
+        for (int i = 0; i < 40; i++) {
+            [store appendEntryOfType:@"new" data:[NSNumber numberWithInt:i] toTranscript:@"queue-1"];
+        }
+        NSArray *visible = [store entriesOfTranscript:@"queue-1" afterSequence:0 limit:0];
+
+        NSArray *stored = storedEntries(path, @"queue-1");
+        CHATSDK_CHECK([visible count] == 40, @"%lu entries visible, expected the 40 new ones", (unsigned long)[visible count]);
+        CHATSDK_CHECK([stored count] == 40, @"%lu entries in the file, expected the old ones deleted", (unsigned long)[stored count]);
+        for (NSDictionary *entry in stored) {
+            CHATSDK_CHECK([[entry objectForKey:@"type"] isEqualToString:@"new"], @"entry %@ older than maximumAge kept", entry);
+        }
+        store = nil;
+        removeTranscriptFiles(path);
+    });
+
+    runTest(@"TranscriptStore/trimsBySize", ^{
+        NSString *path = transcriptPath(@"size");
+        removeTranscriptFiles(path);
+        ChatSDKTranscriptStore *store = [[ChatSDKTranscriptStore alloc] initWithPath:path];
+        store.maximumAge = 0;
+        store.maximumSize = 4096;
+        NSString *text = [@"" stringByPaddingToLength:90 withString:@"agent message " startingAtIndex:0];
+        for (int i = 0; i < 200; i++) {
+            [store appendEntryOfType:@"agentmessage" data:@{ @"index" : [NSNumber numberWithInt:i], @"text" : text } toTranscript:(i % 2 ? @"queue-1" : @"queue-2")];
+        }
+        [store entriesOfTranscript:@"queue-1" afterSequence:0 limit:0];
+
+        NSArray *stored = [storedEntries(path, @"queue-1") arrayByAddingObjectsFromArray:storedEntries(path, @"queue-2")];
+        unsigned long long bytes = 0;
+        int oldestIndex = 200;
+        for (NSDictionary *entry in stored) {
+            bytes += entryBytes(entry);
+            oldestIndex = MIN(oldestIndex, [[[entry objectForKey:@"data"] objectForKey:@"index"] intValue]);
+        }
+        CHATSDK_CHECK(bytes <= 4096, @"%llu bytes kept, maximumSize is 4096", bytes);
+        CHATSDK_CHECK(bytes >= 4096 / 2, @"%llu bytes kept, trimmed far below maximumSize", bytes);
+        // The newest entries are the ones kept
+        CHATSDK_CHECK([stored count] == (NSUInteger)(200 - oldestIndex), @"%lu entries kept, the oldest is %d, expected no gap", (unsigned long)[stored count], oldestIndex);
+
+        // What was deleted no longer counts, removing a transcript makes room without trimming the other
+        [store removeTranscript:@"queue-2"];
+        NSUInteger kept = [storedEntries(path, @"queue-1") count];
+        for (int i = 200; i < 210; i++) {
+            [store appendEntryOfType:@"agentmessage" data:@{ @"index" : [NSNumber numberWithInt:i], @"text" : text } toTranscript:@"queue-1"];
+        }
+        [store entriesOfTranscript:@"queue-1" afterSequence:0 limit:0];
+        CHATSDK_CHECK([storedEntries(path, @"queue-1") count] == kept + 10, @"queue-1 trimmed although queue-2 was removed");
+        store = nil;
+        removeTranscriptFiles(path);
+    });
+}
+
+#pragma mark main
+
+int main(int argc, const char *argv[])
+{
+    @autoreleasepool {
+        for (int i = 1; i < argc; i++) {
+            if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+                nameFilter = [NSString stringWithUTF8String:argv[++i]];
+            } else if (strcmp(argv[i], "-v") == 0) {
+                verbose = YES;
+            } else {
+                fprintf(stderr, "usage: %s [-f <name filter>] [-v]\n", argv[0]);
+                return 1;
+            }
+        }
+
+        testAvailabilitySubscriber();
+        testRequestScheduler();
+        testTranscriptStore();
+
+        printf("%lu tests, %lu failed\n", (unsigned long)testsRun, (unsigned long)testsFailed);
+    }
+    return testsFailed == 0 ? 0 : 1;
+}